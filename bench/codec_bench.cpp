@@ -0,0 +1,47 @@
+#include "payloads.hpp"
+#include "deribit/order.hpp"
+#include "deribit/position.hpp"
+#include <benchmark/benchmark.h>
+
+namespace deribit {
+namespace bench {
+namespace {
+
+void BM_OrderDecode(benchmark::State& state) {
+    auto json = nlohmann::json::parse(kOrder);
+    for (auto _ : state) {
+        Order order(json);
+        benchmark::DoNotOptimize(order);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderDecode);
+
+void BM_PositionDecode(benchmark::State& state) {
+    auto json = nlohmann::json::parse(kPosition);
+    for (auto _ : state) {
+        Position position(json);
+        benchmark::DoNotOptimize(position);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PositionDecode);
+
+// The private/buy request as placeBuyOrder encodes it; the access token is typical length
+void BM_EncodeBuyRequest(benchmark::State& state) {
+    std::string type = state.range(0) != 0 ? "limit" : "market";
+    std::string token = "1718035198123.1PKkPjd2.Hh1nB3gzWv6rXq0mJxVtC9yRkL2sUaE7oFpDiQ4wZbN";
+    uint64_t request_id = 100000;
+    for (auto _ : state) {
+        std::string payload = encodeOrderRequest(
+            "private/buy", request_id++, "BTC-PERPETUAL", 250.0, type, 64180.5,
+            "c1718035198-000042", token);
+        benchmark::DoNotOptimize(payload);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeBuyRequest)->ArgName("limit")->Arg(0)->Arg(1);
+
+} // namespace
+} // namespace bench
+} // namespace deribit
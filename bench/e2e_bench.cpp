@@ -0,0 +1,106 @@
+#include "deribit/api_client.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+namespace deribit {
+namespace bench {
+namespace {
+
+constexpr const char* kInstrument = "BTC-PERPETUAL";
+constexpr uint64_t kUpdatesPerIteration = 1000;
+constexpr std::chrono::seconds kAckTimeout(5);
+
+// A client connected to a local deribit_mock, shared by every iteration
+struct MockSession {
+    Config config{"bench", "bench", true};
+    std::unique_ptr<ApiClient> client;
+    std::atomic<uint64_t> book_updates{0};
+    std::string error;
+};
+
+MockSession& mockSession() {
+    // Connected once and never torn down, like the client's other singletons
+    static MockSession* session = []() {
+        auto* s = new MockSession();
+        const char* ws_url = std::getenv("DERIBIT_MOCK_WS_URL");
+        const char* rest_url = std::getenv("DERIBIT_MOCK_REST_URL");
+        if (!ws_url || !rest_url) {
+            s->error = "set DERIBIT_MOCK_WS_URL and DERIBIT_MOCK_REST_URL to a running deribit_mock";
+            return s;
+        }
+        s->config.setWebSocketApiUrl(ws_url);
+        s->config.setRestApiUrl(rest_url);
+        s->client = std::make_unique<ApiClient>(s->config);
+        if (!s->client->initialize() || !s->client->authenticate()) {
+            s->error = "could not connect to the mock exchange";
+            return s;
+        }
+        if (!s->client->subscribeOrderbook(kInstrument, [s](const Orderbook&) {
+                s->book_updates.fetch_add(1, std::memory_order_relaxed);
+            })) {
+            s->error = "could not subscribe to the mock order book";
+        }
+        return s;
+    }();
+    return *session;
+}
+
+// Wire to orderbook callback through TLS, dispatch and book maintenance, at the mock's book rate
+void BM_EndToEndBookThroughput(benchmark::State& state) {
+    MockSession& session = mockSession();
+    if (!session.error.empty()) {
+        state.SkipWithError(session.error.c_str());
+        return;
+    }
+
+    for (auto _ : state) {
+        uint64_t target = session.book_updates.load(std::memory_order_relaxed) + kUpdatesPerIteration;
+        while (session.book_updates.load(std::memory_order_relaxed) < target) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kUpdatesPerIteration));
+
+    // Cumulative over the session; the mock's rate must exceed the client's for a saturation figure
+    LatencySnapshot entry = session.client->getLatency(LatencyStage::CallbackEntry);
+    state.counters["callback_entry_p50_us"] = static_cast<double>(entry.percentile(50.0)) / 1000.0;
+    state.counters["callback_entry_p99_us"] = static_cast<double>(entry.percentile(99.0)) / 1000.0;
+}
+BENCHMARK(BM_EndToEndBookThroughput)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Kill switch trigger to cancel_all ack: halt, pre-encoded send, mock round trip and response dispatch
+void BM_EndToEndKillSwitch(benchmark::State& state) {
+    MockSession& session = mockSession();
+    if (!session.error.empty()) {
+        state.SkipWithError(session.error.c_str());
+        return;
+    }
+
+    for (auto _ : state) {
+        uint64_t acked = session.client->getKillSwitchStats().acks;
+        auto start = std::chrono::steady_clock::now();
+        session.client->killSwitch();
+        while (session.client->getKillSwitchStats().acks == acked) {
+            if (std::chrono::steady_clock::now() - start > kAckTimeout) {
+                session.client->resetKillSwitch();
+                state.SkipWithError("no cancel_all ack from the mock exchange");
+                return;
+            }
+        }
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        session.client->resetKillSwitch();
+    }
+
+    // Send-to-ack as timed by the kill switch itself, without the halt and the caller's polling
+    KillSwitchStats stats = session.client->getKillSwitchStats();
+    state.counters["send_to_ack_max_us"] = static_cast<double>(stats.max_latency_ns) / 1000.0;
+}
+BENCHMARK(BM_EndToEndKillSwitch)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace bench
+} // namespace deribit
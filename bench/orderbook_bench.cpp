@@ -0,0 +1,60 @@
+#include "payloads.hpp"
+#include "deribit/orderbook.hpp"
+#include <benchmark/benchmark.h>
+
+namespace deribit {
+namespace bench {
+namespace {
+
+// Levels per side; Deribit book.* subscriptions go up to full depth on illiquid books
+void depthArgs(benchmark::internal::Benchmark* b) {
+    b->Arg(10)->Arg(100)->Arg(1000);
+}
+
+void BM_OrderbookFromJson(benchmark::State& state) {
+    auto json = nlohmann::json::parse(bookSnapshot(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        Orderbook book(json);
+        benchmark::DoNotOptimize(book);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderbookFromJson)->Apply(depthArgs);
+
+void BM_OrderbookParseAndBuild(benchmark::State& state) {
+    std::string payload = bookSnapshot(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        Orderbook book(nlohmann::json::parse(payload));
+        benchmark::DoNotOptimize(book);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(payload.size()));
+}
+BENCHMARK(BM_OrderbookParseAndBuild)->Apply(depthArgs);
+
+void BM_OrderbookUpdate(benchmark::State& state) {
+    int depth = static_cast<int>(state.range(0));
+    Orderbook book(nlohmann::json::parse(bookSnapshot(depth)));
+    auto forward = nlohmann::json::parse(bookChange(depth, false));
+    auto back = nlohmann::json::parse(bookChange(depth, true));
+    for (auto _ : state) {
+        book.update(forward);
+        book.update(back);
+        benchmark::DoNotOptimize(book);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_OrderbookUpdate)->Apply(depthArgs);
+
+void BM_OrderbookToJson(benchmark::State& state) {
+    Orderbook book(nlohmann::json::parse(bookSnapshot(static_cast<int>(state.range(0)))));
+    for (auto _ : state) {
+        auto json = book.toJson();
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderbookToJson)->Apply(depthArgs);
+
+} // namespace
+} // namespace bench
+} // namespace deribit
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <string>
+#include <cstdio>
+
+namespace deribit {
+namespace bench {
+
+// Payloads follow the shapes Deribit sends on the wire; books are generated
+// at the requested depth around a BTC-PERPETUAL-like mid.
+
+constexpr double kMid = 64250.0;
+constexpr double kTick = 0.5;
+
+/**
+ * @brief Build the data of a book.* snapshot notification
+ * @param depth Levels per side
+ * @return The JSON text
+ */
+inline std::string bookSnapshot(int depth) {
+    std::string out = "{\"type\":\"snapshot\",\"timestamp\":1718035200123,"
+                      "\"instrument_name\":\"BTC-PERPETUAL\",\"change_id\":69283910001,\"bids\":[";
+    char level[64];
+    for (int i = 0; i < depth; ++i) {
+        std::snprintf(level, sizeof(level), "%s[\"new\",%.1f,%d.0]",
+                      i > 0 ? "," : "", kMid - kTick * (i + 1), 10 * (i % 37 + 1));
+        out += level;
+    }
+    out += "],\"asks\":[";
+    for (int i = 0; i < depth; ++i) {
+        std::snprintf(level, sizeof(level), "%s[\"new\",%.1f,%d.0]",
+                      i > 0 ? "," : "", kMid + kTick * (i + 1), 10 * (i % 29 + 1));
+        out += level;
+    }
+    out += "]}";
+    return out;
+}
+
+/**
+ * @brief Build the data of a typical book.* change notification
+ *
+ * Two resizes and an insert/delete near the top of a book of the given
+ * depth. Applying it with alternate=false then true returns the book to its
+ * original levels, so benchmarks can loop without the book drifting.
+ *
+ * @param depth Levels per side of the book it applies to
+ * @param alternate Which half of the round trip to build
+ * @return The JSON text
+ */
+inline std::string bookChange(int depth, bool alternate) {
+    int deep = depth > 3 ? depth / 2 : 1;
+    char out[512];
+    std::snprintf(out, sizeof(out),
+        "{\"type\":\"change\",\"timestamp\":1718035200223,\"prev_change_id\":69283910001,"
+        "\"instrument_name\":\"BTC-PERPETUAL\",\"change_id\":69283910002,"
+        "\"bids\":[[\"change\",%.1f,%s],[\"change\",%.1f,%s]],"
+        "\"asks\":[[\"%s\",%.1f,%s]]}",
+        kMid - kTick, alternate ? "10.0" : "2530.0",
+        kMid - kTick * deep, alternate ? "120.0" : "40.0",
+        alternate ? "delete" : "new", kMid + kTick * (depth + 1), alternate ? "0.0" : "750.0");
+    return out;
+}
+
+/**
+ * @brief A book.* change as the complete WebSocket frame
+ * @return The JSON text
+ */
+inline std::string bookChangeFrame() {
+    return "{\"jsonrpc\":\"2.0\",\"method\":\"subscription\",\"params\":{"
+           "\"channel\":\"book.BTC-PERPETUAL.100ms\",\"data\":" + bookChange(20, false) + "}}";
+}
+
+/**
+ * @brief An order as carried by user.orders and private/buy results
+ */
+constexpr const char* kOrder = R"({
+    "web": false,
+    "time_in_force": "good_til_cancelled",
+    "replaced": false,
+    "reduce_only": false,
+    "price": 64180.5,
+    "post_only": false,
+    "order_type": "limit",
+    "order_state": "open",
+    "order_id": "USDC-29847221013",
+    "max_show": 250.0,
+    "last_update_timestamp": 1718035200317,
+    "label": "c1718035198-000042",
+    "is_liquidation": false,
+    "instrument_name": "BTC-PERPETUAL",
+    "filled_amount": 0.0,
+    "direction": "buy",
+    "creation_timestamp": 1718035200317,
+    "average_price": 0.0,
+    "api": true,
+    "amount": 250.0
+})";
+
+/**
+ * @brief A position as returned by private/get_positions and user.changes
+ */
+constexpr const char* kPosition = R"({
+    "total_profit_loss": 0.000321587,
+    "size_currency": 0.0155626,
+    "size": 1000.0,
+    "settlement_price": 64012.37,
+    "realized_profit_loss": -0.000001942,
+    "realized_funding": -0.000001942,
+    "open_orders_margin": 0.0,
+    "mark_price": 64255.71,
+    "maintenance_margin": 0.000155631,
+    "leverage": 50,
+    "kind": "future",
+    "interest_value": 0.9874410339,
+    "instrument_name": "BTC-PERPETUAL",
+    "initial_margin": 0.000311261,
+    "index_price": 64231.04,
+    "floating_profit_loss": 0.000077402,
+    "estimated_liquidation_price": 2045.08,
+    "direction": "buy",
+    "delta": 0.0155626,
+    "average_price": 63761.29
+})";
+
+/**
+ * @brief The response to a private/buy sent over the WebSocket
+ */
+constexpr const char* kBuyResponseFrame =
+    R"({"jsonrpc":"2.0","id":100042,"result":{"trades":[],"order":{"web":false,"time_in_force":"good_til_cancelled",)"
+    R"("replaced":false,"reduce_only":false,"price":64180.5,"post_only":false,"order_type":"limit",)"
+    R"("order_state":"open","order_id":"USDC-29847221013","max_show":250.0,"last_update_timestamp":1718035200317,)"
+    R"("label":"c1718035198-000042","is_liquidation":false,"instrument_name":"BTC-PERPETUAL","filled_amount":0.0,)"
+    R"("direction":"buy","creation_timestamp":1718035200317,"average_price":0.0,"api":true,"amount":250.0}},)"
+    R"("usIn":1718035200317012,"usOut":1718035200317498,"usDiff":486,"testnet":true})";
+
+/**
+ * @brief A ticker.* notification frame
+ */
+constexpr const char* kTickerFrame =
+    R"({"jsonrpc":"2.0","method":"subscription","params":{"channel":"ticker.BTC-PERPETUAL.100ms","data":{)"
+    R"("timestamp":1718035200401,"stats":{"volume_usd":712455830.0,"volume":11093.4,"price_change":1.2,)"
+    R"("low":63120.0,"high":64580.5},"state":"open","settlement_price":64012.37,"open_interest":1015324460,)"
+    R"("min_price":63286.5,"max_price":65214.5,"mark_price":64255.71,"last_price":64250.5,)"
+    R"("instrument_name":"BTC-PERPETUAL","index_price":64231.04,"funding_8h":0.00001843,)"
+    R"("estimated_delivery_price":64231.04,"current_funding":0.0,"best_bid_price":64250.0,)"
+    R"("best_bid_amount":14590.0,"best_ask_price":64250.5,"best_ask_amount":6120.0}}})";
+
+} // namespace bench
+} // namespace deribit
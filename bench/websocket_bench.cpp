@@ -0,0 +1,42 @@
+#include "payloads.hpp"
+#include "deribit/websocket_client.hpp"
+#include <benchmark/benchmark.h>
+
+namespace deribit {
+namespace bench {
+namespace {
+
+// Frame receipt to message callback: parse, id and method checks, forward
+void runDispatch(benchmark::State& state, const std::string& frame) {
+    Config config;
+    WebSocketClient client(config);
+    size_t delivered = 0;
+    client.setMessageCallback([&delivered](const std::string& message) {
+        delivered += message.size();
+    });
+
+    for (auto _ : state) {
+        client.handleFrame(frame);
+    }
+    benchmark::DoNotOptimize(delivered);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.size()));
+}
+
+void BM_DispatchBookChange(benchmark::State& state) {
+    runDispatch(state, bookChangeFrame());
+}
+BENCHMARK(BM_DispatchBookChange);
+
+void BM_DispatchTicker(benchmark::State& state) {
+    runDispatch(state, kTickerFrame);
+}
+BENCHMARK(BM_DispatchTicker);
+
+void BM_DispatchOrderResponse(benchmark::State& state) {
+    runDispatch(state, kBuyResponseFrame);
+}
+BENCHMARK(BM_DispatchOrderResponse);
+
+} // namespace
+} // namespace bench
+} // namespace deribit
@@ -9,14 +9,37 @@
 #include <condition_variable>
 #include <thread>
 #include <atomic>
+#include <future>
+#include <vector>
+#include <array>
 #include <nlohmann/json.hpp>
 
 #include "deribit/websocket_client.hpp"
 #include "deribit/rest_client.hpp"
+#include "deribit/async_rest_client.hpp"
 #include "deribit/orderbook.hpp"
 #include "deribit/position.hpp"
 #include "deribit/order.hpp"
 #include "deribit/config.hpp"
+#include "deribit/rate_limiter.hpp"
+#include "deribit/instrument_store.hpp"
+#include "deribit/order_store.hpp"
+#include "deribit/position_store.hpp"
+#include "deribit/risk_engine.hpp"
+#include "deribit/quote_engine.hpp"
+#include "deribit/kill_switch.hpp"
+#include "deribit/time_sync.hpp"
+#include "deribit/client_order_tracker.hpp"
+#include "deribit/trade_ring.hpp"
+#include "deribit/seqlock.hpp"
+#include "deribit/top_of_book.hpp"
+#include "deribit/candle_engine.hpp"
+#include "deribit/options_engine.hpp"
+#include "deribit/portfolio_engine.hpp"
+#include "deribit/latency_histogram.hpp"
+#include "deribit/order_latency.hpp"
+#include "deribit/metrics.hpp"
+#include "deribit/metrics_server.hpp"
 
 namespace deribit {
 
@@ -50,25 +73,43 @@ public:
 
     /**
      * @brief Place a buy order
+     *
+     * The order is sent with the label "<label>/<client order id>" so acks and
+     * fills can be matched; one is generated when no client order id is given.
+     * Calling again with the same client order id does not send a second order
+     * unless the first was rejected or is confirmed absent on the exchange;
+     * such a call returns false.
+     *
      * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
      * @param amount The amount to buy
      * @param type The order type (e.g., "market", "limit")
      * @param price The price for limit orders
-     * @param label Optional label for the order
-     * @return true if order placement was successful, false otherwise
+     * @param label Optional free-form label
+     * @param client_order_id Optional idempotency key (see newClientOrderId()); must not contain '/'
+     * @param reduce_only Whether the order may only reduce the position; such orders are rate limited ahead of new risk
+     * @return true if the order was sent and not refused, false otherwise
      */
-    bool placeBuyOrder(const std::string& instrument_name, double amount, const std::string& type, double price, const std::string& label = "");
+    bool placeBuyOrder(const std::string& instrument_name, double amount, const std::string& type, double price,
+                       const std::string& label = "", const std::string& client_order_id = "",
+                       bool reduce_only = false);
 
     /**
      * @brief Place a sell order
+     *
+     * Client order ids and retries behave as for placeBuyOrder().
+     *
      * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
      * @param amount The amount to sell
      * @param type The order type (e.g., "market", "limit")
      * @param price The price for limit orders
-     * @param label Optional label for the order
-     * @return true if order placement was successful, false otherwise
+     * @param label Optional free-form label
+     * @param client_order_id Optional idempotency key (see newClientOrderId()); must not contain '/'
+     * @param reduce_only Whether the order may only reduce the position; such orders are rate limited ahead of new risk
+     * @return true if the order was placed, false otherwise
      */
-    bool placeSellOrder(const std::string& instrument_name, double amount, const std::string& type, double price, const std::string& label = "");
+    bool placeSellOrder(const std::string& instrument_name, double amount, const std::string& type, double price,
+                        const std::string& label = "", const std::string& client_order_id = "",
+                        bool reduce_only = false);
 
     /**
      * @brief Cancel an order
@@ -79,6 +120,10 @@ public:
 
     /**
      * @brief Modify an existing order
+     *
+     * The order must be known to the order store; the edit passes the same
+     * validation and pre-trade risk checks as a new order.
+     *
      * @param order_id The ID of the order to modify
      * @param amount The new amount
      * @param price The new price
@@ -91,6 +136,10 @@ public:
 
     /**
      * @brief Get the orderbook for an instrument
+     *
+     * Served from the live WebSocket book when the instrument is subscribed,
+     * otherwise from the (cached) REST endpoint.
+     *
      * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
      * @param depth The depth of the orderbook
      * @return The orderbook
@@ -101,6 +150,10 @@ public:
 
     /**
      * @brief Get current positions
+     *
+     * Answered from the local position store once it is live (subscribed to
+     * user.changes and reconciled), otherwise via REST.
+     *
      * @param currency The currency (e.g., "BTC")
      * @param kind The kind of instrument (e.g., "future", "option")
      * @return A vector of positions
@@ -111,12 +164,46 @@ public:
 
     /**
      * @brief Get open orders
+     *
+     * Answered from the local order store once it is live (subscribed to
+     * user.orders and reconciled), otherwise via REST.
+     *
      * @param instrument_name Optional instrument name to filter by
      * @return A vector of open orders
      */
     std::vector<Order> getOpenOrders(
         const std::string& instrument_name = "");
 
+    /**
+     * @brief Get the orderbooks for several instruments concurrently
+     * @param instrument_names The instrument names
+     * @param depth The depth of each orderbook
+     * @return The orderbooks, in the same order as the instrument names
+     */
+    std::vector<Orderbook> getOrderbooksBulk(
+        const std::vector<std::string>& instrument_names,
+        int depth = 10);
+
+    /**
+     * @brief Get current positions for several currencies concurrently
+     * @param currencies The currencies (e.g., {"BTC", "ETH"})
+     * @param kind The kind of instrument (e.g., "future", "option")
+     * @return The positions across all currencies
+     */
+    std::vector<Position> getPositionsBulk(
+        const std::vector<std::string>& currencies,
+        const std::string& kind = "");
+
+    /**
+     * @brief Send a JSON-RPC request without blocking the caller
+     * @param method The JSON-RPC method (e.g., "public/get_index_price")
+     * @param params The method parameters
+     * @return A future holding the response as JSON
+     */
+    std::future<nlohmann::json> callAsync(
+        const std::string& method,
+        const nlohmann::json& params = nlohmann::json::object());
+
     /**
      * @brief Subscribe to orderbook updates for an instrument
      * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
@@ -134,20 +221,479 @@ public:
      */
     bool unsubscribeOrderbook(const std::string& instrument_name);
 
+    /**
+     * @brief Subscribe to public trades for an instrument
+     *
+     * Trades are appended to the instrument's ring buffer, see getTradeRing().
+     *
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @param interval The channel interval ("100ms", or "raw" when authorized)
+     * @return true if subscription was successful, false otherwise
+     */
+    bool subscribeTrades(const std::string& instrument_name, const std::string& interval = "100ms");
+
+    /**
+     * @brief Unsubscribe from public trades for an instrument; its history is kept
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @param interval The channel interval used to subscribe
+     * @return true if unsubscription was successful, false otherwise
+     */
+    bool unsubscribeTrades(const std::string& instrument_name, const std::string& interval = "100ms");
+
+    /**
+     * @brief Get the trade history of an instrument
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return The ring buffer, or nullptr if never subscribed
+     */
+    std::shared_ptr<const TradeRing> getTradeRing(const std::string& instrument_name) const;
+
+    /**
+     * @brief Subscribe to best bid/ask updates (quote.* channel) for an instrument
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return true if subscription was successful, false otherwise
+     */
+    bool subscribeQuote(const std::string& instrument_name);
+
+    /**
+     * @brief Unsubscribe from best bid/ask updates for an instrument
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return true if unsubscription was successful, false otherwise
+     */
+    bool unsubscribeQuote(const std::string& instrument_name);
+
+    /**
+     * @brief Subscribe to ticker updates (ticker.* channel) for an instrument
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @param interval The channel interval ("100ms", or "raw" when authorized)
+     * @return true if subscription was successful, false otherwise
+     */
+    bool subscribeTicker(const std::string& instrument_name, const std::string& interval = "100ms");
+
+    /**
+     * @brief Unsubscribe from ticker updates for an instrument
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @param interval The channel interval used to subscribe
+     * @return true if unsubscription was successful, false otherwise
+     */
+    bool unsubscribeTicker(const std::string& instrument_name, const std::string& interval = "100ms");
+
+    /**
+     * @brief Get the top-of-book slot of an instrument for lock-free polling
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return The slot, or nullptr if neither quote nor ticker was subscribed
+     */
+    std::shared_ptr<const SeqLock<TopOfBook>> getTopOfBookSlot(const std::string& instrument_name) const;
+
+    /**
+     * @brief Get the latest top of book of an instrument
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @param top The latest snapshot, if subscribed
+     * @return true if subscribed, false otherwise
+     */
+    bool getTopOfBook(const std::string& instrument_name, TopOfBook& top) const;
+
+    /**
+     * @brief Build OHLCV candles for an instrument at every configured interval
+     *
+     * Candles are fed by an existing subscription: subscribeTrades() for
+     * CandleSource::Trades, or subscribeOrderbook()/subscribeQuote()/
+     * subscribeTicker() for CandleSource::Mid.
+     *
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @param source The price feed to build from
+     */
+    void trackCandles(const std::string& instrument_name, CandleSource source = CandleSource::Trades);
+
+    /**
+     * @brief Stop building candles for an instrument and drop its history
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     */
+    void untrackCandles(const std::string& instrument_name);
+
+    /**
+     * @brief Set the callback invoked on the WebSocket thread whenever a candle closes
+     * @param callback The callback receiving instrument, interval and the closed candle
+     */
+    void setCandleCallback(CandleEngine::BarCallback callback);
+
+    /**
+     * @brief Get the closed candles of an instrument, oldest first
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @param interval The candle interval
+     * @return The closed candles
+     */
+    std::vector<Candle> getCandles(const std::string& instrument_name, std::chrono::milliseconds interval) const;
+
+    /**
+     * @brief Start pricing a currency's options chain
+     *
+     * Loads every active option of the currency into the options engine and
+     * subscribes to its price index and option mark prices. Ticker, quote and
+     * book subscriptions on individual options feed their mids as well.
+     *
+     * @param currency The currency (e.g., "BTC")
+     * @return true if the subscriptions were sent, false otherwise
+     */
+    bool trackOptionChain(const std::string& currency);
+
+    /**
+     * @brief Get the latest implied vol and greeks of an option
+     * @param instrument_name The option name (e.g., "BTC-27DEC24-60000-C")
+     * @param greeks The greeks, if priced
+     * @return true if the option has been priced, false otherwise
+     */
+    bool getOptionGreeks(const std::string& instrument_name, OptionGreeks& greeks) const;
+
+    /**
+     * @brief Get the options engine counters, including repricing throughput
+     * @return The current counters
+     */
+    OptionsEngineStats getOptionsEngineStats() const;
+
+    /**
+     * @brief Get the live position in an instrument without touching the network
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return The position, or nullptr if flat or unknown
+     */
+    PositionStore::PositionPtr getPosition(const std::string& instrument_name) const;
+
+    /**
+     * @brief Get the latest portfolio summary pushed on user.portfolio
+     * @param currency The currency (e.g., "BTC")
+     * @return The portfolio, or nullptr if none received yet
+     */
+    PositionStore::PortfolioPtr getPortfolio(const std::string& currency) const;
+
+    /**
+     * @brief Get the live PnL, delta and margin of a position without waiting on portfolio updates
+     *
+     * Revalued locally on every mark update rather than waiting for the
+     * exchange's next position snapshot.
+     *
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @param risk The valuation, if held
+     * @return true if a position in the instrument is held, false otherwise
+     */
+    bool getPositionRisk(const std::string& instrument_name, PositionRisk& risk) const;
+
+    /**
+     * @brief Get the live PnL, delta and margin totals of a currency without waiting on portfolio updates
+     * @param currency The settlement currency (e.g., "BTC")
+     * @param totals The totals, if any position was held in it
+     * @return true if found, false otherwise
+     */
+    bool getPortfolioTotals(const std::string& currency, PortfolioTotals& totals) const;
+
+    /**
+     * @brief Get a currency's totals together with the position rows they were summed from
+     *
+     * Copies the rows under the portfolio lock when they changed since the last call.
+     *
+     * @param currency The settlement currency (e.g., "BTC")
+     * @return The snapshot, or nullptr if no position was ever held in it
+     */
+    std::shared_ptr<const PortfolioSnapshot> getPortfolioSnapshot(const std::string& currency) const;
+
+    /**
+     * @brief Reconcile the local position store against REST snapshots
+     * @return true if every currency was reconciled, false otherwise
+     */
+    bool reconcilePositions();
+
+    /**
+     * @brief Generate a unique client order id to pass to placeBuyOrder() or placeSellOrder()
+     * @return The client order id
+     */
+    std::string newClientOrderId();
+
+    /**
+     * @brief Look up an order by the client order id it was sent with
+     * @param client_order_id The client order id
+     * @param order The tracked order, if found
+     * @return true if found, false otherwise
+     */
+    bool findClientOrder(const std::string& client_order_id, ClientOrder& order) const;
+
+    /**
+     * @brief Find an order in the local order store
+     * @param order_id The exchange order id
+     * @param order Receives the order if found
+     * @return true if found, false otherwise
+     */
+    bool findOrder(const std::string& order_id, Order& order) const;
+
+    /**
+     * @brief Reconcile the local order store against REST snapshots
+     * @return true if every currency was reconciled, false otherwise
+     */
+    bool reconcileOrders();
+
+    /**
+     * @brief Get the reference data for an instrument
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return The instrument, or nullptr if unknown
+     */
+    InstrumentStore::InstrumentPtr getInstrument(const std::string& instrument_name) const;
+
+    /**
+     * @brief Reload instruments for the configured currencies from the API
+     * @return true if every currency was refreshed, false otherwise
+     */
+    bool refreshInstruments();
+
     /**
      * @brief Check if the client is connected
      * @return true if connected, false otherwise
      */
     bool isConnected() const;
 
+    /**
+     * @brief Get the client-side rate limiter metrics for a request class
+     * @param request_class The rate limit class
+     * @return The current metrics
+     */
+    RateLimiterStats getRateLimiterStats(RequestClass request_class) const;
+
+    /**
+     * @brief Get the REST response cache counters
+     * @return The hit/miss counters
+     */
+    ResponseCacheStats getResponseCacheStats() const;
+
+    /**
+     * @brief Replace the pre-trade risk limits
+     * @param limits The new risk limits
+     */
+    void setRiskLimits(const RiskLimits& limits);
+
+    /**
+     * @brief Get the pre-trade risk check counters
+     * @return The current counters
+     */
+    RiskStats getRiskStats() const;
+
+    /**
+     * @brief Set the desired two-sided quote for an instrument
+     *
+     * Only the edits needed to reach the quote are sent, pipelined over the
+     * WebSocket; the call does not wait for acks.
+     *
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @param quote The desired quote
+     */
+    void setQuote(const std::string& instrument_name, const Quote& quote);
+
+    /**
+     * @brief Pull both sides of an instrument's quote
+     * @param instrument_name The instrument name
+     */
+    void cancelQuotes(const std::string& instrument_name);
+
+    /**
+     * @brief Get the quoting engine counters
+     * @return The current counters
+     */
+    QuoteEngineStats getQuoteEngineStats() const;
+
+    /**
+     * @brief Halt trading and cancel every open order over the WebSocket
+     *
+     * The pre-encoded cancel_all is sent immediately, bypassing the rate
+     * limiter. New orders and quotes are rejected until resetKillSwitch().
+     *
+     * @param currency Optional currency to limit the cancel to; all if empty
+     * @return true if the cancel request was sent, false otherwise
+     */
+    bool killSwitch(const std::string& currency = "");
+
+    /**
+     * @brief Cancel every open order in one instrument over the fast path
+     *
+     * Unlike killSwitch() this does not halt trading.
+     *
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return true if the cancel request was sent, false otherwise
+     */
+    bool cancelAllByInstrument(const std::string& instrument_name);
+
+    /**
+     * @brief Resume trading after the kill switch
+     */
+    void resetKillSwitch();
+
+    /**
+     * @brief Check if the kill switch has halted trading
+     * @return true if halted, false otherwise
+     */
+    bool isKillSwitchEngaged() const { return risk_engine_.isHalted(); }
+
+    /**
+     * @brief Get the kill switch counters, including send-to-ack latency
+     * @return The current counters
+     */
+    KillSwitchStats getKillSwitchStats() const;
+
+    /**
+     * @brief Get the current time on the exchange clock
+     *
+     * The local wall clock corrected by the offset estimated from periodic
+     * public/get_time probes; uncorrected until the first probe is answered.
+     *
+     * @return Milliseconds since epoch, comparable with exchange timestamps
+     */
+    int64_t getExchangeTime() const;
+
+    /**
+     * @brief Get the exchange clock offset estimate and probe counters
+     * @return The current estimate and counters
+     */
+    TimeSyncStats getTimeSyncStats() const;
+
+    /**
+     * @brief Check if an instrument's book feed is lagging
+     *
+     * A book is stale while its last update reached us later than the
+     * configured stale feed threshold after the exchange stamped it, or while
+     * that stamp is older than the threshold in exchange time. Nothing is
+     * stale until the exchange clock offset is known.
+     *
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return true if stale, false if current, not subscribed or not yet synced
+     */
+    bool isBookStale(const std::string& instrument_name) const;
+
+    /**
+     * @brief Get the merged latency histogram of a market data stage
+     * @param stage The stage
+     * @return The snapshot across all recording threads
+     */
+    LatencySnapshot getLatency(LatencyStage stage) const;
+
+    /**
+     * @brief Log p50/p99/p99.9/max of every market data stage
+     */
+    void printLatencyReport() const;
+
+    /**
+     * @brief Get the merged round-trip latency histogram of an order path
+     *
+     * Buys go over WebSocket; sells, edits and cancels over REST.
+     *
+     * @param method The order method
+     * @param transport The transport
+     * @param metric Encode-to-write, send-to-ack or send-to-first-fill
+     * @return The snapshot across all recording threads
+     */
+    LatencySnapshot getOrderLatency(OrderMethod method, OrderTransport transport, OrderLatencyMetric metric) const;
+
+    /**
+     * @brief Log p50/p99/p99.9/max of every order path with samples; also done on destruction
+     */
+    void printOrderLatencyReport() const;
+
+    /**
+     * @brief Get the metrics registry served by the Prometheus endpoint
+     *
+     * Applications may register their own metrics here; they are exported
+     * alongside the client's.
+     *
+     * @return The registry
+     */
+    MetricsRegistry& getMetrics() { return metrics_; }
+
+    /**
+     * @brief Write the recent trace spans of every thread as Chrome trace JSON
+     *
+     * Spans are only recorded when built with DERIBIT_ENABLE_TRACING; the
+     * file loads in chrome://tracing or ui.perfetto.dev.
+     *
+     * @param path The output path (e.g., "trace.json")
+     * @return true if the file was written, false otherwise
+     */
+    bool dumpTrace(const std::string& path) const;
+
 private:
+    // Notification channel families counted by the metrics registry
+    enum class ChannelKind : uint8_t {
+        Book,
+        TopOfBook,
+        Trades,
+        Index,
+        OptionMarks,
+        UserOrders,
+        UserTrades,
+        UserChanges,
+        UserPortfolio,
+        Other,
+        Count
+    };
+
+    // How an order request ended, from the caller's point of view
+    enum class OrderOutcome : uint8_t {
+        Accepted,  // Exchange returned a result
+        Rejected,  // Exchange returned an error
+        Blocked,   // Stopped by validation or pre-trade risk before sending
+        Failed,    // Transport failure or no answer
+        Duplicate, // Client order id already sent; not sent again
+        Count
+    };
+
     Config config_;
+    
+    // Registered first so every component may hold metric references
+    MetricsRegistry metrics_;
+    std::unique_ptr<MetricsServer> metrics_server_;
+    std::array<Counter*, static_cast<size_t>(ChannelKind::Count)> channel_messages_{};
+    std::array<Counter*, static_cast<size_t>(OrderMethod::Count) * static_cast<size_t>(OrderOutcome::Count)>
+        order_outcomes_{};
+    std::array<Histogram*, 2> rate_limit_waits_{};  // Indexed by RequestClass
+    Counter* parse_errors_{nullptr};
+    Counter* stale_book_updates_{nullptr};
+    Counter* book_gaps_{nullptr};
+    
     std::unique_ptr<RestClient> rest_client_;
+    std::unique_ptr<AsyncRestClient> async_rest_client_;
     std::unique_ptr<WebSocketClient> ws_client_;
+    std::unique_ptr<RateLimiter> rate_limiter_;
+    RiskEngine risk_engine_;
+    std::unique_ptr<QuoteEngine> quote_engine_;
+    CandleEngine candle_engine_;
+    OptionsEngine options_engine_;
+    std::unique_ptr<KillSwitch> kill_switch_;
+    std::unique_ptr<TimeSync> time_sync_;
+    ClientOrderTracker client_orders_;
+    
+    // How long an unacknowledged order may be pending before a retry checks its label
+    static constexpr int64_t kAckTimeoutMs = 2000;
+    // How long a retry waits for that label lookup before giving up without resending
+    static constexpr int64_t kLookupTimeoutMs = 2000;
+    InstrumentStore instrument_store_;
+    OrderStore order_store_;
+    PositionStore position_store_;
+    PortfolioEngine portfolio_engine_;
     
     std::unordered_map<std::string, std::function<void(const Orderbook&)>> orderbook_callbacks_;
     std::mutex callbacks_mutex_;
     
+    // Trade history from trades.* subscriptions; written only by the WebSocket thread
+    std::unordered_map<std::string, std::shared_ptr<TradeRing>> trade_rings_;
+    mutable std::mutex trade_rings_mutex_;
+    
+    // Best bid/ask from quote.* and ticker.* subscriptions; written only by the WebSocket thread
+    std::unordered_map<std::string, std::shared_ptr<SeqLock<TopOfBook>>> top_of_book_;
+    mutable std::mutex top_of_book_mutex_;
+    
+    // Market data stage latencies; receive_time_ and wire_latency_ns_ are the frame being dispatched on the WebSocket thread
+    LatencyRecorder latency_{static_cast<size_t>(LatencyStage::Count)};
+    std::chrono::steady_clock::time_point receive_time_;
+    int64_t wire_latency_ns_{0};
+    OrderLatencyTracker order_latency_;
+    
+    // Books maintained from book.* subscriptions; a book that missed a change is dropped until resubscribed
+    std::unordered_map<std::string, Orderbook> live_books_;
+    std::vector<std::string> book_resyncs_;
+    mutable std::mutex books_mutex_;
+    
     std::atomic<bool> is_initialized_{false};
     std::atomic<bool> is_authenticated_{false};
     
@@ -155,9 +701,54 @@ private:
     std::thread ws_thread_;
     std::atomic<bool> ws_running_{false};
     
+    // Background maintenance thread for periodic tasks
+    struct MaintenanceTask {
+        std::chrono::steady_clock::duration interval;
+        std::chrono::steady_clock::time_point next_run;
+        std::function<void()> run;
+    };
+    std::vector<MaintenanceTask> maintenance_tasks_;
+    std::thread maintenance_thread_;
+    std::mutex maintenance_mutex_;
+    std::condition_variable maintenance_cv_;
+    bool maintenance_running_{false};
+    
     // Internal methods
     void processWebSocketMessages();
+    void dispatchNotification(const std::string& channel, const nlohmann::json& data);
+    void registerMetrics();
+    void countChannel(ChannelKind kind) { channel_messages_[static_cast<size_t>(kind)]->inc(); }
+    void countOrder(OrderMethod method, OrderOutcome outcome) {
+        order_outcomes_[static_cast<size_t>(method) * static_cast<size_t>(OrderOutcome::Count)
+                        + static_cast<size_t>(outcome)]->inc();
+    }
+    void handleResponse(const nlohmann::json& response);
+    bool enableCancelOnDisconnect();
+    bool fetchOrderState(const std::string& order_id, Order& order);
+    bool needsSend(const std::string& client_order_id, const std::string& instrument_name,
+                   const std::string& direction, double amount);
     void handleOrderbookUpdate(const nlohmann::json& data);
+    void resyncBooks();
+    void handleOrderUpdate(const nlohmann::json& data);
+    void handlePublicTrades(const nlohmann::json& data);
+    void handleTopOfBookUpdate(const nlohmann::json& data);
+    void handleIndexUpdate(const nlohmann::json& data);
+    void handleOptionMarkPrices(const nlohmann::json& data);
+    void updatePortfolioMark(const std::string& instrument_name, double mark_price, int64_t timestamp,
+                             bool exchange_mark);
+    void addTopOfBookSlot(const std::string& instrument_name);
+    void handleTradeUpdate(const nlohmann::json& data);
+    void handleChangesUpdate(const nlohmann::json& data);
+    void handlePortfolioUpdate(const nlohmann::json& data);
+    void throttle(const std::string& method, bool reduce_only = false);
+    bool checkRisk(const std::string& instrument_name, double amount, const std::string& type, double price, bool is_buy, const Instrument* instrument, double replaced_amount = 0.0);
+    bool validateOrder(const std::string& instrument_name, double amount, const std::string& type, double& price, bool is_buy, double replaced_amount = 0.0);
+    void updateOpenOrderRisk(const std::string& instrument_name);
+    void loadInstruments();
+    void addMaintenanceTask(std::chrono::steady_clock::duration interval, std::function<void()> task, bool run_now = false);
+    void startMaintenance();
+    void stopMaintenance();
+    void runMaintenance();
 };
 
 } // namespace deribit 
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <unordered_set>
+#include <future>
+#include <atomic>
+#include <nlohmann/json.hpp>
+#include <curl/curl.h>
+#include "deribit/config.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Asynchronous JSON-RPC over HTTP client built on the curl multi interface
+ *
+ * Requests are queued from any thread and driven by a dedicated event thread.
+ * Up to Config::getMaxConcurrentRequests() requests are in flight at once and
+ * are multiplexed over a single HTTP/2 connection where the server supports it.
+ */
+class AsyncRestClient {
+public:
+    using ResponseCallback = std::function<void(const nlohmann::json&)>;
+    using TokenProvider = std::function<std::string()>;
+
+    /**
+     * @brief Constructor
+     * @param config Configuration for the REST client
+     */
+    explicit AsyncRestClient(const Config& config);
+
+    /**
+     * @brief Destructor
+     */
+    ~AsyncRestClient();
+
+    /**
+     * @brief Initialize the client and start the event thread
+     * @return true if initialization was successful, false otherwise
+     */
+    bool initialize();
+
+    /**
+     * @brief Stop the event thread, failing any outstanding requests
+     */
+    void shutdown();
+
+    /**
+     * @brief Set the provider used to obtain the bearer token for private methods
+     * @param provider The token provider
+     */
+    void setTokenProvider(TokenProvider provider);
+
+    /**
+     * @brief Send a JSON-RPC request
+     * @param method The JSON-RPC method (e.g., "public/get_order_book")
+     * @param params The method parameters
+     * @return A future holding the response as JSON (empty on transport failure)
+     */
+    std::future<nlohmann::json> call(
+        const std::string& method,
+        const nlohmann::json& params = nlohmann::json::object());
+
+    /**
+     * @brief Send a JSON-RPC request
+     * @param method The JSON-RPC method (e.g., "public/get_order_book")
+     * @param params The method parameters
+     * @param callback Called on the event thread with the response
+     */
+    void call(
+        const std::string& method,
+        const nlohmann::json& params,
+        ResponseCallback callback);
+
+    /**
+     * @brief Get the number of requests waiting for a free slot
+     * @return The number of queued requests
+     */
+    size_t getQueuedCount() const;
+
+    /**
+     * @brief Get the number of requests currently in flight
+     * @return The number of in-flight requests
+     */
+    size_t getInFlightCount() const { return in_flight_; }
+
+private:
+    struct Request {
+        CURL* easy{nullptr};
+        struct curl_slist* headers{nullptr};
+        std::string body;
+        std::string response;
+        ResponseCallback callback;
+    };
+
+    Config config_;
+    CURLM* multi_{nullptr};
+    std::thread event_thread_;
+    std::atomic<bool> is_running_{false};
+    std::atomic<size_t> in_flight_{0};
+    std::atomic<uint64_t> next_id_{1};
+    std::unordered_set<CURL*> active_handles_;
+
+    mutable std::mutex queue_mutex_;
+    std::deque<std::unique_ptr<Request>> queue_;
+    TokenProvider token_provider_;
+
+    // Internal methods
+    void run();
+    void startQueuedRequests();
+    void completeRequest(CURL* easy, CURLcode result);
+    void failRequest(std::unique_ptr<Request> request);
+    nlohmann::json handleResponse(const Request& request, long http_code) const;
+};
+
+} // namespace deribit
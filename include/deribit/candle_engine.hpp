@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include "deribit/trade_ring.hpp"
+
+namespace deribit {
+
+/**
+ * @brief One OHLCV bar; prices and volume are fixed point (see kFixedPointScale)
+ */
+struct Candle {
+    int64_t start{0};     // Bar open time, milliseconds since epoch
+    int64_t open{0};
+    int64_t high{0};
+    int64_t low{0};
+    int64_t close{0};
+    int64_t volume{0};    // Traded amount; 0 for mid-price bars
+    uint32_t trades{0};   // Trades or mid updates folded into the bar
+};
+
+/**
+ * @brief Price feed a candle series is built from
+ */
+enum class CandleSource {
+    Trades,  // Trade prices and amounts from trades.*
+    Mid      // Order book mid prices from book.*, quote.* or ticker.*
+};
+
+/**
+ * @brief Incremental OHLCV builder for many instruments and intervals
+ *
+ * Each update touches one hash lookup and a fixed number of bars, so cost
+ * per trade is O(number of intervals). Closed bars go into a fixed-size
+ * contiguous ring per interval and are reported through the bar callback.
+ * Intervals without any update produce no bar.
+ */
+class CandleEngine {
+public:
+    using BarCallback = std::function<void(const std::string&, std::chrono::milliseconds, const Candle&)>;
+
+    /**
+     * @brief Constructor
+     * @param intervals Bar intervals maintained for every instrument; non-positive ones are skipped
+     * @param history Closed bars kept per instrument and interval
+     */
+    CandleEngine(const std::vector<std::chrono::milliseconds>& intervals, size_t history);
+
+    /**
+     * @brief Start building bars for an instrument
+     * @param instrument_name The instrument name
+     * @param source The price feed to build from
+     */
+    void track(const std::string& instrument_name, CandleSource source);
+
+    /**
+     * @brief Stop building bars for an instrument and drop its history
+     * @param instrument_name The instrument name
+     */
+    void untrack(const std::string& instrument_name);
+
+    /**
+     * @brief Set the callback invoked whenever a bar closes
+     * @param callback The callback; called outside the engine lock
+     */
+    void setBarCallback(BarCallback callback);
+
+    /**
+     * @brief Fold a trade into an instrument tracked from trades
+     * @param instrument_name The instrument name
+     * @param trade The trade
+     */
+    void onTrade(const std::string& instrument_name, const TradeRecord& trade);
+
+    /**
+     * @brief Fold a mid price into an instrument tracked from mids
+     * @param instrument_name The instrument name
+     * @param timestamp Milliseconds since epoch
+     * @param mid The mid price
+     */
+    void onMid(const std::string& instrument_name, int64_t timestamp, double mid);
+
+    /**
+     * @brief Copy the closed bars of an instrument and interval, oldest first
+     * @param instrument_name The instrument name
+     * @param interval The bar interval
+     * @return The closed bars; empty if not tracked
+     */
+    std::vector<Candle> getCandles(const std::string& instrument_name, std::chrono::milliseconds interval) const;
+
+    /**
+     * @brief Get the bar currently being built
+     * @param instrument_name The instrument name
+     * @param interval The bar interval
+     * @param candle The open bar, if any
+     * @return true if a bar is open, false otherwise
+     */
+    bool getCurrentCandle(const std::string& instrument_name, std::chrono::milliseconds interval, Candle& candle) const;
+
+private:
+    struct Series {
+        int64_t interval_ms;
+        Candle current;
+        bool has_current{false};
+        std::vector<Candle> history;  // Ring of closed bars
+        size_t next{0};
+        size_t count{0};
+    };
+
+    struct InstrumentCandles {
+        CandleSource source;
+        std::vector<Series> series;
+    };
+
+    struct ClosedBar {
+        std::chrono::milliseconds interval;
+        Candle candle;
+    };
+
+    std::vector<std::chrono::milliseconds> intervals_;
+    size_t history_;
+    std::unordered_map<std::string, InstrumentCandles> instruments_;
+    BarCallback bar_callback_;
+    mutable std::mutex mutex_;
+
+    // Internal methods
+    void apply(const std::string& instrument_name, CandleSource source,
+               int64_t timestamp, int64_t price, int64_t volume);
+    const Series* findSeries(const std::string& instrument_name, std::chrono::milliseconds interval) const;
+};
+
+} // namespace deribit
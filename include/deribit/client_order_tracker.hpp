@@ -0,0 +1,173 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "deribit/order.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Lifecycle of an order as seen from the request that created it
+ */
+enum class ClientOrderState {
+    Pending,   // Sent, no ack yet
+    Acked,     // Resting or partially filled on the exchange
+    Rejected,  // Refused by the exchange; may be retried under the same id
+    Closed     // Filled or cancelled
+};
+
+/**
+ * @brief An order request tracked by its client order id
+ */
+struct ClientOrder {
+    std::string client_order_id;
+    std::string label;             // Label sent to the exchange (see ClientOrderTracker::labelFor)
+    std::string instrument_name;
+    std::string direction;
+    std::string order_id;          // Exchange order id, empty until acked
+    double amount{0.0};
+    double price{0.0};
+    double filled_amount{0.0};
+    ClientOrderState state{ClientOrderState::Pending};
+    uint64_t request_id{0};        // JSON-RPC id of the last send
+    int64_t sent_at{0};            // Milliseconds since epoch of the last send
+    std::string reject_reason;
+};
+
+/**
+ * @brief Maps client order ids, carried at the end of the order label, to exchange orders
+ *
+ * Every order sent gets a unique client order id and JSON-RPC request id.
+ * Acks, rejects, order updates and fills resolve against the originating
+ * request through hash indexes, so a lost ack can be recovered from the
+ * label alone and a retry under the same id is never sent twice.
+ */
+class ClientOrderTracker {
+public:
+    /**
+     * @brief Constructor; picks a session prefix for generated ids
+     */
+    ClientOrderTracker();
+
+    /**
+     * @brief Generate a new unique client order id
+     * @return The client order id (e.g., "c5f3a9b12-42")
+     */
+    std::string nextClientOrderId();
+
+    /**
+     * @brief Build the exchange label for an order
+     * @param label The caller's free-form label, possibly empty
+     * @param client_order_id The client order id; must not contain '/'
+     * @return "<label>/<client order id>", or the client order id alone when label is empty
+     */
+    static std::string labelFor(const std::string& label, const std::string& client_order_id);
+
+    /**
+     * @brief Extract the client order id from an exchange label
+     * @param label The label as reported by the exchange
+     * @return Everything after the last '/', or the whole label if there is none
+     */
+    static std::string clientOrderIdOf(const std::string& label);
+
+    /**
+     * @brief Start tracking a send of an order
+     *
+     * A rejected order may be sent again under the same id; any other known
+     * id is refused so that retries stay idempotent.
+     *
+     * @param client_order_id The client order id
+     * @param label The label the order is sent with
+     * @param instrument_name The instrument name
+     * @param direction "buy" or "sell"
+     * @param amount The order amount
+     * @param price The limit price, or 0 for market orders
+     * @return The JSON-RPC id to send the order with, or 0 if the id is already live
+     */
+    uint64_t track(
+        const std::string& client_order_id,
+        const std::string& label,
+        const std::string& instrument_name,
+        const std::string& direction,
+        double amount,
+        double price);
+
+    /**
+     * @brief Find a tracked order by client order id
+     * @param client_order_id The client order id
+     * @param order The tracked order, if found
+     * @return true if found, false otherwise
+     */
+    bool find(const std::string& client_order_id, ClientOrder& order) const;
+
+    /**
+     * @brief Find a tracked order by exchange order id
+     * @param order_id The exchange order id
+     * @param order The tracked order, if found
+     * @return true if found, false otherwise
+     */
+    bool findByOrderId(const std::string& order_id, ClientOrder& order) const;
+
+    /**
+     * @brief Check if a JSON-RPC response belongs to a tracked order
+     * @param id The response id
+     * @return true if the id was issued by the tracker, false otherwise
+     */
+    static bool ownsRequest(uint64_t id) { return id >= kFirstRequestId && id < kLastRequestId; }
+
+    /**
+     * @brief Handle the JSON-RPC response to an order request
+     * @param response The response
+     */
+    void onResponse(const nlohmann::json& response);
+
+    /**
+     * @brief Record a rejection that arrived outside a JSON-RPC response
+     * @param client_order_id The client order id
+     * @param reason The rejection reason
+     */
+    void onReject(const std::string& client_order_id, const std::string& reason);
+
+    /**
+     * @brief Handle an order state from an ack, update or REST lookup
+     * @param order The order
+     */
+    void onOrder(const Order& order);
+
+    /**
+     * @brief Handle a user.trades fill
+     *
+     * A fill only acks the order; filled amounts come from the order's
+     * cumulative state so a fill seen both ways is never counted twice.
+     *
+     * @param trade The trade JSON
+     */
+    void onTrade(const nlohmann::json& trade);
+
+private:
+    static constexpr uint64_t kFirstRequestId = 100000;
+    static constexpr uint64_t kLastRequestId = 1000000;
+    static constexpr size_t kMaxClosedOrders = 10000;
+
+    std::string prefix_;
+    std::atomic<uint64_t> next_sequence_{1};
+    uint64_t next_request_id_{kFirstRequestId};
+
+    std::unordered_map<std::string, ClientOrder> orders_;
+    std::unordered_map<uint64_t, std::string> client_id_by_request_;
+    std::unordered_map<std::string, std::string> client_id_by_order_id_;
+    std::deque<std::string> closed_orders_;
+    mutable std::mutex mutex_;
+
+    // Internal methods
+    void applyOrder(ClientOrder& tracked, const Order& order);
+    void reject(ClientOrder& tracked, const std::string& reason);
+    void close(ClientOrder& tracked);
+};
+
+} // namespace deribit
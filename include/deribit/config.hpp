@@ -1,9 +1,34 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "deribit/logger.hpp"
 
 namespace deribit {
 
+/**
+ * @brief Credit bucket settings for one class of rate-limited requests
+ */
+struct RateLimitSettings {
+    double max_credits;        // Bucket capacity (burst)
+    double refill_per_second;  // Credits restored per second
+    double cost_per_request;   // Credits consumed by one request
+};
+
+/**
+ * @brief Pre-trade risk limits; a limit of zero disables that check
+ */
+struct RiskLimits {
+    double max_order_size;          // Largest single order amount
+    double max_position;            // Largest absolute position per instrument
+    double max_notional;            // Largest single order notional in USD; options at the index
+    double price_band;              // Max limit price deviation from mid, as a fraction
+    uint32_t max_orders_per_second; // Orders admitted per one-second window
+};
+
 /**
  * @brief Configuration for the Deribit API client
  */
@@ -45,24 +70,352 @@ public:
 
     /**
      * @brief Get the REST API URL
-     * @return The REST API URL
+     * @return The override if set, otherwise the testnet or mainnet URL
      */
     std::string getRestApiUrl() const {
+        if (!rest_api_url_.empty()) {
+            return rest_api_url_;
+        }
         return testnet_ ? "https://test.deribit.com/api/v2" : "https://www.deribit.com/api/v2";
     }
 
+    /**
+     * @brief Override the REST API URL, e.g. to point at a local mock exchange
+     * @param url The URL (e.g., "http://127.0.0.1:8080/api/v2"); empty restores the default
+     */
+    void setRestApiUrl(const std::string& url) { rest_api_url_ = url; }
+
     /**
      * @brief Get the WebSocket API URL
-     * @return The WebSocket API URL
+     * @return The override if set, otherwise the testnet or mainnet URL
      */
     std::string getWebSocketApiUrl() const {
+        if (!websocket_api_url_.empty()) {
+            return websocket_api_url_;
+        }
         return testnet_ ? "wss://test.deribit.com/ws/api/v2" : "wss://www.deribit.com/ws/api/v2";
     }
 
+    /**
+     * @brief Override the WebSocket API URL, e.g. to point at a local mock exchange
+     * @param url The wss:// URL (e.g., "wss://127.0.0.1:8443/ws/api/v2"); empty restores the default
+     */
+    void setWebSocketApiUrl(const std::string& url) { websocket_api_url_ = url; }
+
+    /**
+     * @brief Get the maximum number of concurrent asynchronous REST requests
+     * @return The concurrency cap
+     */
+    size_t getMaxConcurrentRequests() const { return max_concurrent_requests_; }
+
+    /**
+     * @brief Set the maximum number of concurrent asynchronous REST requests
+     * @param max_concurrent_requests The concurrency cap
+     */
+    void setMaxConcurrentRequests(size_t max_concurrent_requests) {
+        max_concurrent_requests_ = max_concurrent_requests;
+    }
+
+    /**
+     * @brief Get the rate limit for matching-engine requests (orders, edits, cancels)
+     * @return The rate limit settings
+     */
+    const RateLimitSettings& getMatchingEngineRateLimit() const { return matching_engine_rate_limit_; }
+
+    /**
+     * @brief Set the rate limit for matching-engine requests
+     * @param settings The rate limit settings
+     */
+    void setMatchingEngineRateLimit(const RateLimitSettings& settings) {
+        matching_engine_rate_limit_ = settings;
+    }
+
+    /**
+     * @brief Get the rate limit for non-matching requests (queries, subscriptions)
+     * @return The rate limit settings
+     */
+    const RateLimitSettings& getNonMatchingRateLimit() const { return non_matching_rate_limit_; }
+
+    /**
+     * @brief Set the rate limit for non-matching requests
+     * @param settings The rate limit settings
+     */
+    void setNonMatchingRateLimit(const RateLimitSettings& settings) {
+        non_matching_rate_limit_ = settings;
+    }
+
+    /**
+     * @brief Get the pre-trade risk limits
+     * @return The risk limits
+     */
+    const RiskLimits& getRiskLimits() const { return risk_limits_; }
+
+    /**
+     * @brief Set the pre-trade risk limits
+     * @param limits The risk limits
+     */
+    void setRiskLimits(const RiskLimits& limits) { risk_limits_ = limits; }
+
+    /**
+     * @brief Get the number of trades kept per instrument by subscribeTrades
+     * @return The history window in trades
+     */
+    size_t getTradeHistoryCapacity() const { return trade_history_capacity_; }
+
+    /**
+     * @brief Set the number of trades kept per instrument by subscribeTrades
+     * @param capacity The history window in trades (rounded up to a power of two)
+     */
+    void setTradeHistoryCapacity(size_t capacity) { trade_history_capacity_ = capacity; }
+
+    /**
+     * @brief Get the candle intervals built for every tracked instrument
+     * @return The intervals (e.g., 1s, 1m, 5m)
+     */
+    const std::vector<std::chrono::milliseconds>& getCandleIntervals() const { return candle_intervals_; }
+
+    /**
+     * @brief Set the candle intervals built for every tracked instrument
+     * @param intervals The intervals
+     */
+    void setCandleIntervals(const std::vector<std::chrono::milliseconds>& intervals) {
+        candle_intervals_ = intervals;
+    }
+
+    /**
+     * @brief Get the number of closed candles kept per instrument and interval
+     * @return The history length in bars
+     */
+    size_t getCandleHistory() const { return candle_history_; }
+
+    /**
+     * @brief Set the number of closed candles kept per instrument and interval
+     * @param bars The history length in bars
+     */
+    void setCandleHistory(size_t bars) { candle_history_ = bars; }
+
+    /**
+     * @brief Check if cancel-on-disconnect is enabled at session start
+     * @return true if enabled, false otherwise
+     */
+    bool isCancelOnDisconnect() const { return cancel_on_disconnect_; }
+
+    /**
+     * @brief Enable or disable cancel-on-disconnect at session start
+     * @param enabled Whether open orders are cancelled when the WebSocket drops
+     */
+    void setCancelOnDisconnect(bool enabled) { cancel_on_disconnect_ = enabled; }
+
+    /**
+     * @brief Get the quote hysteresis band in ticks
+     *
+     * Quote price moves smaller than this many ticks are not sent as edits.
+     *
+     * @return The band in ticks
+     */
+    double getQuoteHysteresisTicks() const { return quote_hysteresis_ticks_; }
+
+    /**
+     * @brief Set the quote hysteresis band in ticks
+     * @param ticks The band in ticks
+     */
+    void setQuoteHysteresisTicks(double ticks) { quote_hysteresis_ticks_ = ticks; }
+
+    /**
+     * @brief Get the currencies whose instruments are loaded at startup
+     * @return The currencies (e.g., {"BTC", "ETH"})
+     */
+    const std::vector<std::string>& getInstrumentCurrencies() const { return instrument_currencies_; }
+
+    /**
+     * @brief Set the currencies whose instruments are loaded at startup
+     * @param currencies The currencies
+     */
+    void setInstrumentCurrencies(const std::vector<std::string>& currencies) {
+        instrument_currencies_ = currencies;
+    }
+
+    /**
+     * @brief Get the path of the instrument snapshot file
+     * @return The snapshot path; empty disables snapshots
+     */
+    const std::string& getInstrumentSnapshotPath() const { return instrument_snapshot_path_; }
+
+    /**
+     * @brief Set the path of the instrument snapshot file
+     * @param path The snapshot path; empty disables snapshots
+     */
+    void setInstrumentSnapshotPath(const std::string& path) { instrument_snapshot_path_ = path; }
+
+    /**
+     * @brief Get the interval between background instrument refreshes
+     * @return The refresh interval
+     */
+    std::chrono::seconds getInstrumentRefreshInterval() const { return instrument_refresh_interval_; }
+
+    /**
+     * @brief Set the interval between background instrument refreshes
+     * @param interval The refresh interval
+     */
+    void setInstrumentRefreshInterval(std::chrono::seconds interval) {
+        instrument_refresh_interval_ = interval;
+    }
+
+    /**
+     * @brief Get the interval between REST reconciliations of the order store
+     * @return The reconciliation interval
+     */
+    std::chrono::seconds getOrderReconcileInterval() const { return order_reconcile_interval_; }
+
+    /**
+     * @brief Set the interval between REST reconciliations of the order store
+     * @param interval The reconciliation interval
+     */
+    void setOrderReconcileInterval(std::chrono::seconds interval) {
+        order_reconcile_interval_ = interval;
+    }
+
+    /**
+     * @brief Get the interval between REST reconciliations of the position store
+     * @return The reconciliation interval
+     */
+    std::chrono::seconds getPositionReconcileInterval() const { return position_reconcile_interval_; }
+
+    /**
+     * @brief Set the interval between REST reconciliations of the position store
+     * @param interval The reconciliation interval
+     */
+    void setPositionReconcileInterval(std::chrono::seconds interval) {
+        position_reconcile_interval_ = interval;
+    }
+
+    /**
+     * @brief Get the interval between public/get_time probes used to estimate the exchange clock offset
+     * @return The probe interval
+     */
+    std::chrono::seconds getTimeSyncInterval() const { return time_sync_interval_; }
+
+    /**
+     * @brief Set the interval between public/get_time probes used to estimate the exchange clock offset
+     * @param interval The probe interval
+     */
+    void setTimeSyncInterval(std::chrono::seconds interval) {
+        time_sync_interval_ = interval;
+    }
+
+    /**
+     * @brief Get the wire latency above which a book update marks its feed as stale
+     * @return The threshold
+     */
+    std::chrono::milliseconds getStaleFeedThreshold() const { return stale_feed_threshold_; }
+
+    /**
+     * @brief Set the wire latency above which a book update marks its feed as stale
+     * @param threshold The threshold
+     */
+    void setStaleFeedThreshold(std::chrono::milliseconds threshold) {
+        stale_feed_threshold_ = threshold;
+    }
+
+    /**
+     * @brief Get the localhost port the Prometheus metrics endpoint listens on
+     * @return The port, or 0 if the endpoint is disabled
+     */
+    uint16_t getMetricsPort() const { return metrics_port_; }
+
+    /**
+     * @brief Set the localhost port the Prometheus metrics endpoint listens on
+     * @param port The port, or 0 to disable the endpoint
+     */
+    void setMetricsPort(uint16_t port) {
+        metrics_port_ = port;
+    }
+
+    /**
+     * @brief Get the minimum level written by the asynchronous logger
+     * @return The log level
+     */
+    LogLevel getLogLevel() const { return log_level_; }
+
+    /**
+     * @brief Set the minimum level written by the asynchronous logger
+     * @param level The log level
+     */
+    void setLogLevel(LogLevel level) {
+        log_level_ = level;
+    }
+
+    /**
+     * @brief Get how many records each logging statement may emit per second
+     * @return The limit, or 0 for no limit
+     */
+    uint32_t getLogRateLimit() const { return log_rate_limit_; }
+
+    /**
+     * @brief Set how many records each logging statement may emit per second
+     * @param per_second The limit, or 0 for no limit
+     */
+    void setLogRateLimit(uint32_t per_second) {
+        log_rate_limit_ = per_second;
+    }
+
+    /**
+     * @brief Get the file name prefix inbound WebSocket frames are recorded to
+     * @return The prefix; empty disables recording
+     */
+    const std::string& getFrameJournalPath() const { return frame_journal_path_; }
+
+    /**
+     * @brief Set the file name prefix inbound WebSocket frames are recorded to
+     * @param path The prefix (e.g., "capture/frames"); empty disables recording
+     */
+    void setFrameJournalPath(const std::string& path) { frame_journal_path_ = path; }
+
+    /**
+     * @brief Get the size at which a frame journal file rolls over to the next
+     * @return The size in bytes
+     */
+    uint64_t getFrameJournalFileSize() const { return frame_journal_file_size_; }
+
+    /**
+     * @brief Set the size at which a frame journal file rolls over to the next
+     * @param bytes The size in bytes
+     */
+    void setFrameJournalFileSize(uint64_t bytes) {
+        frame_journal_file_size_ = bytes;
+    }
+
 private:
     std::string api_key_;
     std::string api_secret_;
     bool testnet_{true};
+    std::string rest_api_url_;
+    std::string websocket_api_url_;
+    size_t max_concurrent_requests_{16};
+    // Deribit defaults: 5 req/s burst 20 on the matching engine,
+    // 20 req/s burst 100 for everything else
+    RateLimitSettings matching_engine_rate_limit_{20.0, 5.0, 1.0};
+    RateLimitSettings non_matching_rate_limit_{50000.0, 10000.0, 500.0};
+    RiskLimits risk_limits_{0.0, 0.0, 0.0, 0.10, 20};
+    double quote_hysteresis_ticks_{1.0};
+    bool cancel_on_disconnect_{true};
+    size_t trade_history_capacity_{16384};
+    std::vector<std::chrono::milliseconds> candle_intervals_{
+        std::chrono::seconds(1), std::chrono::minutes(1), std::chrono::minutes(5),
+        std::chrono::minutes(15), std::chrono::hours(1)};
+    size_t candle_history_{1440};
+    std::vector<std::string> instrument_currencies_{"BTC", "ETH"};
+    std::string instrument_snapshot_path_{"instruments_snapshot.json"};
+    std::chrono::seconds instrument_refresh_interval_{600};
+    std::chrono::seconds order_reconcile_interval_{30};
+    std::chrono::seconds position_reconcile_interval_{30};
+    std::chrono::seconds time_sync_interval_{10};
+    std::chrono::milliseconds stale_feed_threshold_{500};
+    uint16_t metrics_port_{0};
+    LogLevel log_level_{LogLevel::Info};
+    uint32_t log_rate_limit_{1000};
+    std::string frame_journal_path_;
+    uint64_t frame_journal_file_size_{256ull * 1024 * 1024};
 };
 
 } // namespace deribit 
\ No newline at end of file
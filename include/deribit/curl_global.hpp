@@ -0,0 +1,21 @@
+#pragma once
+
+#include <curl/curl.h>
+
+namespace deribit {
+
+/**
+ * @brief Initialize libcurl once for the whole process
+ *
+ * curl_global_init and curl_global_cleanup are not thread-safe against
+ * other curl use, so every client shares one initialization and it is
+ * never cleaned up.
+ *
+ * @return true if libcurl is initialized, false otherwise
+ */
+inline bool curlGlobalInit() {
+    static const CURLcode result = curl_global_init(CURL_GLOBAL_ALL);
+    return result == CURLE_OK;
+}
+
+} // namespace deribit
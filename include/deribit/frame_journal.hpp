@@ -0,0 +1,145 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace deribit {
+
+/**
+ * @brief Header at the start of every journal file
+ */
+struct FrameJournalFileHeader {
+    char magic[8];              // "DRBJRNL1"
+    uint32_t version;
+    uint32_t header_size;       // Offset of the first record
+    int64_t wall_ns;            // system_clock at creation
+    int64_t steady_ns;          // steady_clock at creation; maps record timestamps to wall time
+    uint64_t file_index;        // Position in the rollover sequence, from 0
+};
+
+/**
+ * @brief Header in front of each frame in a journal file
+ *
+ * The payload follows the header and is padded to 8 bytes. A zero length
+ * marks the end of the data in a file that was not closed cleanly.
+ */
+struct FrameRecordHeader {
+    uint32_t length;            // Payload bytes
+    uint32_t connection_id;     // WebSocketClient connection count when the frame arrived
+    int64_t receive_ns;         // steady_clock since its epoch
+};
+
+/**
+ * @brief Frame journal counters
+ */
+struct FrameJournalStats {
+    uint64_t frames{0};         // Frames written to a file
+    uint64_t bytes{0};          // Payload bytes written to a file
+    uint64_t dropped{0};        // Frames lost to a full buffer or too large to record
+    uint64_t files{0};          // Files opened, including the current one
+};
+
+/**
+ * @brief Append-only capture of raw frames into memory-mapped files
+ *
+ * The receiving thread copies each frame into a single-producer byte ring
+ * and returns; it never blocks, allocates or touches the file. A writer
+ * thread drains the ring into a memory-mapped file and rolls over to a new
+ * file once the current one is full. When the ring is full the frame is
+ * dropped and counted. Files are named <path>.<start ms>.<index>.
+ */
+class FrameJournal {
+public:
+    static constexpr size_t kDefaultBufferCapacity = 16 * 1024 * 1024;
+
+    /**
+     * @brief Constructor
+     * @param path The file name prefix
+     * @param file_size The size at which a file rolls over, in bytes
+     * @param buffer_capacity The ring size in bytes; rounded up to a power of two
+     */
+    FrameJournal(const std::string& path, uint64_t file_size, size_t buffer_capacity = kDefaultBufferCapacity);
+
+    /**
+     * @brief Destructor
+     */
+    ~FrameJournal();
+
+    /**
+     * @brief Open the first file and start the writer thread
+     * @return true if the journal is recording, false otherwise
+     */
+    bool start();
+
+    /**
+     * @brief Write out everything buffered, trim the current file and stop the writer thread
+     */
+    void stop();
+
+    /**
+     * @brief Record a frame; producer thread only
+     * @param connection_id The connection the frame arrived on
+     * @param receive_ns The monotonic receive time in nanoseconds
+     * @param data The frame payload
+     * @param length The payload size
+     * @return true if buffered, false if dropped
+     */
+    bool append(uint32_t connection_id, int64_t receive_ns, const char* data, size_t length);
+
+    /**
+     * @brief Get the journal counters
+     * @return The counters
+     */
+    FrameJournalStats getStats() const;
+
+    /**
+     * @brief Read back every frame in one journal file
+     * @param file The file name
+     * @param callback Called with each record header and payload, in order
+     * @return true if the file was a journal and was read to its end, false otherwise
+     */
+    static bool read(const std::string& file,
+                     const std::function<void(const FrameRecordHeader&, const std::string&)>& callback);
+
+private:
+    struct MappedFile;
+
+    std::string path_;
+    uint64_t file_size_;
+    int64_t start_ms_{0};
+
+    // Ring of [FrameRecordHeader][payload] records, each padded to kRingAlign
+    std::unique_ptr<char[]> buffer_;
+    size_t capacity_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t cached_tail_{0};  // Producer's last view of tail_
+    alignas(64) std::atomic<size_t> tail_{0};
+
+    // Owned by the writer thread
+    std::unique_ptr<MappedFile> file_;
+    uint64_t write_offset_{0};
+    uint64_t file_index_{0};
+    std::chrono::steady_clock::time_point next_open_attempt_;  // Retry time after a failed open
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> files_{0};
+
+    // Internal methods
+    void run();
+    size_t drain();
+    bool openFile();
+    void closeFile();
+};
+
+} // namespace deribit
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+
+/**
+ * @brief Reference data for a tradable instrument
+ */
+class Instrument {
+public:
+    /**
+     * @brief Constructor
+     */
+    Instrument() = default;
+
+    /**
+     * @brief Constructor from JSON
+     * @param json The JSON data (an entry of public/get_instruments)
+     */
+    explicit Instrument(const nlohmann::json& json);
+
+    /**
+     * @brief Get the instrument name
+     * @return The instrument name
+     */
+    const std::string& getInstrumentName() const { return instrument_name_; }
+
+    /**
+     * @brief Get the instrument kind
+     * @return The kind ("future", "option", "spot", ...)
+     */
+    const std::string& getKind() const { return kind_; }
+
+    /**
+     * @brief Get the base currency
+     * @return The base currency (e.g., "BTC")
+     */
+    const std::string& getBaseCurrency() const { return base_currency_; }
+
+    /**
+     * @brief Get the quote currency
+     * @return The quote currency (e.g., "USD")
+     */
+    const std::string& getQuoteCurrency() const { return quote_currency_; }
+
+    /**
+     * @brief Get the settlement currency
+     * @return The settlement currency
+     */
+    const std::string& getSettlementCurrency() const { return settlement_currency_; }
+
+    /**
+     * @brief Derive the settlement currency from an instrument name alone
+     *
+     * Linear names carry it after the underscore ("BTC_USDC-PERPETUAL" -> "USDC"),
+     * inverse ones before the dash ("BTC-PERPETUAL" -> "BTC"). This is the
+     * currency the exchange files the instrument's orders and positions under.
+     *
+     * @param instrument_name The instrument name
+     * @return The settlement currency
+     */
+    static std::string settlementCurrencyOf(const std::string& instrument_name);
+
+    /**
+     * @brief Get the minimum price increment
+     * @return The tick size
+     */
+    double getTickSize() const { return tick_size_; }
+
+    /**
+     * @brief Get the minimum order amount, which is also the amount increment
+     * @return The minimum trade amount
+     */
+    double getMinTradeAmount() const { return min_trade_amount_; }
+
+    /**
+     * @brief Get the contract size
+     * @return The contract size
+     */
+    double getContractSize() const { return contract_size_; }
+
+    /**
+     * @brief Get the strike price (options only)
+     * @return The strike price
+     */
+    double getStrike() const { return strike_; }
+
+    /**
+     * @brief Get the option type (options only)
+     * @return The option type ("call" or "put")
+     */
+    const std::string& getOptionType() const { return option_type_; }
+
+    /**
+     * @brief Get the expiration timestamp
+     * @return The expiration timestamp in milliseconds
+     */
+    int64_t getExpirationTimestamp() const { return expiration_timestamp_; }
+
+    /**
+     * @brief Check if the instrument is active
+     * @return true if active, false otherwise
+     */
+    bool isActive() const { return is_active_; }
+
+    /**
+     * @brief Check if the instrument is an option
+     * @return true if option, false otherwise
+     */
+    bool isOption() const { return kind_ == "option"; }
+
+    /**
+     * @brief Check if the instrument is a future (including perpetuals)
+     * @return true if future, false otherwise
+     */
+    bool isFuture() const { return kind_ == "future"; }
+
+    /**
+     * @brief Check if the instrument is an inverse future, whose amount is in USD
+     * @return true if inverse, false otherwise
+     */
+    bool isInverse() const { return isFuture() && settlement_currency_ == base_currency_; }
+
+    /**
+     * @brief Round a price to the nearest tick
+     * @param price The price
+     * @return The rounded price
+     */
+    double roundPrice(double price) const;
+
+    /**
+     * @brief Round a price down to a tick (passive for bids)
+     * @param price The price
+     * @return The rounded price
+     */
+    double roundPriceDown(double price) const;
+
+    /**
+     * @brief Round a price up to a tick (passive for asks)
+     * @param price The price
+     * @return The rounded price
+     */
+    double roundPriceUp(double price) const;
+
+    /**
+     * @brief Round an amount down to a multiple of the minimum trade amount
+     * @param amount The amount
+     * @return The rounded amount
+     */
+    double roundAmount(double amount) const;
+
+    /**
+     * @brief Check whether an order amount is valid for this instrument
+     * @param amount The amount
+     * @return true if valid, false otherwise
+     */
+    bool isValidAmount(double amount) const;
+
+    /**
+     * @brief Check whether a limit price lies on the tick grid
+     * @param price The price
+     * @return true if valid, false otherwise
+     */
+    bool isValidPrice(double price) const;
+
+    /**
+     * @brief Convert the instrument to JSON
+     * @return The JSON representation
+     */
+    nlohmann::json toJson() const;
+
+    /**
+     * @brief Check whether two instruments carry the same reference data
+     * @param other The other instrument
+     * @return true if equal, false otherwise
+     */
+    bool operator==(const Instrument& other) const;
+
+private:
+    std::string instrument_name_;
+    std::string kind_;
+    std::string base_currency_;
+    std::string quote_currency_;
+    std::string settlement_currency_;
+    double tick_size_{0.0};
+    double min_trade_amount_{0.0};
+    double contract_size_{0.0};
+    double strike_{0.0};
+    std::string option_type_;
+    int64_t expiration_timestamp_{0};
+    bool is_active_{true};
+};
+
+} // namespace deribit
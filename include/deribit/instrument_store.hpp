@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "deribit/instrument.hpp"
+
+namespace deribit {
+
+/**
+ * @brief In-memory instrument reference data keyed by instrument name
+ *
+ * Lookups load an immutable snapshot and are O(1) without taking the store's
+ * mutex; the load itself is std::atomic_load on a shared_ptr, which standard
+ * libraries back with a short internal lock.
+ * Updates build a new snapshot that shares every unchanged Instrument with
+ * the previous one and publish it atomically.
+ */
+class InstrumentStore {
+public:
+    using InstrumentPtr = std::shared_ptr<const Instrument>;
+    using InstrumentMap = std::unordered_map<std::string, InstrumentPtr>;
+
+    /**
+     * @brief Constructor
+     */
+    InstrumentStore();
+
+    /**
+     * @brief Find an instrument by name
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return The instrument, or nullptr if unknown
+     */
+    InstrumentPtr find(const std::string& instrument_name) const;
+
+    /**
+     * @brief Get the currency an instrument settles in
+     * @param instrument_name The instrument name
+     * @return The settlement currency from reference data, or derived from the name if unknown
+     */
+    std::string settlementCurrency(const std::string& instrument_name) const;
+
+    /**
+     * @brief Get every known instrument
+     * @return The current snapshot
+     */
+    std::shared_ptr<const InstrumentMap> snapshot() const;
+
+    /**
+     * @brief Get the number of known instruments
+     * @return The number of instruments
+     */
+    size_t size() const;
+
+    /**
+     * @brief Merge a public/get_instruments result for one currency
+     *
+     * Instruments of that currency missing from the result (expired or
+     * delisted) are removed; unchanged instruments are kept as-is.
+     *
+     * @param currency The currency the result was requested for
+     * @param instruments The "result" array of public/get_instruments
+     * @return The number of instruments added, changed or removed
+     */
+    size_t applyInstruments(const std::string& currency, const nlohmann::json& instruments);
+
+    /**
+     * @brief Load a snapshot previously written by saveSnapshot
+     * @param path The snapshot file path
+     * @param testnet Only accept snapshots taken against the same environment
+     * @return true if the snapshot was loaded, false otherwise
+     */
+    bool loadSnapshot(const std::string& path, bool testnet);
+
+    /**
+     * @brief Persist the current instruments to a snapshot file
+     * @param path The snapshot file path
+     * @param testnet The environment the data was taken from
+     * @return true if the snapshot was written, false otherwise
+     */
+    bool saveSnapshot(const std::string& path, bool testnet);
+
+private:
+    std::shared_ptr<const InstrumentMap> instruments_;
+    std::mutex update_mutex_;
+    // Instrument names per requested currency, used to detect removals
+    std::unordered_map<std::string, std::vector<std::string>> names_by_currency_;
+};
+
+} // namespace deribit
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+
+/**
+ * @brief Kill switch counters
+ */
+struct KillSwitchStats {
+    uint64_t triggers{0};          // cancel_all requests sent
+    uint64_t acks{0};              // Successful responses
+    uint64_t errors{0};            // Error responses or failed sends
+    uint64_t last_cancelled{0};    // Orders cancelled by the last acknowledged request
+    uint64_t last_latency_ns{0};   // Send-to-ack time of the last acknowledged request
+    uint64_t max_latency_ns{0};    // Worst send-to-ack time seen
+};
+
+/**
+ * @brief Panic path that cancels resting orders over the open WebSocket
+ *
+ * The cancel_all messages are encoded once up front, less their id, and
+ * written straight to the socket, bypassing the rate limiter and every queue.
+ * Each request takes the next id of a small reserved range and records its
+ * own send time, so overlapping triggers are each timed to their own ack.
+ */
+class KillSwitch {
+public:
+    using SendFunction = std::function<bool(const std::string&)>;
+
+    static constexpr uint64_t kFirstRequestId = 1000;
+    static constexpr uint64_t kRequestIds = 64;  // Requests that may be awaiting an ack at once
+
+    /**
+     * @brief Constructor
+     * @param currencies Currencies to pre-encode per-currency cancels for
+     * @param send Function that writes a message to the WebSocket
+     */
+    KillSwitch(const std::vector<std::string>& currencies, SendFunction send);
+
+    /**
+     * @brief Cancel every open order
+     * @return true if the request was sent, false otherwise
+     */
+    bool cancelAll();
+
+    /**
+     * @brief Cancel every open order in a currency
+     * @param currency The currency (e.g., "BTC")
+     * @return true if the request was sent, false otherwise
+     */
+    bool cancelCurrency(const std::string& currency);
+
+    /**
+     * @brief Cancel every open order in an instrument
+     * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+     * @return true if the request was sent, false otherwise
+     */
+    bool cancelInstrument(const std::string& instrument_name);
+
+    /**
+     * @brief Check if a JSON-RPC response belongs to the kill switch
+     * @param id The response id
+     * @return true if the kill switch sent the request, false otherwise
+     */
+    static bool ownsRequest(uint64_t id) { return id >= kFirstRequestId && id < kFirstRequestId + kRequestIds; }
+
+    /**
+     * @brief Handle the response to a cancel_all request
+     * @param response The JSON-RPC response
+     */
+    void onResponse(const nlohmann::json& response);
+
+    /**
+     * @brief Get the kill switch counters
+     * @return The current counters
+     */
+    KillSwitchStats getStats() const;
+
+private:
+    SendFunction send_;
+    // Encoded requests from just after the id to the end
+    std::string cancel_all_message_;
+    std::unordered_map<std::string, std::string> cancel_currency_messages_;
+
+    std::atomic<uint64_t> next_request_{0};
+    std::array<std::atomic<int64_t>, kRequestIds> sent_at_ns_{};  // Indexed by id - kFirstRequestId; 0 when free
+    std::atomic<uint64_t> triggers_{0};
+    std::atomic<uint64_t> acks_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> last_cancelled_{0};
+    std::atomic<uint64_t> last_latency_ns_{0};
+    std::atomic<uint64_t> max_latency_ns_{0};
+
+    // Internal methods
+    static std::string encode(const std::string& method, const nlohmann::json& params);
+    bool fire(const std::string& encoded);
+};
+
+} // namespace deribit
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+namespace deribit {
+
+/**
+ * @brief Market data pipeline stages with a latency histogram each
+ */
+enum class LatencyStage : uint8_t {
+    ExchangeToReceive,  // Exchange timestamp to frame receipt (offset-corrected wall clock, ms resolution)
+    Parse,              // Frame receipt to JSON parse complete
+    BookApply,          // Frame receipt to book update applied
+    CallbackEntry,      // Frame receipt to user callback entry
+    CallbackDuration,   // User callback entry to return
+    Count
+};
+
+/**
+ * @brief Get the name of a latency stage
+ * @param stage The stage
+ * @return The name
+ */
+const char* toString(LatencyStage stage);
+
+/**
+ * @brief Merged, point-in-time copy of one or more latency histograms
+ */
+class LatencySnapshot {
+public:
+    /**
+     * @brief Add another snapshot's samples into this one
+     * @param other The snapshot to merge
+     */
+    void merge(const LatencySnapshot& other);
+
+    /**
+     * @brief Get the value at a percentile
+     * @param percentile The percentile in [0, 100]
+     * @return The highest value equivalent to the bucket holding the percentile, in nanoseconds
+     */
+    uint64_t percentile(double percentile) const;
+
+    /**
+     * @brief Get the number of samples
+     * @return The count
+     */
+    uint64_t count() const { return count_; }
+
+    /**
+     * @brief Get the largest sample
+     * @return The maximum in nanoseconds
+     */
+    uint64_t max() const { return max_; }
+
+    /**
+     * @brief Get the mean sample
+     * @return The mean in nanoseconds, or 0 if empty
+     */
+    double mean() const { return count_ > 0 ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+    /**
+     * @brief Format count, p50, p99, p99.9 and max on one line
+     * @return The summary, in microseconds
+     */
+    std::string summary() const;
+
+private:
+    friend class LatencyHistogram;
+
+    std::vector<uint64_t> buckets_;
+    uint64_t count_{0};
+    uint64_t sum_{0};
+    uint64_t max_{0};
+};
+
+/**
+ * @brief Log-linear latency histogram in the style of HdrHistogram
+ *
+ * Each power of two is split into 32 linear sub-buckets, so any value from
+ * 1ns to about 36 minutes is kept within ~3% relative error in fixed
+ * memory. Recording is wait-free but single-writer: counters are relaxed
+ * atomics updated without read-modify-write instructions, and concurrent
+ * snapshots may observe a sample in the count but not yet in the max.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr unsigned kMaxValueBits = 41;
+    static constexpr size_t kBucketCount =
+        (kMaxValueBits - kSubBucketBits) * (size_t(1) << kSubBucketBits) + (size_t(1) << kSubBucketBits);
+
+    /**
+     * @brief Record one sample; must only be called from the owning thread
+     * @param nanoseconds The latency
+     */
+    void record(uint64_t nanoseconds) {
+        bump(buckets_[bucketOf(nanoseconds)], 1);
+        bump(count_, 1);
+        bump(sum_, nanoseconds);
+        if (nanoseconds > max_.load(std::memory_order_relaxed)) {
+            max_.store(nanoseconds, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Add this histogram's samples into a snapshot
+     * @param snapshot The snapshot to merge into
+     */
+    void mergeInto(LatencySnapshot& snapshot) const;
+
+    /**
+     * @brief Get the bucket a value falls in
+     * @param value The value
+     * @return The bucket index
+     */
+    static size_t bucketOf(uint64_t value);
+
+    /**
+     * @brief Get the highest value that falls in a bucket
+     * @param bucket The bucket index
+     * @return The value
+     */
+    static uint64_t highestValueOf(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Set of latency series recorded into per-thread histograms
+ *
+ * Each recording thread gets its own histograms on first use, so record()
+ * never contends with other threads. snapshot() merges all threads' copies
+ * of a series. Histograms outlive their threads and keep their samples.
+ */
+class LatencyRecorder {
+public:
+    /**
+     * @brief Constructor
+     * @param series The number of independent series
+     */
+    explicit LatencyRecorder(size_t series);
+
+    /**
+     * @brief Record one sample into the calling thread's histogram
+     * @param series The series index
+     * @param nanoseconds The latency
+     */
+    void record(size_t series, uint64_t nanoseconds);
+
+    /**
+     * @brief Record the time elapsed since a start point
+     * @param series The series index
+     * @param start The start point
+     */
+    void recordSince(size_t series, std::chrono::steady_clock::time_point start) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        record(series, static_cast<uint64_t>(std::max<int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), 0)));
+    }
+
+    /**
+     * @brief Merge every thread's histogram of a series
+     * @param series The series index
+     * @return The merged snapshot
+     */
+    LatencySnapshot snapshot(size_t series) const;
+
+    /**
+     * @brief Get the number of series
+     * @return The count
+     */
+    size_t size() const { return series_; }
+
+private:
+    using ThreadHistograms = std::vector<std::unique_ptr<LatencyHistogram>>;
+
+    size_t series_;
+    uint64_t id_;
+    std::vector<std::unique_ptr<ThreadHistograms>> threads_;
+    mutable std::mutex mutex_;
+
+    // Internal methods
+    ThreadHistograms& local();
+};
+
+} // namespace deribit
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace deribit {
+
+/**
+ * @brief Severity of a log record
+ */
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+/**
+ * @brief Get the name of a log level
+ * @param level The level
+ * @return The name (e.g., "INFO")
+ */
+const char* toString(LogLevel level);
+
+/**
+ * @brief Per call site state, created once by the DERIBIT_LOG macros
+ *
+ * Holds the site's level and its rate limiting window.
+ */
+struct LogSite {
+    LogLevel level;
+    std::atomic<int64_t> window{0};
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint64_t> suppressed{0};
+};
+
+/**
+ * @brief Argument types carried by a log record
+ */
+enum class LogArgType : uint8_t {
+    Bool,
+    Int,
+    UInt,
+    Double,
+    Text,
+    TruncatedText
+};
+
+/**
+ * @brief Fixed-size binary log record: format string, timestamp and raw arguments
+ *
+ * The format must be a string literal; only its address is stored. Strings
+ * passed as arguments are copied into a small inline buffer and truncated
+ * when it runs out, so recording never allocates.
+ */
+struct LogRecord {
+    static constexpr size_t kMaxArgs = 8;
+    static constexpr size_t kTextCapacity = 192;
+
+    const char* format;    // "{}" placeholders are replaced by the arguments in order
+    LogLevel level;
+    int64_t timestamp_ns;  // Wall clock, nanoseconds since epoch
+    uint64_t suppressed;   // Records from this site dropped by the rate limit since the last one
+    uint8_t arg_count;
+    uint8_t text_used;
+    LogArgType types[kMaxArgs];
+    union Value {
+        bool b;
+        int64_t i;
+        uint64_t u;
+        double d;
+        struct {
+            uint8_t offset;
+            uint8_t length;
+        } text;
+    } values[kMaxArgs];
+    char text[kTextCapacity];
+
+    /**
+     * @brief Append one argument; arguments past kMaxArgs are ignored
+     * @param value The argument
+     */
+    template <typename T>
+    void append(const T& value) {
+        if (arg_count >= kMaxArgs) {
+            return;
+        }
+        using Type = std::decay_t<T>;
+        Value& slot = values[arg_count];
+        if constexpr (std::is_same_v<Type, bool>) {
+            types[arg_count] = LogArgType::Bool;
+            slot.b = value;
+        } else if constexpr (std::is_enum_v<Type>) {
+            types[arg_count] = LogArgType::Int;
+            slot.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+            types[arg_count] = LogArgType::Int;
+            slot.i = value;
+        } else if constexpr (std::is_integral_v<Type>) {
+            types[arg_count] = LogArgType::UInt;
+            slot.u = value;
+        } else if constexpr (std::is_floating_point_v<Type>) {
+            types[arg_count] = LogArgType::Double;
+            slot.d = static_cast<double>(value);
+        } else if constexpr (std::is_array_v<T>) {
+            appendText(std::string_view(value));
+            return;
+        } else if constexpr (std::is_pointer_v<Type>) {
+            appendText(value ? std::string_view(value) : std::string_view("(null)"));
+            return;
+        } else {
+            appendText(std::string_view(value));
+            return;
+        }
+        ++arg_count;
+    }
+
+private:
+    void appendText(std::string_view value) {
+        size_t length = std::min(value.size(), kTextCapacity - text_used);
+        types[arg_count] = length < value.size() ? LogArgType::TruncatedText : LogArgType::Text;
+        values[arg_count].text.offset = text_used;
+        values[arg_count].text.length = static_cast<uint8_t>(length);
+        std::memcpy(text + text_used, value.data(), length);
+        text_used = static_cast<uint8_t>(text_used + length);
+        ++arg_count;
+    }
+};
+
+/**
+ * @brief Single-producer, single-consumer ring of log records
+ *
+ * The producer claims a slot, fills it in place and publishes it by
+ * advancing the head with release semantics; the consumer releases slots
+ * back by advancing the tail. Neither side ever blocks.
+ */
+class LogRing {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Records held; rounded up to a power of two
+     */
+    explicit LogRing(size_t capacity);
+
+    /**
+     * @brief Claim the next free slot; producer thread only
+     * @return The slot, or nullptr if the ring is full
+     */
+    LogRecord* claim() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ > mask_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ > mask_) {
+                return nullptr;
+            }
+        }
+        return &records_[head & mask_];
+    }
+
+    /**
+     * @brief Publish the slot returned by claim(); producer thread only
+     */
+    void publish() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /**
+     * @brief Copy out up to max published records; consumer thread only
+     * @param out Receives the records
+     * @param max The most records to take
+     * @return The number of records taken
+     */
+    size_t drain(std::vector<LogRecord>& out, size_t max);
+
+private:
+    std::unique_ptr<LogRecord[]> records_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t cached_tail_{0};  // Producer's last view of tail_
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+/**
+ * @brief Process-wide asynchronous logger
+ *
+ * Hot threads encode a format string address and raw arguments into their own
+ * ring, which costs tens of nanoseconds and never touches a stream. A
+ * background thread merges the rings in timestamp order, formats the
+ * records and writes them, warnings and errors to stderr and the rest to
+ * stdout. Each call site is rate limited per second; when a ring is full
+ * the record is dropped and counted rather than blocking the caller.
+ */
+class Logger {
+public:
+    static constexpr size_t kRingCapacity = 2048;
+
+    /**
+     * @brief Get the process-wide logger, starting its thread on first use
+     * @return The logger
+     */
+    static Logger& instance();
+
+    /**
+     * @brief Check if records at a level are currently emitted
+     * @param level The level
+     * @return true if enabled, false otherwise
+     */
+    bool isEnabled(LogLevel level) const { return level >= level_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Record a statement; use the DERIBIT_LOG macros rather than calling this directly
+     * @param site The call site
+     * @param format The format string literal
+     * @param args The arguments, one per "{}" in the format
+     */
+    template <typename... Args>
+    void log(LogSite& site, const char* format, const Args&... args) {
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        uint64_t suppressed = 0;
+        if (!admit(site, now, suppressed)) {
+            return;
+        }
+
+        LogRing& ring = local();
+        LogRecord* record = ring.claim();
+        if (record == nullptr) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        record->format = format;
+        record->level = site.level;
+        record->timestamp_ns = now;
+        record->suppressed = suppressed;
+        record->arg_count = 0;
+        record->text_used = 0;
+        (record->append(args), ...);
+        ring.publish();
+    }
+
+    /**
+     * @brief Set the minimum level emitted
+     * @param level The level; LogLevel::Off silences everything
+     */
+    void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the minimum level emitted
+     * @return The level
+     */
+    LogLevel getLevel() const { return level_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set how many records each call site may emit per second
+     * @param per_second The limit, or 0 for no limit
+     */
+    void setRateLimit(uint32_t per_second) { rate_limit_.store(per_second, std::memory_order_relaxed); }
+
+    /**
+     * @brief Block until every record logged before the call has been written
+     */
+    void flush();
+
+    /**
+     * @brief Write out everything queued and stop the logger thread; called at exit
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of records dropped because a ring was full
+     * @return The count
+     */
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<LogLevel> level_{LogLevel::Info};
+    std::atomic<uint32_t> rate_limit_{1000};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::vector<std::unique_ptr<LogRing>> rings_;
+    std::mutex rings_mutex_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_{false};
+    uint64_t flush_requested_{0};
+    uint64_t flush_completed_{0};
+
+    // Owned by the logger thread
+    std::vector<LogRecord> batch_;
+    std::string out_;
+    std::string err_;
+    uint64_t reported_dropped_{0};
+
+    Logger();
+
+    // Internal methods
+    LogRing& local() {
+        thread_local LogRing* ring = nullptr;
+        if (ring == nullptr) {
+            ring = addRing();
+        }
+        return *ring;
+    }
+    LogRing* addRing();
+    bool admit(LogSite& site, int64_t now_ns, uint64_t& suppressed);
+    bool drainOnce();
+    void run();
+};
+
+} // namespace deribit
+
+/**
+ * @brief Log a statement if its level is enabled; arguments are not evaluated otherwise
+ *
+ * Usage: DERIBIT_LOG(deribit::LogLevel::Info, "Order {} filled at {}", order_id, price);
+ */
+#define DERIBIT_LOG(level, ...)                                                            \
+    do {                                                                                   \
+        if (::deribit::Logger::instance().isEnabled(level)) {                              \
+            static ::deribit::LogSite deribit_log_site_{level};                            \
+            ::deribit::Logger::instance().log(deribit_log_site_, __VA_ARGS__);             \
+        }                                                                                  \
+    } while (false)
+
+#define DERIBIT_LOG_DEBUG(...) DERIBIT_LOG(::deribit::LogLevel::Debug, __VA_ARGS__)
+#define DERIBIT_LOG_INFO(...) DERIBIT_LOG(::deribit::LogLevel::Info, __VA_ARGS__)
+#define DERIBIT_LOG_WARN(...) DERIBIT_LOG(::deribit::LogLevel::Warn, __VA_ARGS__)
+#define DERIBIT_LOG_ERROR(...) DERIBIT_LOG(::deribit::LogLevel::Error, __VA_ARGS__)
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <cstdint>
+
+namespace deribit {
+
+/**
+ * @brief Label name/value pairs of one metric series
+ */
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @brief Monotonically increasing count, safe to bump from any thread
+ */
+class Counter {
+public:
+    /**
+     * @brief Add to the counter
+     * @param amount The increment
+     */
+    void inc(uint64_t amount = 1) { value_.fetch_add(amount, std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the current value
+     * @return The value
+     */
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+/**
+ * @brief Value that can go up and down, safe to update from any thread
+ */
+class Gauge {
+public:
+    /**
+     * @brief Set the gauge
+     * @param value The new value
+     */
+    void set(double value) { value_.store(value, std::memory_order_relaxed); }
+
+    /**
+     * @brief Add to the gauge
+     * @param amount The increment, negative to decrease
+     */
+    void add(double amount) {
+        double current = value_.load(std::memory_order_relaxed);
+        while (!value_.compare_exchange_weak(current, current + amount, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Get the current value
+     * @return The value
+     */
+    double value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value_{0.0};
+};
+
+/**
+ * @brief Prometheus histogram with fixed bucket upper bounds
+ */
+class Histogram {
+public:
+    /**
+     * @brief Constructor
+     * @param bounds Bucket upper bounds in increasing order; +Inf is implicit
+     */
+    explicit Histogram(std::vector<double> bounds);
+
+    /**
+     * @brief Record an observation
+     * @param value The observed value
+     */
+    void observe(double value);
+
+    /**
+     * @brief Get the bucket upper bounds
+     * @return The bounds, without +Inf
+     */
+    const std::vector<double>& bounds() const { return bounds_; }
+
+    /**
+     * @brief Get the non-cumulative count of a bucket
+     * @param bucket The bucket index; bounds().size() is the +Inf bucket
+     * @return The count
+     */
+    uint64_t bucketCount(size_t bucket) const { return counts_[bucket].load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the sum of all observations
+     * @return The sum
+     */
+    double sum() const { return sum_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<double> sum_{0.0};
+};
+
+/**
+ * @brief Registry of named metrics rendered in Prometheus text format
+ *
+ * Hot paths resolve a metric once at startup and keep the reference, which
+ * stays valid for the registry's lifetime; updates are then relaxed atomics
+ * with no lookup. Values that already live elsewhere (queue depths,
+ * connection counts) are registered as callbacks and only read at scrape
+ * time, on the scraping thread.
+ */
+class MetricsRegistry {
+public:
+    enum class Type {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    /**
+     * @brief Get or create a counter
+     * @param name The metric name (e.g., "deribit_messages_total")
+     * @param help The help text
+     * @param labels The series labels
+     * @return The counter
+     */
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /**
+     * @brief Get or create a gauge
+     * @param name The metric name
+     * @param help The help text
+     * @param labels The series labels
+     * @return The gauge
+     */
+    Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /**
+     * @brief Get or create a histogram
+     * @param name The metric name
+     * @param help The help text
+     * @param bounds Bucket upper bounds, used only when the series is created
+     * @param labels The series labels
+     * @return The histogram
+     */
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::vector<double>& bounds, const MetricLabels& labels = {});
+
+    /**
+     * @brief Register a counter or gauge whose value is read at scrape time
+     * @param name The metric name
+     * @param help The help text
+     * @param type Counter or Gauge
+     * @param read Returns the current value; called from the scraping thread
+     * @param labels The series labels
+     */
+    void callback(const std::string& name, const std::string& help, Type type,
+                  std::function<double()> read, const MetricLabels& labels = {});
+
+    /**
+     * @brief Render every metric in Prometheus text exposition format 0.0.4
+     * @return The exposition
+     */
+    std::string render() const;
+
+private:
+    struct Series {
+        std::string labels;  // Rendered label set without braces, e.g. channel="book"
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> read;
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Type type;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    std::vector<std::unique_ptr<Family>> families_;
+    std::unordered_map<std::string, Family*> families_by_name_;
+    mutable std::mutex mutex_;
+
+    // Internal methods
+    Series& series(const std::string& name, const std::string& help, Type type, const MetricLabels& labels);
+    static std::string renderLabels(const MetricLabels& labels);
+};
+
+} // namespace deribit
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <thread>
+#include <memory>
+#include <cstdint>
+
+#define ASIO_STANDALONE
+#include <asio.hpp>
+
+#include "deribit/metrics.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Minimal HTTP listener serving a metrics registry on localhost
+ *
+ * Runs its own I/O thread and answers GET /metrics with the registry in
+ * Prometheus text format. Rendering happens on that thread, so a scrape
+ * never runs on or blocks a trading thread.
+ */
+class MetricsServer {
+public:
+    /**
+     * @brief Constructor
+     * @param registry The registry to serve
+     * @param port The TCP port to listen on, bound to 127.0.0.1
+     */
+    MetricsServer(const MetricsRegistry& registry, uint16_t port);
+
+    /**
+     * @brief Destructor
+     */
+    ~MetricsServer();
+
+    /**
+     * @brief Bind the port and start the I/O thread
+     * @return true if the listener started, false otherwise
+     */
+    bool start();
+
+    /**
+     * @brief Stop accepting, close open connections and join the I/O thread
+     */
+    void stop();
+
+    /**
+     * @brief Check if the listener is running
+     * @return true if running, false otherwise
+     */
+    bool isRunning() const { return running_; }
+
+private:
+    const MetricsRegistry& registry_;
+    uint16_t port_;
+    asio::io_context io_context_;
+    asio::ip::tcp::acceptor acceptor_;
+    std::thread thread_;
+    bool running_{false};
+
+    // Internal methods
+    void accept();
+    std::string handle(const std::string& request) const;
+};
+
+} // namespace deribit
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include "deribit/instrument.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Black-76 implied volatility and greeks of one option
+ *
+ * Greeks are in USD per unit of underlying: vega per vol point (1%) and
+ * theta per calendar day.
+ */
+struct OptionGreeks {
+    double implied_vol{0.0};
+    double forward{0.0};
+    double delta{0.0};
+    double gamma{0.0};
+    double vega{0.0};
+    double theta{0.0};
+};
+
+/**
+ * @brief Throughput counters of the options engine
+ */
+struct OptionsEngineStats {
+    uint64_t options{0};              // Options across all chains
+    uint64_t iv_solves{0};            // Implied vols solved
+    uint64_t greeks_updates{0};       // Option greeks recomputed
+    uint64_t last_batch_size{0};      // Options in the last index-move recompute
+    uint64_t last_batch_ns{0};        // Duration of the last index-move recompute
+    double options_per_second{0.0};   // Throughput of the last index-move recompute
+};
+
+/**
+ * @brief Black-76 implied vol and greeks over options chains in structure-of-arrays form
+ *
+ * Each underlying has its own chain whose fields live in separate contiguous
+ * arrays. Option price updates are queued, gathered into one batch and solved
+ * and repriced by recompute() in straight-line loops over the batch, which
+ * vectorize where the build provides vector math routines (see
+ * options_kernels.cpp).
+ * An index move shifts every forward of its chain by the last observed basis
+ * and refreshes greeks at the cached vols without solving again.
+ *
+ * Deribit options are quoted in units of the underlying; the USD premium is
+ * price * forward. Rates are taken as zero, as in Deribit's own pricing.
+ */
+class OptionsEngine {
+public:
+    /**
+     * @brief Constructor
+     */
+    OptionsEngine() = default;
+
+    /**
+     * @brief Add an option to its underlying's chain
+     * @param instrument The option's reference data
+     * @return true if added, false if not an option or already present
+     */
+    bool addOption(const Instrument& instrument);
+
+    /**
+     * @brief Queue a new option price for the next recompute
+     * @param instrument_name The option name
+     * @param price The option price in units of the underlying
+     * @param underlying_price The forward for the option's expiry, or 0 to derive it from the index
+     * @return true if the option is in a chain, false otherwise
+     */
+    bool updateOptionPrice(const std::string& instrument_name, double price, double underlying_price);
+
+    /**
+     * @brief Solve implied vols and greeks for all queued option prices
+     * @param timestamp Milliseconds since epoch, used for time to expiry
+     * @return The number of options solved
+     */
+    size_t recompute(int64_t timestamp);
+
+    /**
+     * @brief Apply an index move and refresh greeks across the underlying's chain
+     * @param currency The underlying currency (e.g., "BTC")
+     * @param index_price The new index price
+     * @param timestamp Milliseconds since epoch, used for time to expiry
+     * @return The number of options recomputed
+     */
+    size_t updateIndex(const std::string& currency, double index_price, int64_t timestamp);
+
+    /**
+     * @brief Get the latest implied vol and greeks of an option
+     * @param instrument_name The option name
+     * @param greeks The greeks, if found
+     * @return true if the option has been priced, false otherwise
+     */
+    bool getGreeks(const std::string& instrument_name, OptionGreeks& greeks) const;
+
+    /**
+     * @brief Get the throughput counters
+     * @return The current counters
+     */
+    OptionsEngineStats getStats() const;
+
+private:
+    struct Chain {
+        std::string currency;
+        double index_price{0.0};
+
+        // Inputs
+        std::vector<double> strike;
+        std::vector<double> expiry_ms;
+        std::vector<double> is_call;   // 1.0 for calls, 0.0 for puts
+        std::vector<double> price;     // In units of the underlying
+        std::vector<double> basis;     // Forward / index; 0 until an index is seen
+
+        // Outputs
+        std::vector<double> forward;
+        std::vector<double> vol;       // 0 until solved
+        std::vector<double> delta;
+        std::vector<double> gamma;
+        std::vector<double> vega;
+        std::vector<double> theta;
+
+        std::vector<uint8_t> queued;
+        std::vector<uint32_t> pending;  // Slots with a price awaiting recompute
+    };
+
+    struct Slot {
+        uint32_t chain;
+        uint32_t index;
+    };
+
+    std::vector<Chain> chains_;
+    std::unordered_map<std::string, Slot> slots_;
+
+    // Gathered inputs, solver scratch and outputs of one implied vol batch
+    std::vector<uint32_t> batch_slots_;
+    std::vector<double> batch_forward_;
+    std::vector<double> batch_strike_;
+    std::vector<double> batch_expiry_ms_;
+    std::vector<double> batch_years_;
+    std::vector<double> batch_is_call_;
+    std::vector<double> batch_premium_;
+    std::vector<double> batch_log_fk_;
+    std::vector<double> batch_lo_;
+    std::vector<double> batch_hi_;
+    std::vector<double> batch_vol_;
+    std::vector<double> batch_delta_;
+    std::vector<double> batch_gamma_;
+    std::vector<double> batch_vega_;
+    std::vector<double> batch_theta_;
+
+    uint64_t options_{0};
+    uint64_t iv_solves_{0};
+    uint64_t greeks_updates_{0};
+    uint64_t last_batch_size_{0};
+    uint64_t last_batch_ns_{0};
+    mutable std::mutex mutex_;
+
+    // Internal methods
+    Chain* findChain(const std::string& currency);
+};
+
+} // namespace deribit
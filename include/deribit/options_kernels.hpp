@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+namespace deribit {
+
+constexpr double kMsPerYear = 365.0 * 24.0 * 3600.0 * 1000.0;
+constexpr double kMinYears = 1.0 / (365.0 * 24.0 * 60.0);  // One minute
+
+/**
+ * @brief Black-76 greeks at zero rates over structure-of-arrays inputs
+ *
+ * Options with no solved vol (0) are evaluated at the minimum vol.
+ *
+ * @param n The number of options
+ * @param now_ms The valuation time in milliseconds
+ * @param strike The strikes
+ * @param expiry_ms The expiry timestamps in milliseconds
+ * @param is_call 1.0 for calls, 0.0 for puts
+ * @param forward The forwards
+ * @param vol The implied vols
+ * @param delta Output deltas
+ * @param gamma Output gammas
+ * @param vega Output vegas per vol point
+ * @param theta Output thetas per calendar day
+ */
+void greeksKernel(
+    size_t n,
+    double now_ms,
+    const double* __restrict strike,
+    const double* __restrict expiry_ms,
+    const double* __restrict is_call,
+    const double* __restrict forward,
+    const double* __restrict vol,
+    double* __restrict delta,
+    double* __restrict gamma,
+    double* __restrict vega,
+    double* __restrict theta);
+
+/**
+ * @brief Black-76 implied vols at zero rates over structure-of-arrays inputs
+ *
+ * @param n The number of options
+ * @param forward The forwards
+ * @param strike The strikes
+ * @param years Years to expiry; overwritten with their square roots
+ * @param is_call 1.0 for calls, 0.0 for puts
+ * @param premium USD premiums; overwritten with the time values
+ * @param log_fk Scratch of n doubles
+ * @param lo Scratch of n doubles
+ * @param hi Scratch of n doubles
+ * @param vol Output vols, 0 where no vol reproduces the premium
+ */
+void impliedVolKernel(
+    size_t n,
+    const double* __restrict forward,
+    const double* __restrict strike,
+    double* __restrict years,
+    const double* __restrict is_call,
+    double* __restrict premium,
+    double* __restrict log_fk,
+    double* __restrict lo,
+    double* __restrict hi,
+    double* __restrict vol);
+
+} // namespace deribit
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 
 namespace deribit {
@@ -123,6 +124,14 @@ public:
      */
     bool isCancelled() const { return order_state_ == "cancelled"; }
     
+    /**
+     * @brief Apply a fill reported on the user.trades channel
+     * @param amount The traded amount
+     * @param price The trade price
+     * @param timestamp The trade timestamp
+     */
+    void applyTrade(double amount, double price, int64_t timestamp);
+    
     /**
      * @brief Convert the order to JSON
      * @return The JSON representation
@@ -144,4 +153,28 @@ private:
     int64_t last_update_timestamp_{0};
 };
 
+/**
+ * @brief Encode a private/buy or private/sell JSON-RPC request for the WebSocket
+ * @param method The method ("private/buy" or "private/sell")
+ * @param request_id The JSON-RPC id
+ * @param instrument_name The instrument name (e.g., "BTC-PERPETUAL")
+ * @param amount The amount
+ * @param type The order type (e.g., "market", "limit"); the price is only sent for limit orders
+ * @param price The price for limit orders
+ * @param label The label carrying the client order id
+ * @param access_token The access token
+ * @param reduce_only Whether the order may only reduce the position
+ * @return The encoded request
+ */
+std::string encodeOrderRequest(
+    const std::string& method,
+    uint64_t request_id,
+    const std::string& instrument_name,
+    double amount,
+    const std::string& type,
+    double price,
+    const std::string& label,
+    const std::string& access_token,
+    bool reduce_only = false);
+
 } // namespace deribit 
\ No newline at end of file
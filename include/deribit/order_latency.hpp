@@ -0,0 +1,156 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "deribit/order.hpp"
+#include "deribit/latency_histogram.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Order entry methods timed by the order latency tracker
+ */
+enum class OrderMethod : uint8_t {
+    Buy,
+    Sell,
+    Edit,
+    Cancel,
+    Count
+};
+
+/**
+ * @brief Path an order request took to the exchange
+ */
+enum class OrderTransport : uint8_t {
+    WebSocket,
+    Rest,
+    Count
+};
+
+/**
+ * @brief Intervals measured for every order request
+ */
+enum class OrderLatencyMetric : uint8_t {
+    EncodeToWrite,  // Request encode to hand-off to the socket or HTTP client
+    SendToAck,      // Hand-off to the JSON-RPC response (success or error)
+    SendToFill,     // Hand-off to the first fill, from the response or user.orders
+    Count
+};
+
+/**
+ * @brief Get the name of an order method
+ * @param method The method
+ * @return The name
+ */
+const char* toString(OrderMethod method);
+
+/**
+ * @brief Get the name of an order transport
+ * @param transport The transport
+ * @return The name
+ */
+const char* toString(OrderTransport transport);
+
+/**
+ * @brief Get the name of an order latency metric
+ * @param metric The metric
+ * @return The name
+ */
+const char* toString(OrderLatencyMetric metric);
+
+/**
+ * @brief Round-trip latency of order requests from encode to ack to first fill
+ *
+ * Each request is stamped at encode and at write, then matched against its
+ * JSON-RPC response by request key and against later user.orders updates by
+ * order id, or by label when the update beats the response. Samples go into
+ * per-thread histograms per method, transport and metric.
+ */
+class OrderLatencyTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Keys for requests without a JSON-RPC id of their own (REST calls)
+    static constexpr uint64_t kLocalKeyBase = uint64_t(1) << 48;
+
+    /**
+     * @brief Constructor
+     */
+    OrderLatencyTracker();
+
+    /**
+     * @brief Reserve a key for a request that has no JSON-RPC id
+     * @return A key that never collides with WebSocket request ids
+     */
+    uint64_t nextLocalKey();
+
+    /**
+     * @brief Record that a request was written
+     * @param key The JSON-RPC request id or a local key
+     * @param method The order method
+     * @param transport The transport used
+     * @param encoded When encoding of the request started
+     * @param written When the request was handed to the transport
+     * @param label The order label, if any, for matching fills that beat the response
+     */
+    void onSent(uint64_t key, OrderMethod method, OrderTransport transport,
+                Clock::time_point encoded, Clock::time_point written, const std::string& label = "");
+
+    /**
+     * @brief Match a JSON-RPC response to its request
+     * @param key The JSON-RPC request id or local key
+     * @param response The full response, with "result" or "error"
+     */
+    void onAck(uint64_t key, const nlohmann::json& response);
+
+    /**
+     * @brief Match an order update to an acknowledged or in-flight request
+     * @param order The order from user.orders
+     */
+    void onOrder(const Order& order);
+
+    /**
+     * @brief Get a merged latency histogram
+     * @param method The order method
+     * @param transport The transport
+     * @param metric The metric
+     * @return The snapshot across all recording threads
+     */
+    LatencySnapshot getLatency(OrderMethod method, OrderTransport transport, OrderLatencyMetric metric) const;
+
+    /**
+     * @brief Log every non-empty histogram's p50/p99/p99.9/max
+     */
+    void printReport() const;
+
+private:
+    struct Pending {
+        OrderMethod method;
+        OrderTransport transport;
+        Clock::time_point written;
+        std::string label;
+        bool filled{false};
+    };
+
+    // Stale requests and resting orders are pruned past these limits
+    static constexpr size_t kMaxPending = 10000;
+    static constexpr std::chrono::minutes kMaxPendingAge{60};
+
+    LatencyRecorder recorder_;
+    std::unordered_map<uint64_t, Pending> inflight_;
+    std::unordered_map<std::string, uint64_t> inflight_by_label_;
+    std::unordered_map<std::string, Pending> awaiting_fill_;
+    uint64_t next_local_key_{kLocalKeyBase};
+    mutable std::mutex mutex_;
+
+    // Internal methods
+    void record(const Pending& pending, OrderLatencyMetric metric, Clock::time_point start, Clock::time_point end);
+    void prune(Clock::time_point now);
+    static size_t seriesOf(OrderMethod method, OrderTransport transport, OrderLatencyMetric metric);
+};
+
+} // namespace deribit
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <shared_mutex>
+#include <atomic>
+#include <nlohmann/json.hpp>
+#include "deribit/order.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Local order cache kept live from the user.orders and user.trades channels
+ *
+ * Orders are indexed by order id, label and instrument so that working
+ * orders can be answered from memory. Periodic REST snapshots reconcile
+ * anything missed while the subscription was down.
+ */
+class OrderStore {
+public:
+    /**
+     * @brief Constructor
+     */
+    OrderStore() = default;
+
+    /**
+     * @brief Insert or update an order from a user.orders notification
+     * @param order The order state
+     */
+    void applyOrder(const Order& order);
+
+    /**
+     * @brief Apply a fill from a user.trades notification
+     * @param trade The trade JSON
+     */
+    void applyTrade(const nlohmann::json& trade);
+
+    /**
+     * @brief Reconcile against a REST snapshot of open orders for one currency
+     *
+     * Orders in the snapshot are upserted; open orders of the currency that
+     * are missing from it and were last updated before the snapshot was
+     * requested are dropped.
+     *
+     * @param currency The currency the snapshot was requested for
+     * @param open_orders The open orders returned by the API
+     * @param requested_at Wall-clock time in milliseconds when the snapshot was requested
+     */
+    void reconcile(
+        const std::string& currency,
+        const std::vector<Order>& open_orders,
+        int64_t requested_at);
+
+    /**
+     * @brief Get the open orders
+     * @param instrument_name Optional instrument name to filter by
+     * @return The open orders
+     */
+    std::vector<Order> getOpenOrders(const std::string& instrument_name = "") const;
+
+    /**
+     * @brief Find an order by exchange order id
+     * @param order_id The order id
+     * @param order Receives the order if found
+     * @return true if found, false otherwise
+     */
+    bool findOrder(const std::string& order_id, Order& order) const;
+
+    /**
+     * @brief Find the most recent order carrying a label
+     * @param label The order label
+     * @param order Receives the order if found
+     * @return true if found, false otherwise
+     */
+    bool findOrderByLabel(const std::string& label, Order& order) const;
+
+    /**
+     * @brief Check if the store is authoritative (subscribed and reconciled)
+     * @return true if live, false otherwise
+     */
+    bool isLive() const { return is_live_; }
+
+    /**
+     * @brief Mark the store as authoritative or not
+     * @param live Whether the store is live
+     */
+    void setLive(bool live) { is_live_ = live; }
+
+    /**
+     * @brief Drop every order
+     */
+    void clear();
+
+private:
+    // Closed orders kept for id/label lookups
+    static constexpr size_t kMaxClosedOrders = 10000;
+
+    std::unordered_map<std::string, Order> orders_;
+    std::unordered_map<std::string, std::string> order_id_by_label_;
+    std::unordered_map<std::string, std::unordered_set<std::string>> open_by_instrument_;
+    std::deque<std::string> closed_orders_;
+    mutable std::shared_mutex mutex_;
+    std::atomic<bool> is_live_{false};
+
+    // Internal methods (mutex held)
+    void upsert(const Order& order);
+    void erase(const std::string& order_id);
+};
+
+} // namespace deribit
@@ -63,6 +63,24 @@ public:
      */
     int64_t getTimestamp() const { return timestamp_; }
     
+    /**
+     * @brief Get the estimated time the last update spent between the exchange and us
+     * @return The wire latency in nanoseconds, or 0 if the book did not come from the WebSocket
+     */
+    int64_t getWireLatency() const { return wire_latency_ns_; }
+    
+    /**
+     * @brief Set the estimated wire latency of the last update
+     * @param latency_ns The wire latency in nanoseconds
+     */
+    void setWireLatency(int64_t latency_ns) { wire_latency_ns_ = latency_ns; }
+    
+    /**
+     * @brief Get the exchange change id of the last update applied
+     * @return The change id, or 0 if the book did not come from a book.* subscription
+     */
+    int64_t getChangeId() const { return change_id_; }
+    
     /**
      * @brief Get the bids
      * @return The bids
@@ -101,6 +119,10 @@ public:
     
     /**
      * @brief Update the orderbook with new data
+     *
+     * Levels may be given as [price, amount] or in Deribit's incremental
+     * ["new"|"change"|"delete", price, amount] form.
+     *
      * @param json The JSON data
      */
     void update(const nlohmann::json& json);
@@ -114,6 +136,8 @@ public:
 private:
     std::string instrument_name_;
     int64_t timestamp_{0};
+    int64_t wire_latency_ns_{0};
+    int64_t change_id_{0};
     std::vector<PriceLevel> bids_;
     std::vector<PriceLevel> asks_;
 };
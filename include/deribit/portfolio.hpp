@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+
+/**
+ * @brief Account summary for one currency, as pushed on user.portfolio
+ */
+class Portfolio {
+public:
+    /**
+     * @brief Constructor
+     */
+    Portfolio() = default;
+
+    /**
+     * @brief Constructor from JSON
+     * @param json The JSON data
+     */
+    explicit Portfolio(const nlohmann::json& json);
+
+    /**
+     * @brief Get the currency
+     * @return The currency (e.g., "BTC")
+     */
+    const std::string& getCurrency() const { return currency_; }
+
+    /**
+     * @brief Get the account equity
+     * @return The equity
+     */
+    double getEquity() const { return equity_; }
+
+    /**
+     * @brief Get the account balance
+     * @return The balance
+     */
+    double getBalance() const { return balance_; }
+
+    /**
+     * @brief Get the funds available for trading
+     * @return The available funds
+     */
+    double getAvailableFunds() const { return available_funds_; }
+
+    /**
+     * @brief Get the margin balance
+     * @return The margin balance
+     */
+    double getMarginBalance() const { return margin_balance_; }
+
+    /**
+     * @brief Get the initial margin
+     * @return The initial margin
+     */
+    double getInitialMargin() const { return initial_margin_; }
+
+    /**
+     * @brief Get the maintenance margin
+     * @return The maintenance margin
+     */
+    double getMaintenanceMargin() const { return maintenance_margin_; }
+
+    /**
+     * @brief Get the total profit/loss
+     * @return The total profit/loss
+     */
+    double getTotalPnL() const { return total_pnl_; }
+
+    /**
+     * @brief Get the total delta
+     * @return The total delta
+     */
+    double getDeltaTotal() const { return delta_total_; }
+
+    /**
+     * @brief Convert the portfolio to JSON
+     * @return The JSON representation
+     */
+    nlohmann::json toJson() const;
+
+private:
+    std::string currency_;
+    double equity_{0.0};
+    double balance_{0.0};
+    double available_funds_{0.0};
+    double margin_balance_{0.0};
+    double initial_margin_{0.0};
+    double maintenance_margin_{0.0};
+    double total_pnl_{0.0};
+    double delta_total_{0.0};
+};
+
+} // namespace deribit
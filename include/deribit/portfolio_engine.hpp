@@ -0,0 +1,212 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <limits>
+#include <cstdint>
+#include "deribit/position.hpp"
+#include "deribit/position_store.hpp"
+#include "deribit/instrument_store.hpp"
+#include "deribit/seqlock.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Live valuation of one position
+ *
+ * PnL and margin are in the settlement currency; delta is in units of the
+ * underlying.
+ */
+struct PositionRisk {
+    int64_t timestamp{0};
+    double size{0.0};
+    double average_price{0.0};
+    double mark_price{0.0};
+    double unrealized_pnl{0.0};
+    double delta{0.0};
+    double initial_margin{0.0};
+    double maintenance_margin{0.0};
+};
+
+/**
+ * @brief Live totals over all positions settled in one currency
+ */
+struct PortfolioTotals {
+    int64_t timestamp{0};
+    double index_price{0.0};           // 0 until an index update is seen
+    double unrealized_pnl{0.0};
+    double unrealized_pnl_usd{0.0};    // unrealized_pnl * index_price
+    double delta{0.0};
+    double initial_margin{0.0};
+    double maintenance_margin{0.0};
+    uint32_t positions{0};
+};
+
+/**
+ * @brief Totals and positions of one settlement currency as of a single update
+ */
+struct PortfolioSnapshot {
+    PortfolioTotals totals;
+    std::shared_ptr<const std::vector<std::string>> instruments;  // Parallel to positions
+    std::vector<PositionRisk> positions;
+};
+
+/**
+ * @brief Incremental PnL, delta and margin over the open positions
+ *
+ * Positions come from Position snapshots (REST or user.changes). Each mark
+ * update revalues only its own instrument and folds the difference into the
+ * currency totals. syncPositions() re-sums everything from scratch, which also
+ * clears any floating-point drift in the running totals.
+ *
+ * Positions are valued at the exchange mark price. Book mids are used only
+ * for positions no exchange mark has been seen for, so one row is never
+ * marked alternately from two sources.
+ *
+ * Margin is scaled from the last exchange-reported figure by the position's
+ * exposure: coin notional for inverse futures, quote notional for linear
+ * instruments and contract count for options. Option delta follows the
+ * per-contract delta passed with mark updates, or the reported one.
+ *
+ * Writers serialize on a mutex, and an update touches only its own row and
+ * its currency's totals. Readers copy single positions and totals out of
+ * SeqLock slots without taking that mutex. getSnapshot() copies a currency's
+ * totals and rows together under the mutex, so they always agree; the copy
+ * is reused until the currency next changes.
+ */
+class PortfolioEngine {
+public:
+    /**
+     * @brief Constructor
+     * @param instruments The instrument reference data, used to classify positions
+     */
+    explicit PortfolioEngine(const InstrumentStore& instruments);
+
+    /**
+     * @brief Insert, replace or (when flat) remove one position
+     * @param position The position snapshot
+     */
+    void applyPosition(const Position& position);
+
+    /**
+     * @brief Replace all positions and re-sum the totals from scratch
+     * @param positions The complete set of open positions
+     */
+    void syncPositions(const PositionStore::PositionMap& positions);
+
+    /**
+     * @brief Revalue a position at a new mark price
+     * @param instrument_name The instrument name
+     * @param mark_price The mark price
+     * @param timestamp Milliseconds since epoch
+     * @param option_delta Per-contract delta of an option; NaN keeps the last one
+     * @return true if a position in the instrument is held, false otherwise
+     */
+    bool updateMark(const std::string& instrument_name, double mark_price, int64_t timestamp,
+                    double option_delta = std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * @brief Revalue a position at a book mid until an exchange mark is seen for it
+     * @param instrument_name The instrument name
+     * @param mid The mid price
+     * @param timestamp Milliseconds since epoch
+     * @param option_delta Per-contract delta of an option; NaN keeps the last one
+     * @return true if the position was revalued, false if not held or already exchange-marked
+     */
+    bool updateMid(const std::string& instrument_name, double mid, int64_t timestamp,
+                   double option_delta = std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * @brief Apply a new index price to a currency's totals
+     * @param currency The currency (e.g., "BTC")
+     * @param index_price The index price
+     * @param timestamp Milliseconds since epoch
+     */
+    void updateIndex(const std::string& currency, double index_price, int64_t timestamp);
+
+    /**
+     * @brief Get the live valuation of a position without taking the writer mutex
+     * @param instrument_name The instrument name
+     * @param risk The valuation, if held
+     * @return true if a position in the instrument is held, false otherwise
+     */
+    bool getPositionRisk(const std::string& instrument_name, PositionRisk& risk) const;
+
+    /**
+     * @brief Get the live totals of a currency without taking the writer mutex
+     * @param currency The settlement currency (e.g., "BTC")
+     * @param totals The totals, if any position was ever held in it
+     * @return true if found, false otherwise
+     */
+    bool getTotals(const std::string& currency, PortfolioTotals& totals) const;
+
+    /**
+     * @brief Get a currency's totals and positions as of the same update
+     *
+     * Takes the writer mutex and copies the currency's rows if they changed
+     * since the last call; meant for reporting rather than per-tick reads.
+     *
+     * @param currency The settlement currency (e.g., "BTC")
+     * @return The snapshot, or nullptr if no position was ever held in the currency
+     */
+    std::shared_ptr<const PortfolioSnapshot> getSnapshot(const std::string& currency) const;
+
+private:
+    enum class Exposure {
+        Inverse,  // Sized in USD, settled in the base currency
+        Linear,   // Sized in the base currency, settled in the quote currency
+        Option    // Sized in contracts, priced in the settlement currency
+    };
+
+    using PositionSlot = SeqLock<PositionRisk>;
+    using TotalsSlot = SeqLock<PortfolioTotals>;
+    using PositionSlotMap = std::unordered_map<std::string, std::shared_ptr<PositionSlot>>;
+    using TotalsSlotMap = std::unordered_map<std::string, std::shared_ptr<TotalsSlot>>;
+
+    struct CurrencyTotals {
+        PortfolioTotals value;
+        std::vector<PositionRisk> risks;                        // Indexed by Row::index
+        std::shared_ptr<const std::vector<std::string>> names;  // Replaced when a position opens or closes
+        std::shared_ptr<TotalsSlot> slot;
+        mutable std::shared_ptr<const PortfolioSnapshot> snapshot;  // Built by getSnapshot(), dropped on change
+    };
+
+    struct Row {
+        Exposure exposure{Exposure::Linear};
+        CurrencyTotals* totals{nullptr};
+        size_t index{0};               // Position in the currency's risks and names
+        bool exchange_mark{false};     // Marked by the exchange at least once; mids are ignored
+        double unit_delta{0.0};
+        double initial_rate{0.0};      // Initial margin per unit of exposure
+        double maintenance_rate{0.0};  // Maintenance margin per unit of exposure
+        PositionRisk risk;
+        std::shared_ptr<PositionSlot> slot;
+    };
+
+    const InstrumentStore& instruments_;
+    std::unordered_map<std::string, Row> rows_;
+    std::unordered_map<std::string, CurrencyTotals> totals_;
+    mutable std::mutex mutex_;
+
+    // Read with std::atomic_load, not the writer mutex; replaced only when positions open or close
+    std::shared_ptr<const PositionSlotMap> position_slots_;
+    std::shared_ptr<const TotalsSlotMap> totals_slots_;
+
+    // Internal methods
+    Row& upsert(const Position& position);
+    void remove(const std::string& instrument_name);
+    void revalue(Row& row, double mark_price, int64_t timestamp, double option_delta);
+    void storeRow(Row& row);
+    void reindex();
+    void publishSlots();
+    static void publish(CurrencyTotals& totals);
+    CurrencyTotals& totalsFor(const std::string& currency);
+    static double exposureOf(Exposure exposure, double size, double mark_price);
+    static void value(Row& row);
+    static void fold(PortfolioTotals& totals, const PositionRisk& risk, double sign);
+};
+
+} // namespace deribit
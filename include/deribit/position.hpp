@@ -27,6 +27,12 @@ public:
      */
     const std::string& getInstrumentName() const { return instrument_name_; }
     
+    /**
+     * @brief Get the instrument kind
+     * @return The kind ("future", "option", ...)
+     */
+    const std::string& getKind() const { return kind_; }
+    
     /**
      * @brief Get the size
      * @return The size
@@ -69,6 +75,12 @@ public:
      */
     double getMaintenanceMargin() const { return maintenance_margin_; }
     
+    /**
+     * @brief Get the delta
+     * @return The delta in units of the underlying
+     */
+    double getDelta() const { return delta_; }
+    
     /**
      * @brief Get the unrealized profit/loss
      * @return The unrealized profit/loss
@@ -107,6 +119,7 @@ public:
     
 private:
     std::string instrument_name_;
+    std::string kind_;
     double size_{0.0};
     double average_price_{0.0};
     double liquidation_price_{0.0};
@@ -114,6 +127,7 @@ private:
     double index_price_{0.0};
     double initial_margin_{0.0};
     double maintenance_margin_{0.0};
+    double delta_{0.0};
     double unrealized_pnl_{0.0};
     double realized_pnl_{0.0};
     std::string direction_;
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include "deribit/position.hpp"
+#include "deribit/portfolio.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Live position and portfolio cache fed by user.changes and user.portfolio
+ *
+ * Readers load an immutable snapshot without taking the store's mutex and
+ * look positions up in O(1); the load is std::atomic_load on a shared_ptr,
+ * which standard libraries back with a short internal lock. Each update publishes a new snapshot that shares every untouched
+ * Position with the previous one.
+ */
+class PositionStore {
+public:
+    using PositionPtr = std::shared_ptr<const Position>;
+    using PositionMap = std::unordered_map<std::string, PositionPtr>;
+    using PortfolioPtr = std::shared_ptr<const Portfolio>;
+    using PortfolioMap = std::unordered_map<std::string, PortfolioPtr>;
+
+    /**
+     * @brief Constructor
+     */
+    PositionStore();
+
+    /**
+     * @brief Apply the positions array of a user.changes notification
+     * @param positions The positions JSON array
+     */
+    void applyPositions(const nlohmann::json& positions);
+
+    /**
+     * @brief Apply a user.portfolio notification
+     * @param portfolio The portfolio summary
+     */
+    void applyPortfolio(const Portfolio& portfolio);
+
+    /**
+     * @brief Replace the positions of a currency with a REST snapshot
+     *
+     * Instruments updated by user.changes after the snapshot was requested
+     * keep their streamed position; the snapshot may predate that change.
+     *
+     * @param currency The settlement currency the snapshot was requested for
+     * @param positions The positions returned by the API
+     * @param requested_at Wall-clock time in milliseconds when the snapshot was requested
+     */
+    void reconcile(const std::string& currency, const std::vector<Position>& positions, int64_t requested_at);
+
+    /**
+     * @brief Find the position in an instrument
+     * @param instrument_name The instrument name
+     * @return The position, or nullptr if flat
+     */
+    PositionPtr find(const std::string& instrument_name) const;
+
+    /**
+     * @brief Get every open position
+     * @return The current snapshot
+     */
+    std::shared_ptr<const PositionMap> snapshot() const;
+
+    /**
+     * @brief Get open positions filtered by currency and kind
+     * @param currency The settlement currency (e.g., "BTC", or "USDC" for linear instruments)
+     * @param kind Optional kind (e.g., "future", "option")
+     * @return The positions
+     */
+    std::vector<Position> getPositions(const std::string& currency, const std::string& kind = "") const;
+
+    /**
+     * @brief Get the latest portfolio summary for a currency
+     * @param currency The currency (e.g., "BTC")
+     * @return The portfolio, or nullptr if none received yet
+     */
+    PortfolioPtr getPortfolio(const std::string& currency) const;
+
+    /**
+     * @brief Check if the store is authoritative (subscribed and reconciled)
+     * @return true if live, false otherwise
+     */
+    bool isLive() const { return is_live_; }
+
+    /**
+     * @brief Mark the store as authoritative or not
+     * @param live Whether the store is live
+     */
+    void setLive(bool live) { is_live_ = live; }
+
+private:
+    std::shared_ptr<const PositionMap> positions_;
+    std::shared_ptr<const PortfolioMap> portfolios_;
+    std::mutex update_mutex_;
+    std::unordered_map<std::string, int64_t> updated_at_;  // Wall-clock ms of the last streamed change; update_mutex_ held
+    std::atomic<bool> is_live_{false};
+};
+
+} // namespace deribit
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "deribit/config.hpp"
+#include "deribit/order.hpp"
+#include "deribit/instrument_store.hpp"
+#include "deribit/rate_limiter.hpp"
+#include "deribit/risk_engine.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Desired two-sided quote for one instrument; an amount of 0 pulls that side
+ */
+struct Quote {
+    double bid_price{0.0};
+    double bid_amount{0.0};
+    double ask_price{0.0};
+    double ask_amount{0.0};
+};
+
+/**
+ * @brief Quoting engine counters
+ */
+struct QuoteEngineStats {
+    uint64_t quote_updates{0};     // setQuote/cancelQuotes calls
+    uint64_t orders_sent{0};       // New quote orders sent
+    uint64_t edits_sent{0};        // private/edit requests sent
+    uint64_t cancels_sent{0};      // private/cancel requests sent
+    uint64_t edits_suppressed{0};  // Changes absorbed by the hysteresis band
+    uint64_t throttled{0};         // Sends deferred for lack of rate-limit credits
+    uint64_t risk_rejected{0};     // Sends refused by the risk engine
+    uint64_t acks{0};              // Successful responses
+    uint64_t errors{0};            // Error responses
+    uint64_t in_flight{0};         // Requests awaiting a response
+};
+
+/**
+ * @brief Keeps live two-sided quotes in line with desired quotes
+ *
+ * Callers state the quote they want per instrument. The engine diffs it
+ * against the live orders and sends only the required buys, sells, edits and
+ * cancels, pipelined over the WebSocket without waiting for acks. Each side
+ * has at most one request in flight; later changes are coalesced and sent when
+ * the ack arrives. Price moves inside the hysteresis band are not sent.
+ * Sides deferred for lack of rate-limit credits are retried on the engine's
+ * own thread as soon as a credit is due back.
+ */
+class QuoteEngine {
+public:
+    using SendFunction = std::function<bool(const std::string&)>;
+
+    /**
+     * @brief Constructor
+     * @param config Configuration holding the hysteresis band
+     * @param instruments Instrument reference data for tick and lot sizes
+     * @param rate_limiter Rate limiter for matching-engine requests
+     * @param risk_engine Pre-trade risk checks for new and edited quotes
+     * @param send Function that writes a message to the WebSocket
+     */
+    QuoteEngine(
+        const Config& config,
+        const InstrumentStore& instruments,
+        RateLimiter& rate_limiter,
+        RiskEngine& risk_engine,
+        SendFunction send);
+
+    /**
+     * @brief Destructor
+     */
+    ~QuoteEngine();
+
+    /**
+     * @brief Start the thread that retries deferred sides
+     */
+    void start();
+
+    /**
+     * @brief Stop the retry thread
+     */
+    void stop();
+
+    /**
+     * @brief Set the desired quote for an instrument
+     * @param instrument_name The instrument name
+     * @param quote The desired quote
+     */
+    void setQuote(const std::string& instrument_name, const Quote& quote);
+
+    /**
+     * @brief Pull both sides of an instrument's quote
+     * @param instrument_name The instrument name
+     */
+    void cancelQuotes(const std::string& instrument_name);
+
+    /**
+     * @brief Retry every side whose last send was deferred
+     */
+    void flush();
+
+    /**
+     * @brief Check if a JSON-RPC response belongs to the engine
+     * @param id The response id
+     * @return true if the engine sent the request, false otherwise
+     */
+    static bool ownsRequest(uint64_t id) { return id >= kFirstRequestId; }
+
+    /**
+     * @brief Handle a JSON-RPC response to one of the engine's requests
+     * @param response The response
+     */
+    void onResponse(const nlohmann::json& response);
+
+    /**
+     * @brief Handle a user.orders update
+     * @param order The updated order
+     */
+    void onOrderUpdate(const Order& order);
+
+    /**
+     * @brief Forget live and desired quotes, e.g. after the exchange cancelled them
+     * @param instrument_name Optional instrument; every instrument if empty
+     */
+    void reset(const std::string& instrument_name = "");
+
+    /**
+     * @brief Get the engine counters
+     * @return The current counters
+     */
+    QuoteEngineStats getStats() const;
+
+private:
+    static constexpr uint64_t kFirstRequestId = 1000000;
+
+    enum Side { Bid = 0, Ask = 1 };
+
+    struct QuoteSide {
+        double desired_price{0.0};
+        double desired_amount{0.0};
+        std::string order_id;        // Empty when no order is resting
+        double live_price{0.0};
+        double live_amount{0.0};
+        uint64_t pending_id{0};      // Id of the request in flight, 0 if none
+        bool dirty{false};           // Desired state not yet sent
+    };
+
+    struct PendingRequest {
+        std::string instrument_name;
+        Side side;
+        std::string method;
+    };
+
+    const Config& config_;
+    const InstrumentStore& instruments_;
+    RateLimiter& rate_limiter_;
+    RiskEngine& risk_engine_;
+    SendFunction send_;
+
+    std::unordered_map<std::string, std::array<QuoteSide, 2>> quotes_;
+    std::unordered_map<uint64_t, PendingRequest> pending_;
+    std::unordered_map<std::string, std::pair<std::string, Side>> side_by_order_id_;
+    mutable std::mutex mutex_;
+    uint64_t next_request_id_{kFirstRequestId};
+
+    // Retry thread; woken when a side is deferred, guarded by mutex_
+    std::thread retry_thread_;
+    std::condition_variable retry_cv_;
+    bool running_{false};
+    bool deferred_{false};
+
+    std::atomic<uint64_t> quote_updates_{0};
+    std::atomic<uint64_t> orders_sent_{0};
+    std::atomic<uint64_t> edits_sent_{0};
+    std::atomic<uint64_t> cancels_sent_{0};
+    std::atomic<uint64_t> edits_suppressed_{0};
+    std::atomic<uint64_t> throttled_{0};
+    std::atomic<uint64_t> risk_rejected_{0};
+    std::atomic<uint64_t> acks_{0};
+    std::atomic<uint64_t> errors_{0};
+
+    // Internal methods (mutex held, except runRetries)
+    void runRetries();
+    void flushDeferred();
+    void defer();
+    void sendSide(const std::string& instrument_name, Side side, QuoteSide& state);
+    void setLive(const std::string& instrument_name, Side side, QuoteSide& state, const Order& order);
+    void clearLive(QuoteSide& state);
+};
+
+} // namespace deribit
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include "deribit/config.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Deribit rate limit class of a request
+ */
+enum class RequestClass {
+    MatchingEngine,  // Orders, edits and cancels
+    NonMatching      // Queries, subscriptions and everything else
+};
+
+/**
+ * @brief Priority lane of a request, highest priority first
+ */
+enum class RequestPriority {
+    Cancel = 0,        // Cancels always jump the queue
+    RiskReducing = 1,  // Reduce-only orders and position closes
+    Order = 2,         // New orders and edits
+    Query = 3          // Market data and account queries
+};
+
+/**
+ * @brief Point-in-time metrics for one request class
+ */
+struct RateLimiterStats {
+    double max_credits{0.0};
+    double available_credits{0.0};
+    double utilisation{0.0};          // Fraction of the bucket currently consumed
+    uint64_t requests{0};             // Requests admitted
+    uint64_t delayed_requests{0};     // Requests that had to wait
+    uint64_t total_wait_ns{0};        // Accumulated queue wait
+    uint64_t max_wait_ns{0};          // Longest single queue wait
+    std::array<uint32_t, 4> queue_depth{};  // Waiters per priority lane
+};
+
+/**
+ * @brief Client-side credit-based rate limiter with priority lanes
+ *
+ * Each request class has its own token bucket configured from Config. When a
+ * bucket is empty, callers queue per priority lane and are admitted strictly
+ * by priority, then FIFO within a lane, so cancels are never stuck behind
+ * queries.
+ */
+class RateLimiter {
+public:
+    /**
+     * @brief Constructor
+     * @param config Configuration holding the per-class rate limits
+     */
+    explicit RateLimiter(const Config& config);
+
+    /**
+     * @brief Wait until a request may be sent
+     * @param request_class The rate limit class of the request
+     * @param priority The priority lane of the request
+     * @return The time spent waiting
+     */
+    std::chrono::nanoseconds acquire(RequestClass request_class, RequestPriority priority);
+
+    /**
+     * @brief Consume credits only if they are available right now
+     *
+     * Fails while a request of the same or higher priority is queued, so a
+     * caller never jumps ahead of a waiter it would not overtake in acquire().
+     *
+     * @param request_class The rate limit class of the request
+     * @param priority The priority lane of the request
+     * @return true if the request may be sent, false otherwise
+     */
+    bool tryAcquire(RequestClass request_class, RequestPriority priority = RequestPriority::Order);
+
+    /**
+     * @brief Get the metrics for a request class without taking its lock
+     * @param request_class The rate limit class
+     * @return The current metrics
+     */
+    RateLimiterStats getStats(RequestClass request_class) const;
+
+    /**
+     * @brief Get the credits available to a request class without taking its lock
+     * @param request_class The rate limit class
+     * @return The credits, as of the last change to the bucket plus refill since
+     */
+    double getAvailableCredits(RequestClass request_class) const;
+
+    /**
+     * @brief Get the number of requests waiting in one lane without taking its lock
+     * @param request_class The rate limit class
+     * @param priority The priority lane
+     * @return The waiters
+     */
+    uint32_t getQueueDepth(RequestClass request_class, RequestPriority priority) const;
+
+    /**
+     * @brief Determine the rate limit class of a JSON-RPC method
+     * @param method The method (e.g., "private/buy")
+     * @return The rate limit class
+     */
+    static RequestClass classify(const std::string& method);
+
+    /**
+     * @brief Determine the default priority lane of a JSON-RPC method
+     * @param method The method (e.g., "private/cancel")
+     * @param reduce_only Whether the request can only reduce exposure
+     * @return The priority lane
+     */
+    static RequestPriority prioritize(const std::string& method, bool reduce_only = false);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t kLaneCount = 4;
+
+    struct Bucket {
+        RateLimitSettings settings{};
+        double credits{0.0};
+        Clock::time_point last_refill;
+
+        // Per-lane FIFO tickets
+        std::array<uint64_t, kLaneCount> next_ticket{};
+        std::array<uint64_t, kLaneCount> now_serving{};
+        std::array<uint32_t, kLaneCount> waiting{};
+
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> delayed_requests{0};
+        std::atomic<uint64_t> total_wait_ns{0};
+        std::atomic<uint64_t> max_wait_ns{0};
+
+        // Copies of credits, last_refill and waiting for lock-free readers; written under the mutex
+        std::atomic<double> published_credits{0.0};
+        std::atomic<int64_t> published_refill_ns{0};
+        std::array<std::atomic<uint32_t>, kLaneCount> published_waiting{};
+
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    std::array<Bucket, 2> buckets_;
+
+    // Internal methods
+    Bucket& bucket(RequestClass request_class);
+    const Bucket& bucket(RequestClass request_class) const;
+    static void refill(Bucket& bucket, Clock::time_point now);
+    static bool higherPriorityWaiting(const Bucket& bucket, size_t lane);
+    static void recordWait(Bucket& bucket, uint64_t wait_ns);
+    static void publish(Bucket& bucket);
+};
+
+} // namespace deribit
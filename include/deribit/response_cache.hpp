@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+
+/**
+ * @brief Hit/miss counters for the response cache
+ */
+struct ResponseCacheStats {
+    uint64_t hits{0};       // Served from a fresh entry
+    uint64_t misses{0};     // Went to the network
+    uint64_t coalesced{0};  // Joined an identical in-flight request
+    size_t entries{0};      // Entries currently stored
+};
+
+/**
+ * @brief Read-through TTL cache for public REST responses
+ *
+ * Entries are keyed on method plus parameters and expire after a per-method
+ * TTL. Concurrent identical misses are deduplicated so only one request goes
+ * to the network and every caller receives its response. Methods without a
+ * TTL are never cached. Expired entries are swept at most once a second as
+ * new ones are stored, so keys that are never asked for again do not pile up.
+ */
+class ResponseCache {
+public:
+    using Loader = std::function<nlohmann::json()>;
+
+    /**
+     * @brief Constructor, installing default TTLs for common public methods
+     */
+    ResponseCache();
+
+    /**
+     * @brief Set the TTL for a method
+     * @param method The JSON-RPC method (e.g., "public/get_order_book")
+     * @param ttl The time to live; zero disables caching for the method
+     */
+    void setTtl(const std::string& method, std::chrono::milliseconds ttl);
+
+    /**
+     * @brief Get the TTL for a method
+     * @param method The JSON-RPC method
+     * @return The time to live, zero if the method is not cached
+     */
+    std::chrono::milliseconds getTtl(const std::string& method) const;
+
+    /**
+     * @brief Return a cached response or load it through the loader
+     * @param method The JSON-RPC method
+     * @param key The cache key (method plus parameters)
+     * @param loader Performs the request on a miss
+     * @return The response as JSON
+     */
+    nlohmann::json getOrLoad(
+        const std::string& method,
+        const std::string& key,
+        const Loader& loader);
+
+    /**
+     * @brief Drop every cached entry
+     */
+    void clear();
+
+    /**
+     * @brief Get the cache counters
+     * @return The current counters
+     */
+    ResponseCacheStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        nlohmann::json response;
+        Clock::time_point expires_at;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::chrono::milliseconds> ttls_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_map<std::string, std::shared_future<nlohmann::json>> in_flight_;
+    Clock::time_point next_sweep_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> coalesced_{0};
+
+    // Internal methods
+    void sweep(Clock::time_point now);
+};
+
+} // namespace deribit
@@ -4,9 +4,14 @@
 #include <functional>
 #include <memory>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <nlohmann/json.hpp>
 #include <curl/curl.h>
 #include "deribit/config.hpp"
+#include "deribit/response_cache.hpp"
 
 namespace deribit {
 
@@ -40,12 +45,20 @@ public:
 
     /**
      * @brief Refresh the access token
+     *
+     * Normally invoked by the background refresher thread ahead of expiry;
+     * callers never need to refresh inline before a request.
+     *
      * @return The refreshed access token as JSON
      */
     nlohmann::json refreshToken();
 
     /**
      * @brief Send a GET request to the Deribit API
+     *
+     * Responses to public methods are served from a TTL cache, and concurrent
+     * identical requests share a single network round trip.
+     *
      * @param endpoint The API endpoint
      * @param params The query parameters
      * @return The response as JSON
@@ -64,6 +77,19 @@ public:
         const std::string& endpoint,
         const nlohmann::json& data);
 
+    /**
+     * @brief Set the cache TTL for a public method
+     * @param method The JSON-RPC method (e.g., "public/get_order_book")
+     * @param ttl The time to live; zero disables caching for the method
+     */
+    void setCacheTtl(const std::string& method, std::chrono::milliseconds ttl);
+
+    /**
+     * @brief Get the response cache counters
+     * @return The hit/miss counters
+     */
+    ResponseCacheStats getCacheStats() const;
+
     /**
      * @brief Check if the client is authenticated
      * @return true if authenticated, false otherwise
@@ -71,10 +97,14 @@ public:
     bool isAuthenticated() const { return is_authenticated_; }
 
     /**
-     * @brief Get the access token
+     * @brief Get the current access token
+     *
+     * The token is swapped atomically by the background refresher, so this is
+     * safe to call from any thread and never blocks on network I/O.
+     *
      * @return The access token
      */
-    const std::string& getAccessToken() const { return access_token_; }
+    std::string getAccessToken() const;
 
     /**
      * @brief Check if the token needs to be refreshed
@@ -85,19 +115,33 @@ public:
 private:
     Config config_;
     CURL* curl_;
-    std::string access_token_;
+    std::mutex curl_mutex_;
+    CURL* refresh_curl_{nullptr};
+    std::shared_ptr<const std::string> access_token_;
     std::string refresh_token_;
-    int expires_in_;
+    int expires_in_{0};
     std::string token_type_;
-    bool is_authenticated_{false};
+    std::atomic<bool> is_authenticated_{false};
     std::chrono::system_clock::time_point token_expiry_;
+    ResponseCache response_cache_;
+    
+    // Background token refresher
+    mutable std::mutex token_mutex_;
+    std::mutex refresh_mutex_;
+    std::condition_variable refresh_cv_;
+    std::thread refresh_thread_;
+    bool refresher_running_{false};
     
     // Internal methods
+    nlohmann::json performGet(const std::string& endpoint, const nlohmann::json& params);
     std::string buildUrl(const std::string& endpoint) const;
     std::string buildAuthHeader() const;
     nlohmann::json handleResponse(const std::string& response) const;
-    void updateTokenExpiry();
-    bool checkAndRefreshToken();
+    void storeTokens(const nlohmann::json& result);
+    std::chrono::system_clock::time_point nextRefreshTime() const;
+    void startTokenRefresher();
+    void stopTokenRefresher();
+    void runTokenRefresher();
 };
 
 } // namespace deribit 
\ No newline at end of file
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "deribit/config.hpp"
+#include "deribit/order.hpp"
+#include "deribit/instrument.hpp"
+#include "deribit/position_store.hpp"
+
+namespace deribit {
+
+/**
+ * @brief Outcome of a pre-trade risk check
+ */
+enum class RiskReason : uint8_t {
+    Accepted = 0,
+    Halted,         // Trading halted by the kill switch
+    MaxOrderSize,   // Order amount above max_order_size
+    MaxPosition,    // Resulting position above max_position
+    MaxNotional,    // Order notional above max_notional
+    PriceBand,      // Limit price too far from the live mid
+    OrderRate,      // Too many orders in the current second
+    Count
+};
+
+/**
+ * @brief Get a printable name for a risk reason
+ * @param reason The reason code
+ * @return The reason name (e.g., "max_position")
+ */
+const char* toString(RiskReason reason);
+
+/**
+ * @brief Point-in-time risk check counters
+ */
+struct RiskStats {
+    uint64_t checks{0};
+    std::array<uint64_t, static_cast<size_t>(RiskReason::Count)> rejections{};  // Indexed by RiskReason
+};
+
+/**
+ * @brief Inline pre-trade risk checks on the order-send path
+ *
+ * Limits, positions and mid prices are held in atomics that market-data and
+ * account handlers update in place, so a check is a handful of relaxed loads
+ * plus one hash lookup and never waits on the engine's mutex. The instrument
+ * table is loaded with std::atomic_load on a shared_ptr, which libstdc++ and
+ * MSVC implement with a short internal lock, so a check is not strictly
+ * lock-free.
+ */
+class RiskEngine {
+public:
+    /**
+     * @brief Constructor
+     * @param limits The initial risk limits
+     */
+    explicit RiskEngine(const RiskLimits& limits);
+
+    /**
+     * @brief Check an order against every limit
+     *
+     * An accepted order counts towards the order-rate window. The position
+     * limit applies to the position if every open order on the order's side
+     * filled as well.
+     *
+     * @param instrument_name The instrument name
+     * @param is_buy Whether the order buys
+     * @param amount The order amount
+     * @param price The limit price, or 0 for market orders
+     * @param reference Reference data used to value the notional in USD, or nullptr to value it as linear
+     * @param replaced_amount The amount of an open order this one replaces (edits), or 0
+     * @return RiskReason::Accepted, or the first limit breached
+     */
+    RiskReason check(
+        const std::string& instrument_name,
+        bool is_buy,
+        double amount,
+        double price,
+        const Instrument* reference,
+        double replaced_amount = 0.0);
+
+    /**
+     * @brief Check an order against every limit except the order rate
+     *
+     * For callers that must acquire something else first; follow an accepted
+     * check with admit() once the order is certain to be sent.
+     *
+     * @param instrument_name The instrument name
+     * @param is_buy Whether the order buys
+     * @param amount The order amount
+     * @param price The limit price, or 0 for market orders
+     * @param reference Reference data used to value the notional in USD, or nullptr to value it as linear
+     * @param replaced_amount The amount of an open order this one replaces (edits), or 0
+     * @return RiskReason::Accepted, or the first limit breached
+     */
+    RiskReason checkLimits(
+        const std::string& instrument_name,
+        bool is_buy,
+        double amount,
+        double price,
+        const Instrument* reference,
+        double replaced_amount = 0.0);
+
+    /**
+     * @brief Count an order towards the order-rate window
+     * @return RiskReason::Accepted, or RiskReason::OrderRate if the window is full
+     */
+    RiskReason admit();
+
+    /**
+     * @brief Replace the risk limits
+     * @param limits The new risk limits
+     */
+    void setLimits(const RiskLimits& limits);
+
+    /**
+     * @brief Halt or resume trading; every check fails while halted
+     * @param halted Whether trading is halted
+     */
+    void setHalted(bool halted) { halted_.store(halted, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check if trading is halted
+     * @return true if halted, false otherwise
+     */
+    bool isHalted() const { return halted_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Record the live mid price of an instrument
+     * @param instrument_name The instrument name
+     * @param mid The mid price
+     */
+    void updateMid(const std::string& instrument_name, double mid);
+
+    /**
+     * @brief Record the index price of a currency, used to value option notionals in USD
+     * @param currency The currency (e.g., "BTC")
+     * @param index_price The index price in USD
+     */
+    void updateIndex(const std::string& currency, double index_price);
+
+    /**
+     * @brief Record the current position in an instrument
+     * @param instrument_name The instrument name
+     * @param size The signed position size
+     */
+    void updatePosition(const std::string& instrument_name, double size);
+
+    /**
+     * @brief Reset every tracked position to a position store snapshot
+     * @param positions The snapshot; instruments missing from it are flat
+     */
+    void syncPositions(const PositionStore::PositionMap& positions);
+
+    /**
+     * @brief Record the unfilled amount resting on each side of an instrument
+     * @param instrument_name The instrument name
+     * @param buy_amount The unfilled amount of open buy orders
+     * @param sell_amount The unfilled amount of open sell orders
+     */
+    void updateOpenOrders(const std::string& instrument_name, double buy_amount, double sell_amount);
+
+    /**
+     * @brief Reset every tracked open-order exposure to an open order snapshot
+     * @param open_orders Every open order; instruments missing from it have none
+     */
+    void syncOpenOrders(const std::vector<Order>& open_orders);
+
+    /**
+     * @brief Get the check counters
+     * @return The current counters
+     */
+    RiskStats getStats() const;
+
+private:
+    struct InstrumentRisk {
+        std::atomic<double> position{0.0};
+        std::atomic<double> open_buy{0.0};   // Unfilled amount of open buy orders
+        std::atomic<double> open_sell{0.0};  // Unfilled amount of open sell orders
+        std::atomic<double> mid{0.0};
+    };
+
+    using InstrumentRiskMap = std::unordered_map<std::string, std::shared_ptr<InstrumentRisk>>;
+
+    std::atomic<double> max_order_size_;
+    std::atomic<double> max_position_;
+    std::atomic<double> max_notional_;
+    std::atomic<double> price_band_;
+    std::atomic<uint32_t> max_orders_per_second_;
+    std::atomic<bool> halted_{false};
+
+    // Second of the current rate window in the high 32 bits, orders admitted in the low 32
+    std::atomic<uint64_t> rate_window_{0};
+
+    std::shared_ptr<const InstrumentRiskMap> instruments_;
+    std::mutex instruments_mutex_;
+
+    std::atomic<uint64_t> checks_{0};
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(RiskReason::Count)> rejections_{};
+
+    // Internal methods
+    std::shared_ptr<InstrumentRisk> find(const std::string& instrument_name) const;
+    std::shared_ptr<InstrumentRisk> findOrCreate(const std::string& instrument_name);
+    bool admitOrder();
+    RiskReason reject(RiskReason reason);
+};
+
+} // namespace deribit
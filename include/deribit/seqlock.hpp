@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <thread>
+
+namespace deribit {
+
+/**
+ * @brief Single-writer slot that readers on any thread load without locks
+ *
+ * The writer bumps the sequence to an odd value, copies the new value in and
+ * bumps it back to even. Readers copy the value and retry if the sequence was
+ * odd or changed underneath them. Writers never wait for readers, which makes
+ * this suitable for small, frequently updated market-data snapshots.
+ *
+ * @tparam T A trivially copyable value type
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+public:
+    /**
+     * @brief Publish a new value; must only be called from the writer thread
+     * @param value The new value
+     */
+    void store(const T& value) {
+        uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&value_, &value, sizeof(T));
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Try to copy out a consistent value without retrying
+     * @param value The value, if the read was consistent
+     * @return true if consistent, false if a write was in progress
+     */
+    bool tryLoad(T& value) const {
+        uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        std::memcpy(&value, &value_, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.load(std::memory_order_relaxed) == before;
+    }
+
+    /**
+     * @brief Copy out a consistent value, retrying while a write is in progress
+     * @return The value
+     */
+    T load() const {
+        T value;
+        while (!tryLoad(value)) {
+            std::this_thread::yield();
+        }
+        return value;
+    }
+
+    /**
+     * @brief Get the number of values published so far
+     * @return The version, usable to detect changes cheaply
+     */
+    uint64_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    alignas(64) std::atomic<uint64_t> sequence_{0};
+    T value_{};
+};
+
+} // namespace deribit
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+
+/**
+ * @brief Clock synchronisation counters and the current estimate
+ */
+struct TimeSyncStats {
+    uint64_t probes{0};       // public/get_time requests sent
+    uint64_t samples{0};      // Responses accepted into the filter
+    uint64_t discarded{0};    // Errors, late responses and implausible round trips
+    bool synced{false};       // Whether an offset estimate is available
+    int64_t offset_ns{0};     // Exchange clock minus local wall clock
+    int64_t rtt_ns{0};        // Round trip of the sample the offset was taken from
+};
+
+/**
+ * @brief Estimates the exchange clock offset from public/get_time round trips
+ *
+ * Each probe records the local wall clock just before sending (t0) and at
+ * frame receipt (t1). As in NTP, the exchange is assumed to have stamped
+ * its reply halfway through the round trip, so the offset is the exchange
+ * time minus (t0 + t1) / 2 and is good to within half the round trip plus
+ * the exchange's millisecond resolution. Of the last kWindow samples the
+ * one with the shortest round trip is used, since queueing only ever adds
+ * delay and makes the halfway assumption worse.
+ *
+ * Probes carry their own request ids so a late reply can never be paired
+ * with a newer send time.
+ */
+class TimeSync {
+public:
+    using SendFunction = std::function<bool(const std::string&)>;
+
+    static constexpr size_t kWindow = 8;
+
+    /**
+     * @brief Constructor
+     * @param send Function that writes a message to the WebSocket
+     */
+    explicit TimeSync(SendFunction send);
+
+    /**
+     * @brief Check if a JSON-RPC response belongs to a time probe
+     * @param id The response id
+     * @return true if the id was issued by a probe, false otherwise
+     */
+    static bool ownsRequest(uint64_t id) { return id >= kFirstRequestId && id < kLastRequestId; }
+
+    /**
+     * @brief Send a public/get_time probe; an unanswered earlier probe is abandoned
+     * @return true if the request was sent, false otherwise
+     */
+    bool probe();
+
+    /**
+     * @brief Handle the response to a probe
+     * @param response The JSON-RPC response
+     * @param received_ns Local wall clock at frame receipt, nanoseconds since epoch
+     */
+    void onResponse(const nlohmann::json& response, int64_t received_ns);
+
+    /**
+     * @brief Check if an offset estimate is available
+     * @return true if at least one probe was answered, false otherwise
+     */
+    bool isSynced() const { return synced_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Get the estimated exchange clock offset
+     * @return Exchange clock minus local wall clock in nanoseconds, or 0 if not synced
+     */
+    int64_t getOffsetNs() const { return offset_ns_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the current exchange time
+     * @return The local wall clock corrected by the offset, in milliseconds since epoch
+     */
+    int64_t exchangeNowMs() const;
+
+    /**
+     * @brief Estimate how long an exchange-stamped message took to reach us
+     * @param exchange_ms The exchange timestamp, in milliseconds since epoch
+     * @param received_ns Local wall clock at frame receipt, nanoseconds since epoch
+     * @return The one-way latency in nanoseconds, clamped at 0; includes the offset error until synced
+     */
+    int64_t wireLatencyNs(int64_t exchange_ms, int64_t received_ns) const {
+        int64_t latency = received_ns - exchange_ms * 1000000 + getOffsetNs();
+        return latency > 0 ? latency : 0;
+    }
+
+    /**
+     * @brief Get the clock synchronisation counters
+     * @return The current counters and estimate
+     */
+    TimeSyncStats getStats() const;
+
+private:
+    static constexpr uint64_t kFirstRequestId = 10000;
+    static constexpr uint64_t kLastRequestId = 100000;
+
+    // Replies slower than this say nothing useful about the offset
+    static constexpr int64_t kMaxRttNs = 2000000000;
+
+    struct Sample {
+        int64_t offset_ns;
+        int64_t rtt_ns;
+    };
+
+    SendFunction send_;
+
+    // Outstanding probe and filter window; probes come from the maintenance thread, replies from the WebSocket thread
+    mutable std::mutex mutex_;
+    uint64_t next_request_id_{kFirstRequestId};
+    uint64_t pending_id_{0};
+    int64_t pending_sent_ns_{0};
+    std::array<Sample, kWindow> window_{};
+    size_t window_size_{0};
+    size_t window_next_{0};
+
+    // Published estimate, read lock-free on the hot path
+    std::atomic<bool> synced_{false};
+    std::atomic<int64_t> offset_ns_{0};
+    std::atomic<int64_t> rtt_ns_{0};
+
+    std::atomic<uint64_t> probes_{0};
+    std::atomic<uint64_t> samples_{0};
+    std::atomic<uint64_t> discarded_{0};
+};
+
+} // namespace deribit
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+
+/**
+ * @brief Best bid/ask snapshot from the quote.* and ticker.* channels
+ *
+ * Fixed size with no heap members so it can be published through a SeqLock.
+ * Ticker-only fields stay 0 when only quote.* is subscribed.
+ */
+struct TopOfBook {
+    int64_t timestamp{0};
+    double best_bid_price{0.0};
+    double best_bid_amount{0.0};
+    double best_ask_price{0.0};
+    double best_ask_amount{0.0};
+    double last_price{0.0};
+    double mark_price{0.0};
+    double index_price{0.0};
+
+    /**
+     * @brief Get the mid price
+     * @return The mid price, or 0 if either side is empty
+     */
+    double getMidPrice() const {
+        return best_bid_price > 0.0 && best_ask_price > 0.0
+            ? (best_bid_price + best_ask_price) / 2.0 : 0.0;
+    }
+
+    /**
+     * @brief Apply a quote.* or ticker.* notification
+     *
+     * Fields missing from the notification keep their previous value, so a
+     * slot fed by both channels stays complete.
+     *
+     * @param json The notification data
+     */
+    void update(const nlohmann::json& json);
+};
+
+} // namespace deribit
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define DERIBIT_TRACE_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define DERIBIT_TRACE_HAS_TSC 1
+#endif
+
+namespace deribit {
+
+/**
+ * @brief One completed trace span
+ */
+struct TraceEvent {
+    const char* name;  // String literal naming the span
+    uint64_t start;    // Trace clock ticks
+    uint64_t end;      // Trace clock ticks
+};
+
+/**
+ * @brief Fixed-size ring of the most recent spans recorded by one thread
+ *
+ * One writer appends; the dumping thread copies the ring without locks and
+ * discards anything the writer overwrote meanwhile, like TradeRing.
+ */
+class TraceBuffer {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Events kept; rounded up to a power of two
+     * @param thread_id Small id shown as the thread in the trace viewer
+     */
+    TraceBuffer(size_t capacity, uint32_t thread_id);
+
+    /**
+     * @brief Append a span; must only be called from the owning thread
+     * @param name The span name literal
+     * @param start Start tick
+     * @param end End tick
+     */
+    void append(const char* name, uint64_t start, uint64_t end) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        events_[head & mask_] = TraceEvent{name, start, end};
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy out the spans currently held, oldest first
+     * @return The spans
+     */
+    std::vector<TraceEvent> snapshot() const;
+
+    /**
+     * @brief Set the name shown for this thread in the trace viewer
+     * @param name The thread name
+     */
+    void setName(const std::string& name);
+
+    /**
+     * @brief Get the thread name
+     * @return The name, or empty if never set
+     */
+    std::string getName() const;
+
+    /**
+     * @brief Get the thread id shown in the trace viewer
+     * @return The id
+     */
+    uint32_t getThreadId() const { return thread_id_; }
+
+private:
+    std::unique_ptr<TraceEvent[]> events_;
+    size_t mask_;
+    uint32_t thread_id_;
+    std::atomic<uint64_t> head_{0};
+    std::string name_;
+    mutable std::mutex name_mutex_;
+};
+
+/**
+ * @brief Process-wide recorder of scoped spans, exported as Chrome trace JSON
+ *
+ * Spans are timestamped with the TSC where available and written to the
+ * calling thread's own ring, so recording is two counter reads and a store.
+ * Ticks are converted to microseconds only when the trace is exported. The
+ * output loads in chrome://tracing and ui.perfetto.dev.
+ *
+ * Instrumentation goes through the DERIBIT_TRACE_* macros, which compile to
+ * nothing unless DERIBIT_ENABLE_TRACING is defined.
+ */
+class Tracer {
+public:
+    static constexpr size_t kBufferCapacity = 65536;
+
+    /**
+     * @brief Get the process-wide tracer
+     * @return The tracer
+     */
+    static Tracer& instance();
+
+    /**
+     * @brief Read the trace clock
+     * @return The current tick
+     */
+    static uint64_t now() {
+#if defined(DERIBIT_TRACE_HAS_TSC)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Record a completed span on the calling thread
+     * @param name The span name literal
+     * @param start Start tick from now()
+     * @param end End tick from now()
+     */
+    void record(const char* name, uint64_t start, uint64_t end) { local().append(name, start, end); }
+
+    /**
+     * @brief Name the calling thread in the exported trace
+     * @param name The thread name (e.g., "ws_io")
+     */
+    void setThreadName(const std::string& name) { local().setName(name); }
+
+    /**
+     * @brief Export every thread's recent spans as Chrome trace event JSON
+     * @return The trace document
+     */
+    std::string toJson() const;
+
+    /**
+     * @brief Write the trace to a file
+     * @param path The output path (e.g., "trace.json")
+     * @return true if the file was written, false otherwise
+     */
+    bool dump(const std::string& path) const;
+
+private:
+    std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+    mutable std::mutex buffers_mutex_;
+
+    // Reference points for converting ticks to wall time at export
+    uint64_t origin_ticks_;
+    std::chrono::steady_clock::time_point origin_time_;
+
+    Tracer();
+
+    // Internal methods
+    TraceBuffer& local() {
+        thread_local TraceBuffer* buffer = nullptr;
+        if (buffer == nullptr) {
+            buffer = addBuffer();
+        }
+        return *buffer;
+    }
+    TraceBuffer* addBuffer();
+};
+
+/**
+ * @brief Records a span covering its own lifetime
+ */
+class TraceScope {
+public:
+    /**
+     * @brief Constructor; starts the span
+     * @param name The span name literal
+     */
+    explicit TraceScope(const char* name) : tracer_(Tracer::instance()), name_(name), start_(Tracer::now()) {}
+
+    /**
+     * @brief Destructor; ends and records the span
+     */
+    ~TraceScope() { tracer_.record(name_, start_, Tracer::now()); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    Tracer& tracer_;
+    const char* name_;
+    uint64_t start_;
+};
+
+} // namespace deribit
+
+#define DERIBIT_TRACE_CONCAT_INNER(a, b) a##b
+#define DERIBIT_TRACE_CONCAT(a, b) DERIBIT_TRACE_CONCAT_INNER(a, b)
+
+#if defined(DERIBIT_ENABLE_TRACING)
+/**
+ * @brief Trace the rest of the enclosing scope under a literal name
+ */
+#define DERIBIT_TRACE_SCOPE(name) \
+    ::deribit::TraceScope DERIBIT_TRACE_CONCAT(deribit_trace_scope_, __LINE__)(name)
+/**
+ * @brief Name the calling thread in the exported trace
+ */
+#define DERIBIT_TRACE_THREAD_NAME(name) ::deribit::Tracer::instance().setThreadName(name)
+#else
+#define DERIBIT_TRACE_SCOPE(name) ((void)0)
+#define DERIBIT_TRACE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+
+/**
+ * @brief Scale of fixed-point prices and amounts (8 decimal places)
+ */
+constexpr int64_t kFixedPointScale = 100000000;
+
+/**
+ * @brief Convert a decimal value to fixed point
+ * @param value The value
+ * @return The value scaled by kFixedPointScale
+ */
+inline int64_t toFixedPoint(double value) {
+    return static_cast<int64_t>(std::llround(value * static_cast<double>(kFixedPointScale)));
+}
+
+/**
+ * @brief Convert a fixed-point value back to decimal
+ * @param value The scaled value
+ * @return The decimal value
+ */
+inline double fromFixedPoint(int64_t value) {
+    return static_cast<double>(value) / static_cast<double>(kFixedPointScale);
+}
+
+/**
+ * @brief Aggressor side of a trade
+ */
+enum class TradeSide : uint8_t {
+    Buy = 0,
+    Sell = 1
+};
+
+/**
+ * @brief Compact trade record decoded from the trades.* channels
+ */
+struct TradeRecord {
+    int64_t price;       // Fixed point, see kFixedPointScale
+    int64_t amount;      // Fixed point, see kFixedPointScale
+    uint64_t trade_id;   // Numeric part of the exchange trade id
+    int64_t timestamp;   // Milliseconds since epoch
+    TradeSide side;
+
+    /**
+     * @brief Decode a trade notification entry
+     * @param json The trade JSON
+     * @return The trade record
+     */
+    static TradeRecord fromJson(const nlohmann::json& json);
+};
+
+/**
+ * @brief Fixed-size trade history for one instrument
+ *
+ * One writer appends; any number of readers copy records out without locks.
+ * The writer publishes each record by advancing the head with release
+ * semantics. Readers copy a range and then re-check the head, discarding
+ * anything the writer may have overwritten meanwhile, so a reader never
+ * returns a torn record and never slows the writer down.
+ */
+class TradeRing {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Records kept; rounded up to a power of two
+     */
+    explicit TradeRing(size_t capacity);
+
+    /**
+     * @brief Append a record; must only be called from the writer thread
+     * @param record The trade record
+     */
+    void push(const TradeRecord& record);
+
+    /**
+     * @brief Get the sequence number of the next record to be written
+     * @return Total records ever written
+     */
+    uint64_t head() const { return head_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Get the ring capacity
+     * @return The number of records kept
+     */
+    size_t capacity() const { return mask_ + 1; }
+
+    /**
+     * @brief Copy records starting at a sequence number
+     *
+     * Records older than the history window are skipped, so from is advanced
+     * to the oldest record still held.
+     *
+     * @param from The sequence number to start at; updated to the next unread
+     * @param out Destination buffer
+     * @param max_records Capacity of the destination buffer
+     * @return The number of records copied
+     */
+    size_t read(uint64_t& from, TradeRecord* out, size_t max_records) const;
+
+private:
+    std::unique_ptr<TradeRecord[]> records_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+} // namespace deribit
@@ -8,6 +8,8 @@
 #include <queue>
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 
 #define ASIO_STANDALONE
@@ -17,6 +19,7 @@
 #include <websocketpp/client.hpp>
 
 #include "deribit/config.hpp"
+#include "deribit/frame_journal.hpp"
 
 namespace deribit {
 
@@ -102,6 +105,61 @@ public:
      */
     bool isAuthenticated() const { return is_authenticated_; }
 
+    /**
+     * @brief Get the number of connections opened since construction
+     * @return The count
+     */
+    uint64_t getConnectCount() const { return connects_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of connections closed or failed since construction
+     * @return The count
+     */
+    uint64_t getDisconnectCount() const { return disconnects_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the monotonic time the frame being dispatched was received
+     *
+     * Only meaningful inside the message callback, which runs on the
+     * WebSocket thread that sets it.
+     *
+     * @return The receive time
+     */
+    std::chrono::steady_clock::time_point getReceiveTime() const { return receive_time_; }
+
+    /**
+     * @brief Get the wall-clock time the frame being dispatched was received
+     *
+     * Only meaningful inside the message callback; compared against exchange
+     * timestamps.
+     *
+     * @return The receive time
+     */
+    std::chrono::system_clock::time_point getReceiveWallTime() const { return receive_wall_time_; }
+
+    /**
+     * @brief Get the frame journal counters
+     * @return The counters; all zero when recording is disabled
+     */
+    FrameJournalStats getFrameJournalStats() const { return journal_ ? journal_->getStats() : FrameJournalStats(); }
+
+    /**
+     * @brief Handle one received text frame as if it had been read from the socket
+     *
+     * Called by the socket's message handler; benchmarks and replay tools
+     * use it to drive dispatch without a connection.
+     *
+     * @param payload The frame payload
+     */
+    void handleFrame(const std::string& payload);
+
+    /**
+     * @brief Handle one received text frame stamped with an earlier receive time
+     * @param payload The frame payload
+     * @param receive_time The monotonic time the frame was read from the socket
+     */
+    void handleFrame(const std::string& payload, std::chrono::steady_clock::time_point receive_time);
+
 private:
     using ClientConfig = websocketpp::config::asio_tls_client;
     using Client = websocketpp::client<ClientConfig>;
@@ -118,9 +176,18 @@ private:
     std::atomic<bool> is_connected_{false};
     std::atomic<bool> is_authenticated_{false};
     std::atomic<bool> is_running_{false};
+    std::atomic<uint64_t> connects_{0};
+    std::atomic<uint64_t> disconnects_{0};
     
     std::function<void(const std::string&)> message_callback_;
     
+    // Stamped on the WebSocket thread as each frame arrives
+    std::chrono::steady_clock::time_point receive_time_;
+    std::chrono::system_clock::time_point receive_wall_time_;
+    
+    // Raw capture of socket frames; null unless Config::setFrameJournalPath was called
+    std::unique_ptr<FrameJournal> journal_;
+    
     // Internal methods
     void onOpen(ConnectionHandle hdl);
     void onClose(ConnectionHandle hdl);
@@ -0,0 +1,103 @@
+#include "mock_exchange.hpp"
+#include "rest_server.hpp"
+#include "scenario.hpp"
+#include "ws_server.hpp"
+#include "deribit/logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void onSignal(int) {
+    g_stop = true;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [scenario.json] [options]\n"
+              << "  --ws-port N       WebSocket port (default 8443)\n"
+              << "  --rest-port N     REST port (default 8080)\n"
+              << "  --book-rate R     Book changes per second per instrument, all phases\n"
+              << "  --trade-rate R    Trades per second per instrument, all phases\n"
+              << "  --latency-us N    Delay added to every reply, all phases\n"
+              << "  --jitter-us N     Extra uniform delay up to N, all phases\n"
+              << "  --gap-every N     Drop every Nth book change, all phases\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    deribit::mock::MockScenario scenario;
+
+    // A scenario file comes first; flags then override it across every phase
+    int arg = 1;
+    if (arg < argc && argv[arg][0] != '-') {
+        if (!deribit::mock::MockScenario::load(argv[arg], scenario)) {
+            deribit::Logger::instance().stop();
+            return 1;
+        }
+        ++arg;
+    }
+    for (; arg < argc; ++arg) {
+        std::string flag = argv[arg];
+        if (arg + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++arg];
+        if (flag == "--ws-port") {
+            scenario.ws_port = static_cast<uint16_t>(std::atoi(value));
+        } else if (flag == "--rest-port") {
+            scenario.rest_port = static_cast<uint16_t>(std::atoi(value));
+        } else {
+            for (auto& phase : scenario.phases) {
+                if (flag == "--book-rate") {
+                    phase.book_rate = std::atof(value);
+                } else if (flag == "--trade-rate") {
+                    phase.trade_rate = std::atof(value);
+                } else if (flag == "--latency-us") {
+                    phase.latency = std::chrono::microseconds(std::atoll(value));
+                } else if (flag == "--jitter-us") {
+                    phase.jitter = std::chrono::microseconds(std::atoll(value));
+                } else if (flag == "--gap-every") {
+                    phase.gap_every = static_cast<uint32_t>(std::atoi(value));
+                } else {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    deribit::mock::MockExchange exchange(scenario);
+    deribit::mock::WsServer ws_server(exchange, scenario);
+    deribit::mock::RestServer rest_server(exchange, scenario);
+
+    // Orders placed over either front end reach WebSocket subscribers
+    exchange.setOrderListener([&ws_server](const nlohmann::json& order, const nlohmann::json& trades,
+                                           const nlohmann::json& position) {
+        ws_server.publishOrderEvent(order, trades, position);
+    });
+
+    if (!ws_server.start() || !rest_server.start()) {
+        deribit::Logger::instance().stop();
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    while (!g_stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    rest_server.stop();
+    ws_server.stop();
+    deribit::Logger::instance().stop();
+    return 0;
+}
@@ -0,0 +1,596 @@
+#include "mock_exchange.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+
+namespace deribit {
+namespace mock {
+
+namespace {
+
+// JSON-RPC error raised while answering a request
+struct RpcError {
+    int code;
+    std::string message;
+};
+
+// Reference data for the instruments the mock knows how to price
+struct InstrumentSpec {
+    double price;
+    double tick_size;
+    double min_trade_amount;
+    double contract_size;
+};
+
+InstrumentSpec specFor(const std::string& instrument_name) {
+    if (instrument_name.compare(0, 4, "BTC-") == 0) {
+        return {64000.0, 0.5, 10.0, 10.0};
+    }
+    if (instrument_name.compare(0, 4, "ETH-") == 0) {
+        return {3400.0, 0.05, 1.0, 1.0};
+    }
+    return {100.0, 0.01, 1.0, 1.0};
+}
+
+double toPrice(int64_t ticks, double tick_size) {
+    return std::round(static_cast<double>(ticks) * tick_size * 1e8) / 1e8;
+}
+
+int64_t toTicks(double price, double tick_size) {
+    return static_cast<int64_t>(std::llround(price / tick_size));
+}
+
+int64_t wallNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+const nlohmann::json& requireParam(const nlohmann::json& params, const char* name) {
+    auto it = params.find(name);
+    if (it == params.end() || it->is_null()) {
+        throw RpcError{-32602, std::string("Invalid params: missing ") + name};
+    }
+    return *it;
+}
+
+} // namespace
+
+MockExchange::MockExchange(const MockScenario& scenario)
+    : scenario_(scenario)
+    , rng_(scenario.seed) {
+    for (const auto& instrument_name : scenario_.instruments) {
+        seedBook(instrument_name, books_[instrument_name]);
+    }
+}
+
+void MockExchange::setOrderListener(OrderListener listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = std::move(listener);
+}
+
+int64_t MockExchange::nowMs() const {
+    return wallNowUs() / 1000 + scenario_.clock_offset_ms;
+}
+
+bool MockExchange::hasInstrument(const std::string& instrument_name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return books_.count(instrument_name) > 0;
+}
+
+std::vector<std::string> MockExchange::getInstrumentNames() const {
+    return scenario_.instruments;
+}
+
+nlohmann::json MockExchange::respond(const nlohmann::json& request, bool authenticated) {
+    int64_t offset_us = scenario_.clock_offset_ms * 1000;
+    int64_t us_in = wallNowUs() + offset_us;
+
+    nlohmann::json response = {{"jsonrpc", "2.0"}};
+    if (request.contains("id")) {
+        response["id"] = request["id"];
+    }
+
+    std::vector<OrderEvent> events;
+    OrderListener listener;
+    try {
+        if (!request.contains("method") || !request["method"].is_string()) {
+            throw RpcError{-32600, "Invalid Request"};
+        }
+        std::string method = request["method"].get<std::string>();
+        if (isPrivate(method) && !authenticated) {
+            throw RpcError{13009, "unauthorized"};
+        }
+        nlohmann::json params = request.value("params", nlohmann::json::object());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        response["result"] = call(method, params, events);
+        listener = listener_;
+    } catch (const RpcError& e) {
+        response["error"] = {{"code", e.code}, {"message", e.message}};
+    } catch (const nlohmann::json::exception& e) {
+        response["error"] = {{"code", -32602}, {"message", "Invalid params"}, {"data", {{"reason", e.what()}}}};
+    }
+
+    int64_t us_out = wallNowUs() + offset_us;
+    response["usIn"] = us_in;
+    response["usOut"] = us_out;
+    response["usDiff"] = us_out - us_in;
+    response["testnet"] = true;
+
+    if (listener) {
+        for (const auto& event : events) {
+            listener(event.order, event.trades, event.position);
+        }
+    }
+    return response;
+}
+
+nlohmann::json MockExchange::call(const std::string& method, const nlohmann::json& params,
+                                  std::vector<OrderEvent>& events) {
+    if (method == "public/auth") {
+        uint64_t token = next_token_++;
+        return {
+            {"access_token", "mock-access-" + std::to_string(token)},
+            {"refresh_token", "mock-refresh-" + std::to_string(token)},
+            {"expires_in", 900},
+            {"token_type", "bearer"},
+            {"scope", "connection mainaccount trade:read_write"}
+        };
+    }
+    if (method == "public/get_time") {
+        return nowMs();
+    }
+    if (method == "public/test") {
+        return {{"version", "mock"}};
+    }
+    if (method == "public/get_instruments") {
+        std::string currency = params.value("currency", std::string("any"));
+        nlohmann::json result = nlohmann::json::array();
+        for (const auto& instrument_name : scenario_.instruments) {
+            if (currency == "any" || currencyOf(instrument_name) == currency) {
+                result.push_back(instrumentJson(instrument_name));
+            }
+        }
+        return result;
+    }
+    if (method == "public/get_order_book") {
+        std::string instrument_name = requireParam(params, "instrument_name").get<std::string>();
+        if (books_.count(instrument_name) == 0) {
+            throw RpcError{-32602, "Invalid params: unknown instrument " + instrument_name};
+        }
+        return orderBookJson(instrument_name, params.value("depth", size_t(10)));
+    }
+    if (method == "public/get_index_price") {
+        std::string index_name = requireParam(params, "index_name").get<std::string>();
+        for (const auto& instrument_name : scenario_.instruments) {
+            std::string currency = currencyOf(instrument_name);
+            std::transform(currency.begin(), currency.end(), currency.begin(),
+                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            if (index_name == currency + "_usd") {
+                const Book& book = books_.at(instrument_name);
+                double price = toPrice(book.mid, book.tick_size);
+                return {{"index_price", price}, {"estimated_delivery_price", price}};
+            }
+        }
+        throw RpcError{-32602, "Invalid params: unknown index " + index_name};
+    }
+    if (method == "private/buy" || method == "private/sell") {
+        return placeOrder(method == "private/buy" ? "buy" : "sell", params, events);
+    }
+    if (method == "private/edit") {
+        std::string order_id = requireParam(params, "order_id").get<std::string>();
+        auto it = orders_.find(order_id);
+        if (it == orders_.end() || it->second["order_state"] != "open") {
+            throw RpcError{10004, "order_not_found"};
+        }
+        nlohmann::json& order = it->second;
+        order["amount"] = requireParam(params, "amount").get<double>();
+        if (params.contains("price")) {
+            order["price"] = params["price"].get<double>();
+        }
+        order["last_update_timestamp"] = nowMs();
+        order["replaced"] = true;
+
+        // An edit that now crosses fills like a new aggressive order
+        const Book& book = books_.at(order["instrument_name"].get<std::string>());
+        bool is_buy = order["direction"] == "buy";
+        int64_t limit = toTicks(order["price"].get<double>(), book.tick_size);
+        int64_t touch = is_buy ? book.asks.begin()->first : book.bids.rbegin()->first;
+        if (is_buy ? limit >= touch : limit <= touch) {
+            events.push_back(fill(order, toPrice(touch, book.tick_size)));
+        } else {
+            events.push_back({order, nlohmann::json::array(), nullptr});
+        }
+        return {{"order", order}, {"trades", events.back().trades}};
+    }
+    if (method == "private/cancel") {
+        std::string order_id = requireParam(params, "order_id").get<std::string>();
+        auto it = orders_.find(order_id);
+        if (it == orders_.end() || it->second["order_state"] != "open") {
+            throw RpcError{10004, "order_not_found"};
+        }
+        it->second["order_state"] = "cancelled";
+        it->second["last_update_timestamp"] = nowMs();
+        events.push_back({it->second, nlohmann::json::array(), nullptr});
+        return it->second;
+    }
+    if (method == "private/cancel_all") {
+        return cancelWhere([](const nlohmann::json&) { return true; }, events);
+    }
+    if (method == "private/cancel_all_by_currency") {
+        std::string currency = requireParam(params, "currency").get<std::string>();
+        return cancelWhere([&](const nlohmann::json& order) {
+            return currencyOf(order["instrument_name"].get<std::string>()) == currency;
+        }, events);
+    }
+    if (method == "private/cancel_all_by_instrument") {
+        std::string instrument_name = requireParam(params, "instrument_name").get<std::string>();
+        return cancelWhere([&](const nlohmann::json& order) {
+            return order["instrument_name"] == instrument_name;
+        }, events);
+    }
+    if (method == "private/get_open_orders_by_currency") {
+        std::string currency = requireParam(params, "currency").get<std::string>();
+        nlohmann::json result = nlohmann::json::array();
+        for (const auto& entry : orders_) {
+            const nlohmann::json& order = entry.second;
+            if (order["order_state"] == "open" && currencyOf(order["instrument_name"].get<std::string>()) == currency) {
+                result.push_back(order);
+            }
+        }
+        return result;
+    }
+    if (method == "private/get_order_state") {
+        auto it = orders_.find(requireParam(params, "order_id").get<std::string>());
+        if (it == orders_.end()) {
+            throw RpcError{10004, "order_not_found"};
+        }
+        return it->second;
+    }
+    if (method == "private/get_order_state_by_label") {
+        std::string label = requireParam(params, "label").get<std::string>();
+        nlohmann::json result = nlohmann::json::array();
+        for (const auto& entry : orders_) {
+            if (entry.second["label"] == label) {
+                result.push_back(entry.second);
+            }
+        }
+        return result;
+    }
+    if (method == "private/get_positions") {
+        std::string currency = requireParam(params, "currency").get<std::string>();
+        nlohmann::json result = nlohmann::json::array();
+        for (const auto& entry : positions_) {
+            if (currencyOf(entry.first) == currency) {
+                result.push_back(positionJson(entry.first));
+            }
+        }
+        return result;
+    }
+    if (method == "private/enable_cancel_on_disconnect" || method == "private/disable_cancel_on_disconnect") {
+        return "ok";
+    }
+    throw RpcError{-32601, "Method not found"};
+}
+
+nlohmann::json MockExchange::placeOrder(const std::string& direction, const nlohmann::json& params,
+                                        std::vector<OrderEvent>& events) {
+    std::string instrument_name = requireParam(params, "instrument_name").get<std::string>();
+    auto book_it = books_.find(instrument_name);
+    if (book_it == books_.end()) {
+        throw RpcError{-32602, "Invalid params: unknown instrument " + instrument_name};
+    }
+    const Book& book = book_it->second;
+
+    double amount = requireParam(params, "amount").get<double>();
+    if (amount <= 0.0) {
+        throw RpcError{-32602, "Invalid params: amount must be positive"};
+    }
+    std::string type = params.value("type", std::string("limit"));
+    if (type != "limit" && type != "market") {
+        throw RpcError{-32602, "Invalid params: unsupported order type " + type};
+    }
+
+    bool is_buy = direction == "buy";
+    int64_t touch = is_buy ? book.asks.begin()->first : book.bids.rbegin()->first;
+    double price = type == "market" ? toPrice(touch, book.tick_size) : requireParam(params, "price").get<double>();
+
+    int64_t now = nowMs();
+    std::string order_id = "MOCK-" + std::to_string(next_order_id_++);
+    nlohmann::json order = {
+        {"order_id", order_id},
+        {"instrument_name", instrument_name},
+        {"direction", direction},
+        {"amount", amount},
+        {"filled_amount", 0.0},
+        {"price", price},
+        {"average_price", 0.0},
+        {"order_type", type},
+        {"order_state", "open"},
+        {"time_in_force", params.value("time_in_force", std::string("good_til_cancelled"))},
+        {"post_only", params.value("post_only", false)},
+        {"reduce_only", params.value("reduce_only", false)},
+        {"label", params.value("label", std::string())},
+        {"creation_timestamp", now},
+        {"last_update_timestamp", now},
+        {"replaced", false},
+        {"api", true}
+    };
+
+    int64_t limit = toTicks(price, book.tick_size);
+    bool crosses = is_buy ? limit >= touch : limit <= touch;
+    if (crosses && order["post_only"].get<bool>()) {
+        throw RpcError{11054, "post_only_reject"};
+    }
+
+    nlohmann::json& stored = orders_[order_id] = order;
+    if (crosses) {
+        events.push_back(fill(stored, toPrice(touch, book.tick_size)));
+    } else {
+        events.push_back({stored, nlohmann::json::array(), nullptr});
+    }
+    return {{"order", stored}, {"trades", events.back().trades}};
+}
+
+MockExchange::OrderEvent MockExchange::fill(nlohmann::json& order, double price) {
+    std::string instrument_name = order["instrument_name"].get<std::string>();
+    bool is_buy = order["direction"] == "buy";
+    double amount = order["amount"].get<double>() - order["filled_amount"].get<double>();
+    int64_t now = nowMs();
+
+    order["filled_amount"] = order["amount"];
+    order["average_price"] = price;
+    order["order_state"] = "filled";
+    order["last_update_timestamp"] = now;
+
+    // Average in while adding to the position, realize PnL while reducing it
+    Position& position = positions_[instrument_name];
+    double delta = is_buy ? amount : -amount;
+    if (position.size == 0.0 || (position.size > 0.0) == (delta > 0.0)) {
+        double size = position.size + delta;
+        position.average_price = (position.average_price * std::fabs(position.size) + price * amount) / std::fabs(size);
+        position.size = size;
+    } else {
+        double closed = std::min(std::fabs(delta), std::fabs(position.size));
+        double sign = position.size > 0.0 ? 1.0 : -1.0;
+        position.realized_pnl += sign * closed * (1.0 / position.average_price - 1.0 / price);
+        position.size += delta;
+        if (position.size == 0.0) {
+            position.average_price = 0.0;
+        } else if ((position.size > 0.0) != (sign > 0.0)) {
+            position.average_price = price;
+        }
+    }
+
+    const Book& book = books_.at(instrument_name);
+    nlohmann::json trade = {
+        {"trade_id", "MOCK-T" + std::to_string(next_trade_id_++)},
+        {"trade_seq", ++books_.at(instrument_name).trade_seq},
+        {"order_id", order["order_id"]},
+        {"instrument_name", instrument_name},
+        {"direction", order["direction"]},
+        {"amount", amount},
+        {"price", price},
+        {"index_price", toPrice(book.mid, book.tick_size)},
+        {"mark_price", toPrice(book.mid, book.tick_size)},
+        {"label", order["label"]},
+        {"liquidity", "T"},
+        {"fee", 0.0},
+        {"fee_currency", currencyOf(instrument_name)},
+        {"state", "filled"},
+        {"timestamp", now}
+    };
+    return {order, nlohmann::json::array({trade}), positionJson(instrument_name)};
+}
+
+size_t MockExchange::cancelWhere(const std::function<bool(const nlohmann::json&)>& match,
+                                 std::vector<OrderEvent>& events) {
+    size_t cancelled = 0;
+    int64_t now = nowMs();
+    for (auto& entry : orders_) {
+        nlohmann::json& order = entry.second;
+        if (order["order_state"] == "open" && match(order)) {
+            order["order_state"] = "cancelled";
+            order["last_update_timestamp"] = now;
+            events.push_back({order, nlohmann::json::array(), nullptr});
+            ++cancelled;
+        }
+    }
+    return cancelled;
+}
+
+nlohmann::json MockExchange::instrumentJson(const std::string& instrument_name) const {
+    InstrumentSpec spec = specFor(instrument_name);
+    std::string currency = currencyOf(instrument_name);
+    return {
+        {"instrument_name", instrument_name},
+        {"kind", "future"},
+        {"base_currency", currency},
+        {"quote_currency", "USD"},
+        {"settlement_currency", currency},
+        {"settlement_period", "perpetual"},
+        {"tick_size", spec.tick_size},
+        {"min_trade_amount", spec.min_trade_amount},
+        {"contract_size", spec.contract_size},
+        {"expiration_timestamp", int64_t(32503680000000)},
+        {"creation_timestamp", int64_t(1534167754000)},
+        {"is_active", true}
+    };
+}
+
+nlohmann::json MockExchange::positionJson(const std::string& instrument_name) const {
+    const Position& position = positions_.at(instrument_name);
+    const Book& book = books_.at(instrument_name);
+    double mark = toPrice(book.mid, book.tick_size);
+    double size_currency = position.size / mark;
+    double floating = position.average_price > 0.0
+        ? position.size * (1.0 / position.average_price - 1.0 / mark) : 0.0;
+    return {
+        {"instrument_name", instrument_name},
+        {"kind", "future"},
+        {"direction", position.size > 0.0 ? "buy" : position.size < 0.0 ? "sell" : "zero"},
+        {"size", position.size},
+        {"size_currency", size_currency},
+        {"average_price", position.average_price},
+        {"mark_price", mark},
+        {"index_price", mark},
+        {"delta", size_currency},
+        {"floating_profit_loss", floating},
+        {"realized_profit_loss", position.realized_pnl},
+        {"total_profit_loss", floating + position.realized_pnl},
+        {"initial_margin", std::fabs(size_currency) * 0.02},
+        {"maintenance_margin", std::fabs(size_currency) * 0.01},
+        {"estimated_liquidation_price", nullptr},
+        {"leverage", 50}
+    };
+}
+
+nlohmann::json MockExchange::orderBookJson(const std::string& instrument_name, size_t depth) const {
+    const Book& book = books_.at(instrument_name);
+    nlohmann::json bids = nlohmann::json::array();
+    for (auto it = book.bids.rbegin(); it != book.bids.rend() && bids.size() < depth; ++it) {
+        bids.push_back({toPrice(it->first, book.tick_size), it->second});
+    }
+    nlohmann::json asks = nlohmann::json::array();
+    for (auto it = book.asks.begin(); it != book.asks.end() && asks.size() < depth; ++it) {
+        asks.push_back({toPrice(it->first, book.tick_size), it->second});
+    }
+    double mid = toPrice(book.mid, book.tick_size);
+    return {
+        {"instrument_name", instrument_name},
+        {"timestamp", nowMs()},
+        {"change_id", book.change_id},
+        {"state", "open"},
+        {"bids", bids},
+        {"asks", asks},
+        {"best_bid_price", toPrice(book.bids.rbegin()->first, book.tick_size)},
+        {"best_bid_amount", book.bids.rbegin()->second},
+        {"best_ask_price", toPrice(book.asks.begin()->first, book.tick_size)},
+        {"best_ask_amount", book.asks.begin()->second},
+        {"mark_price", mid},
+        {"index_price", mid},
+        {"last_price", mid}
+    };
+}
+
+nlohmann::json MockExchange::bookSnapshot(const std::string& instrument_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Book& book = books_.at(instrument_name);
+    nlohmann::json bids = nlohmann::json::array();
+    for (auto it = book.bids.rbegin(); it != book.bids.rend(); ++it) {
+        bids.push_back({"new", toPrice(it->first, book.tick_size), it->second});
+    }
+    nlohmann::json asks = nlohmann::json::array();
+    for (const auto& level : book.asks) {
+        asks.push_back({"new", toPrice(level.first, book.tick_size), level.second});
+    }
+    return {
+        {"type", "snapshot"},
+        {"timestamp", nowMs()},
+        {"instrument_name", instrument_name},
+        {"change_id", book.change_id},
+        {"bids", bids},
+        {"asks", asks}
+    };
+}
+
+nlohmann::json MockExchange::bookChange(const std::string& instrument_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Book& book = books_.at(instrument_name);
+    InstrumentSpec spec = specFor(instrument_name);
+    int64_t depth = static_cast<int64_t>(scenario_.book_depth);
+    auto randomAmount = [&]() {
+        return spec.min_trade_amount * static_cast<double>(1 + rng_() % 500);
+    };
+
+    nlohmann::json bids = nlohmann::json::array();
+    nlohmann::json asks = nlohmann::json::array();
+    if (rng_() % 10 < 7) {
+        // Resize one level somewhere in the ladder
+        bool bid_side = rng_() % 2 == 0;
+        int64_t level = 1 + static_cast<int64_t>(rng_() % static_cast<uint64_t>(depth));
+        int64_t tick = bid_side ? book.mid - level : book.mid + level;
+        double amount = randomAmount();
+        (bid_side ? book.bids : book.asks)[tick] = amount;
+        (bid_side ? bids : asks).push_back({"change", toPrice(tick, book.tick_size), amount});
+    } else if (rng_() % 2 == 0) {
+        // Mid ticks up: the best ask is taken out and a bid joins at the old mid
+        double bid_amount = randomAmount();
+        double ask_amount = randomAmount();
+        book.bids[book.mid] = bid_amount;
+        book.bids.erase(book.mid - depth);
+        book.asks.erase(book.mid + 1);
+        book.asks[book.mid + depth + 1] = ask_amount;
+        bids.push_back({"new", toPrice(book.mid, book.tick_size), bid_amount});
+        bids.push_back({"delete", toPrice(book.mid - depth, book.tick_size), 0.0});
+        asks.push_back({"delete", toPrice(book.mid + 1, book.tick_size), 0.0});
+        asks.push_back({"new", toPrice(book.mid + depth + 1, book.tick_size), ask_amount});
+        ++book.mid;
+    } else {
+        // Mid ticks down, mirrored
+        double bid_amount = randomAmount();
+        double ask_amount = randomAmount();
+        book.asks[book.mid] = ask_amount;
+        book.asks.erase(book.mid + depth);
+        book.bids.erase(book.mid - 1);
+        book.bids[book.mid - depth - 1] = bid_amount;
+        asks.push_back({"new", toPrice(book.mid, book.tick_size), ask_amount});
+        asks.push_back({"delete", toPrice(book.mid + depth, book.tick_size), 0.0});
+        bids.push_back({"delete", toPrice(book.mid - 1, book.tick_size), 0.0});
+        bids.push_back({"new", toPrice(book.mid - depth - 1, book.tick_size), bid_amount});
+        --book.mid;
+    }
+
+    int64_t prev_change_id = book.change_id++;
+    return {
+        {"type", "change"},
+        {"timestamp", nowMs()},
+        {"prev_change_id", prev_change_id},
+        {"instrument_name", instrument_name},
+        {"change_id", book.change_id},
+        {"bids", bids},
+        {"asks", asks}
+    };
+}
+
+nlohmann::json MockExchange::publicTrade(const std::string& instrument_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Book& book = books_.at(instrument_name);
+    InstrumentSpec spec = specFor(instrument_name);
+    bool is_buy = rng_() % 2 == 0;
+    double price = toPrice(is_buy ? book.asks.begin()->first : book.bids.rbegin()->first, book.tick_size);
+    double mid = toPrice(book.mid, book.tick_size);
+    nlohmann::json trade = {
+        {"trade_seq", ++book.trade_seq},
+        {"trade_id", "MOCK-T" + std::to_string(next_trade_id_++)},
+        {"timestamp", nowMs()},
+        {"tick_direction", is_buy ? 0 : 2},
+        {"price", price},
+        {"mark_price", mid},
+        {"index_price", mid},
+        {"instrument_name", instrument_name},
+        {"direction", is_buy ? "buy" : "sell"},
+        {"amount", spec.min_trade_amount * static_cast<double>(1 + rng_() % 20)}
+    };
+    return nlohmann::json::array({trade});
+}
+
+void MockExchange::seedBook(const std::string& instrument_name, Book& book) {
+    InstrumentSpec spec = specFor(instrument_name);
+    book.tick_size = spec.tick_size;
+    book.mid = toTicks(spec.price, spec.tick_size);
+    book.change_id = static_cast<int64_t>(rng_() % 1000000000) + 1;
+    int64_t depth = static_cast<int64_t>(scenario_.book_depth);
+    for (int64_t level = 1; level <= depth; ++level) {
+        book.bids[book.mid - level] = spec.min_trade_amount * static_cast<double>(1 + rng_() % 500);
+        book.asks[book.mid + level] = spec.min_trade_amount * static_cast<double>(1 + rng_() % 500);
+    }
+}
+
+std::string MockExchange::currencyOf(const std::string& instrument_name) {
+    return instrument_name.substr(0, instrument_name.find('-'));
+}
+
+} // namespace mock
+} // namespace deribit
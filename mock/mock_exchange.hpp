@@ -0,0 +1,148 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+#include "scenario.hpp"
+
+namespace deribit {
+namespace mock {
+
+/**
+ * @brief Exchange state shared by the mock's WebSocket and REST front ends
+ *
+ * Answers the JSON-RPC subset the client uses and generates the market data
+ * the WebSocket server streams. Books are a contiguous ladder of levels
+ * either side of a mid that random-walks one tick at a time. Market orders
+ * and limit orders that cross fill at the touch in full; other limit orders
+ * rest until edited or cancelled. Thread safe.
+ */
+class MockExchange {
+public:
+    // Receives user.orders, user.trades and user.changes style events after an order changes
+    using OrderListener = std::function<void(const nlohmann::json& order, const nlohmann::json& trades,
+                                             const nlohmann::json& position)>;
+
+    /**
+     * @brief Constructor
+     * @param scenario The instruments, depth, clock offset and seed to serve
+     */
+    explicit MockExchange(const MockScenario& scenario);
+
+    /**
+     * @brief Set the listener told about order changes from either front end
+     * @param listener The listener; called without the exchange lock held
+     */
+    void setOrderListener(OrderListener listener);
+
+    /**
+     * @brief Answer a JSON-RPC request
+     * @param request The request; the id is echoed back
+     * @param authenticated Whether the caller presented credentials; private methods need them
+     * @return The JSON-RPC response
+     */
+    nlohmann::json respond(const nlohmann::json& request, bool authenticated);
+
+    /**
+     * @brief Check if a method needs credentials
+     * @param method The method (e.g., "private/buy")
+     * @return true for private methods, false otherwise
+     */
+    static bool isPrivate(const std::string& method) { return method.compare(0, 8, "private/") == 0; }
+
+    /**
+     * @brief Get the exchange clock
+     * @return Milliseconds since epoch, including the scenario's clock offset
+     */
+    int64_t nowMs() const;
+
+    /**
+     * @brief Check if an instrument is served
+     * @param instrument_name The instrument name
+     * @return true if served, false otherwise
+     */
+    bool hasInstrument(const std::string& instrument_name) const;
+
+    /**
+     * @brief Get the instruments served
+     * @return The instrument names
+     */
+    std::vector<std::string> getInstrumentNames() const;
+
+    /**
+     * @brief Build a book.* snapshot notification for the current book
+     * @param instrument_name The instrument name
+     * @return The notification data
+     */
+    nlohmann::json bookSnapshot(const std::string& instrument_name);
+
+    /**
+     * @brief Move the book one step and build the matching book.* change notification
+     * @param instrument_name The instrument name
+     * @return The notification data
+     */
+    nlohmann::json bookChange(const std::string& instrument_name);
+
+    /**
+     * @brief Generate a public trade at the touch and build its trades.* notification
+     * @param instrument_name The instrument name
+     * @return The notification data
+     */
+    nlohmann::json publicTrade(const std::string& instrument_name);
+
+private:
+    struct Book {
+        double tick_size{0.5};
+        int64_t mid{0};                       // In ticks
+        std::map<int64_t, double> bids;       // Tick to amount
+        std::map<int64_t, double> asks;
+        int64_t change_id{0};
+        uint64_t trade_seq{0};
+    };
+
+    struct OrderEvent {
+        nlohmann::json order;
+        nlohmann::json trades;                // Array; empty unless the change was a fill
+        nlohmann::json position;              // Null unless the change was a fill
+    };
+
+    struct Position {
+        double size{0.0};                     // Signed; positive is long
+        double average_price{0.0};
+        double realized_pnl{0.0};
+    };
+
+    MockScenario scenario_;
+    OrderListener listener_;
+
+    mutable std::mutex mutex_;
+    std::mt19937_64 rng_;
+    std::unordered_map<std::string, Book> books_;
+    std::unordered_map<std::string, nlohmann::json> orders_;
+    std::unordered_map<std::string, Position> positions_;
+    uint64_t next_order_id_{1};
+    uint64_t next_trade_id_{1};
+    uint64_t next_token_{1};
+
+    // Internal methods; called with mutex_ held
+    nlohmann::json call(const std::string& method, const nlohmann::json& params, std::vector<OrderEvent>& events);
+    nlohmann::json placeOrder(const std::string& direction, const nlohmann::json& params,
+                              std::vector<OrderEvent>& events);
+    OrderEvent fill(nlohmann::json& order, double price);
+    nlohmann::json instrumentJson(const std::string& instrument_name) const;
+    nlohmann::json positionJson(const std::string& instrument_name) const;
+    nlohmann::json orderBookJson(const std::string& instrument_name, size_t depth) const;
+    size_t cancelWhere(const std::function<bool(const nlohmann::json&)>& match, std::vector<OrderEvent>& events);
+    void seedBook(const std::string& instrument_name, Book& book);
+    static std::string currencyOf(const std::string& instrument_name);
+};
+
+} // namespace mock
+} // namespace deribit
@@ -0,0 +1,307 @@
+#include "rest_server.hpp"
+#include "deribit/logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <set>
+
+namespace deribit {
+namespace mock {
+
+namespace {
+
+constexpr const char* kBasePath = "/api/v2";
+constexpr size_t kMaxHeaderSize = 16384;
+
+// Form and query values that must stay strings even when they look numeric
+const std::set<std::string> kStringParams = {
+    "label", "order_id", "client_id", "client_secret", "refresh_token", "access_token"
+};
+
+std::string toLower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+std::string urlDecode(const std::string& value) {
+    std::string decoded;
+    decoded.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '+') {
+            decoded += ' ';
+        } else if (value[i] == '%' && i + 2 < value.size() &&
+                   std::isxdigit(static_cast<unsigned char>(value[i + 1])) &&
+                   std::isxdigit(static_cast<unsigned char>(value[i + 2]))) {
+            decoded += static_cast<char>(std::strtol(value.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else {
+            decoded += value[i];
+        }
+    }
+    return decoded;
+}
+
+// Form and query strings carry every value as text; restore numbers and booleans
+nlohmann::json parseForm(const std::string& form) {
+    nlohmann::json params = nlohmann::json::object();
+    size_t start = 0;
+    while (start < form.size()) {
+        size_t end = form.find('&', start);
+        if (end == std::string::npos) {
+            end = form.size();
+        }
+        std::string pair = form.substr(start, end - start);
+        start = end + 1;
+        if (pair.empty()) {
+            continue;
+        }
+
+        size_t eq = pair.find('=');
+        std::string key = urlDecode(pair.substr(0, eq));
+        std::string value = eq == std::string::npos ? std::string() : urlDecode(pair.substr(eq + 1));
+        if (kStringParams.count(key) > 0) {
+            params[key] = value;
+        } else if (value == "true" || value == "false") {
+            params[key] = value == "true";
+        } else {
+            char* parsed_end = nullptr;
+            double number = std::strtod(value.c_str(), &parsed_end);
+            if (!value.empty() && parsed_end == value.c_str() + value.size()) {
+                params[key] = number;
+            } else {
+                params[key] = value;
+            }
+        }
+    }
+    return params;
+}
+
+std::string httpResponse(int status, const std::string& body, bool keep_alive) {
+    const char* reason = status == 200 ? "OK" : status == 400 ? "Bad Request" :
+                         status == 404 ? "Not Found" : "Method Not Allowed";
+    return "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n"
+           "Content-Type: application/json\r\n"
+           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+           "Connection: " + (keep_alive ? "keep-alive" : "close") + "\r\n"
+           "\r\n" + body;
+}
+
+} // namespace
+
+struct RestServer::Connection {
+    explicit Connection(asio::ip::tcp::socket s)
+        : socket(std::move(s))
+        , buffer(kMaxHeaderSize + (1 << 20))
+        , timer(socket.get_executor()) {}
+    asio::ip::tcp::socket socket;
+    asio::streambuf buffer;
+    asio::steady_timer timer;
+    std::string response;
+    bool keep_alive{true};
+};
+
+RestServer::RestServer(MockExchange& exchange, const MockScenario& scenario)
+    : exchange_(exchange)
+    , scenario_(scenario)
+    , acceptor_(io_context_)
+    , jitter_rng_(scenario.seed + 1) {
+}
+
+RestServer::~RestServer() {
+    stop();
+}
+
+bool RestServer::start() {
+    if (running_) {
+        return true;
+    }
+
+    try {
+        asio::ip::tcp::endpoint endpoint(asio::ip::make_address("127.0.0.1"), scenario_.rest_port);
+        acceptor_.open(endpoint.protocol());
+        acceptor_.set_option(asio::ip::tcp::acceptor::reuse_address(true));
+        acceptor_.bind(endpoint);
+        acceptor_.listen();
+    } catch (const std::exception& e) {
+        DERIBIT_LOG_ERROR("Error starting mock REST server on port {}: {}", scenario_.rest_port, e.what());
+        acceptor_.close();
+        return false;
+    }
+
+    started_ = std::chrono::steady_clock::now();
+    accept();
+    io_context_.restart();
+    thread_ = std::thread([this]() { io_context_.run(); });
+    running_ = true;
+    DERIBIT_LOG_INFO("Mock REST API on http://127.0.0.1:{}{}", scenario_.rest_port, kBasePath);
+    return true;
+}
+
+void RestServer::stop() {
+    if (!running_) {
+        return;
+    }
+
+    // Stopping the context abandons open connections; their sockets close with the handlers
+    io_context_.stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    asio::error_code ec;
+    acceptor_.close(ec);
+    running_ = false;
+}
+
+void RestServer::accept() {
+    acceptor_.async_accept([this](const asio::error_code& ec, asio::ip::tcp::socket socket) {
+        if (ec) {
+            if (ec != asio::error::operation_aborted) {
+                DERIBIT_LOG_ERROR("Error accepting mock REST connection: {}", ec.message());
+            }
+            return;
+        }
+        asio::error_code ignored;
+        socket.set_option(asio::ip::tcp::no_delay(true), ignored);
+        readRequest(std::make_shared<Connection>(std::move(socket)));
+        accept();
+    });
+}
+
+void RestServer::readRequest(std::shared_ptr<Connection> connection) {
+    asio::async_read_until(connection->socket, connection->buffer, "\r\n\r\n",
+        [this, connection](const asio::error_code& ec, size_t header_bytes) {
+            if (ec) {
+                return;
+            }
+            std::string head(asio::buffers_begin(connection->buffer.data()),
+                             asio::buffers_begin(connection->buffer.data()) + header_bytes);
+            connection->buffer.consume(header_bytes);
+
+            size_t content_length = 0;
+            std::string lower_head = toLower(head);
+            size_t pos = lower_head.find("\r\ncontent-length:");
+            if (pos != std::string::npos) {
+                content_length = std::strtoul(head.c_str() + pos + 17, nullptr, 10);
+            }
+
+            // Part of the body may already be buffered behind the headers
+            size_t buffered = connection->buffer.size();
+            size_t missing = content_length > buffered ? content_length - buffered : 0;
+            asio::async_read(connection->socket, connection->buffer, asio::transfer_exactly(missing),
+                [this, connection, head, content_length](const asio::error_code& body_ec, size_t) {
+                    if (body_ec) {
+                        return;
+                    }
+                    std::string body(asio::buffers_begin(connection->buffer.data()),
+                                     asio::buffers_begin(connection->buffer.data()) + content_length);
+                    connection->buffer.consume(content_length);
+                    reply(connection, head, body);
+                });
+        });
+}
+
+void RestServer::reply(std::shared_ptr<Connection> connection, const std::string& head, const std::string& body) {
+    connection->response = handle(head, body, connection->keep_alive);
+
+    auto write = [this, connection]() {
+        asio::async_write(connection->socket, asio::buffer(connection->response),
+            [this, connection](const asio::error_code& ec, size_t) {
+                if (ec) {
+                    return;
+                }
+                if (connection->keep_alive) {
+                    readRequest(connection);
+                } else {
+                    asio::error_code ignored;
+                    connection->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+                }
+            });
+    };
+
+    std::chrono::microseconds delay = replyDelay();
+    if (delay.count() == 0) {
+        write();
+        return;
+    }
+    connection->timer.expires_after(delay);
+    connection->timer.async_wait([write](const asio::error_code& ec) {
+        if (!ec) {
+            write();
+        }
+    });
+}
+
+std::string RestServer::handle(const std::string& head, const std::string& body, bool& keep_alive) {
+    // Request line: METHOD SP TARGET SP VERSION
+    size_t method_end = head.find(' ');
+    size_t target_end = method_end == std::string::npos ? std::string::npos : head.find(' ', method_end + 1);
+    if (target_end == std::string::npos) {
+        keep_alive = false;
+        return httpResponse(400, "{\"error\":{\"code\":-32700,\"message\":\"Bad Request\"}}", false);
+    }
+    std::string http_method = head.substr(0, method_end);
+    std::string target = head.substr(method_end + 1, target_end - method_end - 1);
+
+    std::string lower_head = toLower(head);
+    keep_alive = lower_head.find("\r\nconnection: close") == std::string::npos;
+    bool authenticated = lower_head.find("\r\nauthorization: bearer ") != std::string::npos;
+    bool form_body = lower_head.find("application/x-www-form-urlencoded") != std::string::npos;
+
+    size_t query_start = target.find('?');
+    std::string path = target.substr(0, query_start);
+    std::string query = query_start == std::string::npos ? std::string() : target.substr(query_start + 1);
+    std::string base = kBasePath;
+    if (path != base && path.compare(0, base.size() + 1, base + "/") != 0) {
+        return httpResponse(404, "{\"error\":{\"code\":-32601,\"message\":\"Not Found\"}}", keep_alive);
+    }
+    std::string rpc_method = path.size() > base.size() + 1 ? path.substr(base.size() + 1) : std::string();
+
+    nlohmann::json request;
+    if (http_method == "POST" && rpc_method.empty()) {
+        // JSON-RPC envelope in the body
+        request = nlohmann::json::parse(body, nullptr, false);
+        if (request.is_discarded() || !request.is_object()) {
+            return httpResponse(400, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32700,\"message\":\"Parse error\"}}",
+                keep_alive);
+        }
+    } else if ((http_method == "POST" || http_method == "GET") && !rpc_method.empty()) {
+        nlohmann::json params;
+        if (http_method == "GET") {
+            params = parseForm(query);
+        } else if (form_body) {
+            params = parseForm(body);
+        } else {
+            params = body.empty() ? nlohmann::json::object() : nlohmann::json::parse(body, nullptr, false);
+            if (params.is_discarded()) {
+                return httpResponse(400, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32700,\"message\":\"Parse error\"}}",
+                    keep_alive);
+            }
+        }
+        request = {{"jsonrpc", "2.0"}, {"method", rpc_method}, {"params", params}};
+    } else if (http_method == "GET" || http_method == "POST") {
+        return httpResponse(400, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32600,\"message\":\"Invalid Request\"}}",
+            keep_alive);
+    } else {
+        return httpResponse(405, "{\"error\":{\"code\":-32600,\"message\":\"Method Not Allowed\"}}", keep_alive);
+    }
+
+    nlohmann::json response = exchange_.respond(request, authenticated);
+    return httpResponse(response.contains("error") ? 400 : 200, response.dump(), keep_alive);
+}
+
+std::chrono::microseconds RestServer::replyDelay() {
+    uint64_t index = 0;
+    const MockPhase* phase = scenario_.phaseAt(std::chrono::steady_clock::now() - started_, index);
+    if (!phase) {
+        return std::chrono::microseconds(0);
+    }
+    std::chrono::microseconds delay = phase->latency;
+    if (phase->jitter.count() > 0) {
+        delay += std::chrono::microseconds(jitter_rng_() % static_cast<uint64_t>(phase->jitter.count() + 1));
+    }
+    return delay;
+}
+
+} // namespace mock
+} // namespace deribit
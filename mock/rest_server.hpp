@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <thread>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+#define ASIO_STANDALONE
+#include <asio.hpp>
+
+#include "mock_exchange.hpp"
+#include "scenario.hpp"
+
+namespace deribit {
+namespace mock {
+
+/**
+ * @brief Mock of Deribit's HTTP API
+ *
+ * Plain HTTP/1.1 with keep-alive on localhost; point the client at it with
+ * Config::setRestApiUrl("http://127.0.0.1:<port>/api/v2"). Accepts the three
+ * shapes the client sends: a JSON-RPC body POSTed to /api/v2, a JSON or form
+ * body POSTed to /api/v2/<method> and GET /api/v2/<method>?<query>. A Bearer
+ * Authorization header counts as authenticated. Replies are held back by the
+ * active phase's latency and jitter.
+ */
+class RestServer {
+public:
+    /**
+     * @brief Constructor
+     * @param exchange The exchange to serve
+     * @param scenario The port and phases to run
+     */
+    RestServer(MockExchange& exchange, const MockScenario& scenario);
+
+    /**
+     * @brief Destructor
+     */
+    ~RestServer();
+
+    /**
+     * @brief Bind the port and start the I/O thread
+     * @return true if the listener started, false otherwise
+     */
+    bool start();
+
+    /**
+     * @brief Stop accepting, close open connections and join the I/O thread
+     */
+    void stop();
+
+private:
+    struct Connection;
+
+    MockExchange& exchange_;
+    MockScenario scenario_;
+    asio::io_context io_context_;
+    asio::ip::tcp::acceptor acceptor_;
+    std::thread thread_;
+    bool running_{false};
+    std::chrono::steady_clock::time_point started_;
+    std::mt19937_64 jitter_rng_;
+
+    // Internal methods
+    void accept();
+    void readRequest(std::shared_ptr<Connection> connection);
+    void reply(std::shared_ptr<Connection> connection, const std::string& head, const std::string& body);
+    std::string handle(const std::string& head, const std::string& body, bool& keep_alive);
+    std::chrono::microseconds replyDelay();
+};
+
+} // namespace mock
+} // namespace deribit
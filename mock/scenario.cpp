@@ -0,0 +1,82 @@
+#include "scenario.hpp"
+#include "deribit/logger.hpp"
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+namespace mock {
+
+bool MockScenario::load(const std::string& path, MockScenario& scenario) {
+    std::ifstream file(path);
+    if (!file) {
+        DERIBIT_LOG_ERROR("Failed to open scenario {}", path);
+        return false;
+    }
+
+    try {
+        nlohmann::json json = nlohmann::json::parse(file);
+        scenario.ws_port = json.value("ws_port", scenario.ws_port);
+        scenario.rest_port = json.value("rest_port", scenario.rest_port);
+        scenario.instruments = json.value("instruments", scenario.instruments);
+        scenario.book_depth = json.value("book_depth", scenario.book_depth);
+        scenario.clock_offset_ms = json.value("clock_offset_ms", scenario.clock_offset_ms);
+        scenario.seed = json.value("seed", scenario.seed);
+        scenario.loop = json.value("loop", scenario.loop);
+
+        if (json.contains("phases")) {
+            scenario.phases.clear();
+            for (const auto& entry : json["phases"]) {
+                MockPhase phase;
+                phase.name = entry.value("name", "phase" + std::to_string(scenario.phases.size() + 1));
+                phase.duration = std::chrono::milliseconds(entry.value("duration_ms", int64_t(10000)));
+                phase.book_rate = entry.value("book_rate", phase.book_rate);
+                phase.trade_rate = entry.value("trade_rate", phase.trade_rate);
+                phase.latency = std::chrono::microseconds(entry.value("latency_us", int64_t(0)));
+                phase.jitter = std::chrono::microseconds(entry.value("jitter_us", int64_t(0)));
+                phase.gap_every = entry.value("gap_every", phase.gap_every);
+                phase.disconnect = entry.value("disconnect", phase.disconnect);
+                scenario.phases.push_back(phase);
+            }
+        }
+    } catch (const nlohmann::json::exception& e) {
+        DERIBIT_LOG_ERROR("Invalid scenario {}: {}", path, e.what());
+        return false;
+    }
+
+    if (scenario.phases.empty() || scenario.instruments.empty()) {
+        DERIBIT_LOG_ERROR("Scenario {} needs at least one phase and one instrument", path);
+        return false;
+    }
+    return true;
+}
+
+const MockPhase* MockScenario::phaseAt(std::chrono::steady_clock::duration elapsed, uint64_t& index) const {
+    std::chrono::steady_clock::duration cycle{0};
+    for (const auto& phase : phases) {
+        cycle += phase.duration;
+    }
+    if (cycle <= std::chrono::steady_clock::duration::zero()) {
+        index = 0;
+        return &phases.front();
+    }
+
+    uint64_t cycles = static_cast<uint64_t>(elapsed / cycle);
+    if (cycles > 0 && !loop) {
+        index = phases.size();
+        return nullptr;
+    }
+
+    auto offset = elapsed % cycle;
+    for (size_t i = 0; i < phases.size(); ++i) {
+        if (offset < phases[i].duration) {
+            index = cycles * phases.size() + i;
+            return &phases[i];
+        }
+        offset -= phases[i].duration;
+    }
+    index = cycles * phases.size() + phases.size() - 1;
+    return &phases.back();
+}
+
+} // namespace mock
+} // namespace deribit
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace deribit {
+namespace mock {
+
+/**
+ * @brief One stretch of a mock scenario with fixed rates and impairments
+ */
+struct MockPhase {
+    std::string name{"default"};
+    std::chrono::milliseconds duration{10000};
+    double book_rate{100.0};                // Book changes per second per instrument
+    double trade_rate{10.0};                // Trade notifications per second per instrument
+    std::chrono::microseconds latency{0};   // Added to every WebSocket and REST reply
+    std::chrono::microseconds jitter{0};    // Extra uniform delay in [0, jitter]; frames stay in order
+    uint32_t gap_every{0};                  // Drop every Nth book change so change ids skip; 0 disables
+    bool disconnect{false};                 // Close every WebSocket connection when the phase ends
+};
+
+/**
+ * @brief What the mock exchange serves and how its feed behaves over time
+ *
+ * Phases run in order and repeat when loop is set. Loaded from JSON:
+ *
+ *     {
+ *       "ws_port": 8443, "rest_port": 8080,
+ *       "instruments": ["BTC-PERPETUAL", "ETH-PERPETUAL"],
+ *       "book_depth": 20, "clock_offset_ms": 0, "seed": 1, "loop": true,
+ *       "phases": [
+ *         {"name": "steady", "duration_ms": 10000, "book_rate": 100, "trade_rate": 10},
+ *         {"name": "burst", "duration_ms": 2000, "book_rate": 5000, "latency_us": 200, "jitter_us": 100},
+ *         {"name": "lossy", "duration_ms": 5000, "gap_every": 50, "disconnect": true}
+ *       ]
+ *     }
+ */
+struct MockScenario {
+    uint16_t ws_port{8443};
+    uint16_t rest_port{8080};
+    std::vector<std::string> instruments{"BTC-PERPETUAL", "ETH-PERPETUAL"};
+    size_t book_depth{20};                  // Levels per side
+    int64_t clock_offset_ms{0};             // Exchange clock minus local clock, for time sync testing
+    uint32_t seed{1};                       // Feed generation is deterministic for a given seed
+    bool loop{true};
+    std::vector<MockPhase> phases{MockPhase()};
+
+    /**
+     * @brief Load a scenario from a JSON file; missing fields keep their defaults
+     * @param path The file path
+     * @param scenario Receives the scenario
+     * @return true if the file was read and parsed, false otherwise
+     */
+    static bool load(const std::string& path, MockScenario& scenario);
+
+    /**
+     * @brief Find the phase active a given time after the scenario started
+     * @param elapsed Time since start
+     * @param index Receives the phase's position in the run, counting repeats
+     * @return The phase, or nullptr once a non-looping scenario has finished
+     */
+    const MockPhase* phaseAt(std::chrono::steady_clock::duration elapsed, uint64_t& index) const;
+};
+
+} // namespace mock
+} // namespace deribit
@@ -0,0 +1,441 @@
+#include "ws_server.hpp"
+#include "deribit/logger.hpp"
+#include <algorithm>
+#include <openssl/evp.h>
+#include <openssl/ec.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+namespace deribit {
+namespace mock {
+
+namespace {
+
+// Interval of the feed generator; rates are accrued as credit between ticks
+constexpr std::chrono::milliseconds kFeedInterval(1);
+constexpr std::chrono::seconds kStatsInterval(5);
+
+// Never let a stalled loop build up more than this much catch-up traffic
+constexpr double kMaxCreditSeconds = 0.1;
+
+std::string readBio(BIO* bio) {
+    char* data = nullptr;
+    long size = BIO_get_mem_data(bio, &data);
+    return std::string(data, static_cast<size_t>(size));
+}
+
+std::string errorFrame(const nlohmann::json& id, int code, const std::string& message) {
+    nlohmann::json response = {
+        {"jsonrpc", "2.0"},
+        {"id", id},
+        {"error", {{"code", code}, {"message", message}}}
+    };
+    return response.dump();
+}
+
+} // namespace
+
+WsServer::WsServer(MockExchange& exchange, const MockScenario& scenario)
+    : exchange_(exchange)
+    , scenario_(scenario)
+    , jitter_rng_(scenario.seed) {
+}
+
+WsServer::~WsServer() {
+    stop();
+}
+
+bool WsServer::start() {
+    if (running_) {
+        return true;
+    }
+    if (!generateCertificate()) {
+        return false;
+    }
+
+    try {
+        server_.clear_access_channels(websocketpp::log::alevel::all);
+        server_.clear_error_channels(websocketpp::log::elevel::all);
+        server_.init_asio();
+        server_.set_reuse_addr(true);
+        server_.set_tls_init_handler(
+            std::bind(&WsServer::onTlsInit, this, std::placeholders::_1));
+        server_.set_open_handler(
+            std::bind(&WsServer::onOpen, this, std::placeholders::_1));
+        server_.set_close_handler(
+            std::bind(&WsServer::onClose, this, std::placeholders::_1));
+        server_.set_message_handler(
+            std::bind(&WsServer::onMessage, this,
+                std::placeholders::_1,
+                std::placeholders::_2));
+
+        server_.listen(asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), scenario_.ws_port));
+        server_.start_accept();
+    } catch (const std::exception& e) {
+        DERIBIT_LOG_ERROR("Error starting mock WebSocket server on port {}: {}", scenario_.ws_port, e.what());
+        return false;
+    }
+
+    book_credit_.assign(scenario_.instruments.size(), 0.0);
+    trade_credit_.assign(scenario_.instruments.size(), 0.0);
+    started_ = last_tick_ = last_stats_ = Clock::now();
+    phase_ = scenario_.phaseAt(Clock::duration::zero(), phase_index_);
+    feed_timer_ = std::make_unique<asio::steady_timer>(server_.get_io_service());
+    scheduleFeed();
+
+    thread_ = std::thread([this]() { server_.run(); });
+    running_ = true;
+    DERIBIT_LOG_INFO("Mock WebSocket API on wss://127.0.0.1:{}/ws/api/v2, phase {}",
+        scenario_.ws_port, phase_ ? phase_->name : "none");
+    return true;
+}
+
+void WsServer::stop() {
+    if (!running_) {
+        return;
+    }
+
+    // Close handshakes need the I/O thread, so wind down there and let run() drain
+    asio::post(server_.get_io_service(), [this]() {
+        server_.stop_listening();
+        feed_timer_->cancel();
+        closeAll("mock exchange shutting down");
+    });
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    running_ = false;
+}
+
+void WsServer::publishOrderEvent(const nlohmann::json& order, const nlohmann::json& trades,
+                                 const nlohmann::json& position) {
+    if (!running_) {
+        return;
+    }
+
+    asio::post(server_.get_io_service(), [this, order, trades, position]() {
+        publish("user.orders.", order);
+        nlohmann::json changes = {
+            {"instrument_name", order["instrument_name"]},
+            {"orders", nlohmann::json::array({order})},
+            {"trades", trades},
+            {"positions", nlohmann::json::array()}
+        };
+        if (!trades.empty()) {
+            publish("user.trades.", trades);
+        }
+        if (!position.is_null()) {
+            changes["positions"].push_back(position);
+        }
+        publish("user.changes.", changes);
+    });
+}
+
+bool WsServer::generateCertificate() {
+    // Self-signed P-256 certificate for localhost, kept in memory only
+    EVP_PKEY* key = nullptr;
+    EVP_PKEY_CTX* key_ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    bool ok = key_ctx != nullptr &&
+              EVP_PKEY_keygen_init(key_ctx) > 0 &&
+              EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx, NID_X9_62_prime256v1) > 0 &&
+              EVP_PKEY_keygen(key_ctx, &key) > 0;
+    EVP_PKEY_CTX_free(key_ctx);
+
+    X509* cert = ok ? X509_new() : nullptr;
+    if (cert) {
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 365L * 24 * 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+            reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        ok = X509_sign(cert, key, EVP_sha256()) > 0;
+    }
+
+    if (ok) {
+        BIO* cert_bio = BIO_new(BIO_s_mem());
+        BIO* key_bio = BIO_new(BIO_s_mem());
+        ok = PEM_write_bio_X509(cert_bio, cert) > 0 &&
+             PEM_write_bio_PrivateKey(key_bio, key, nullptr, nullptr, 0, nullptr, nullptr) > 0;
+        if (ok) {
+            certificate_pem_ = readBio(cert_bio);
+            private_key_pem_ = readBio(key_bio);
+        }
+        BIO_free(cert_bio);
+        BIO_free(key_bio);
+    }
+
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    if (!ok) {
+        DERIBIT_LOG_ERROR("Failed to generate the mock TLS certificate");
+    }
+    return ok;
+}
+
+std::shared_ptr<asio::ssl::context> WsServer::onTlsInit(websocketpp::connection_hdl) {
+    auto ctx = std::make_shared<asio::ssl::context>(asio::ssl::context::tlsv12);
+    try {
+        ctx->set_options(
+            asio::ssl::context::default_workarounds |
+            asio::ssl::context::no_sslv2 |
+            asio::ssl::context::no_sslv3 |
+            asio::ssl::context::single_dh_use);
+        ctx->use_certificate_chain(asio::buffer(certificate_pem_));
+        ctx->use_private_key(asio::buffer(private_key_pem_), asio::ssl::context::pem);
+    } catch (const std::exception& e) {
+        DERIBIT_LOG_ERROR("Error in mock TLS initialization: {}", e.what());
+    }
+    return ctx;
+}
+
+void WsServer::onOpen(websocketpp::connection_hdl hdl) {
+    Session& session = sessions_[hdl];
+    session.timer = std::make_unique<asio::steady_timer>(server_.get_io_service());
+    DERIBIT_LOG_INFO("Mock client connected ({} open)", sessions_.size());
+}
+
+void WsServer::onClose(websocketpp::connection_hdl hdl) {
+    auto it = sessions_.find(hdl);
+    if (it != sessions_.end()) {
+        it->second.timer->cancel();
+        sessions_.erase(it);
+    }
+    DERIBIT_LOG_INFO("Mock client disconnected ({} open)", sessions_.size());
+}
+
+void WsServer::onMessage(websocketpp::connection_hdl hdl, Server::message_ptr msg) {
+    auto it = sessions_.find(hdl);
+    if (it == sessions_.end()) {
+        return;
+    }
+    Session& session = it->second;
+
+    nlohmann::json request = nlohmann::json::parse(msg->get_payload(), nullptr, false);
+    if (request.is_discarded() || !request.is_object()) {
+        send(hdl, session, errorFrame(nullptr, -32700, "Parse error"));
+        return;
+    }
+    nlohmann::json id = request.value("id", nlohmann::json());
+    std::string method = request.value("method", std::string());
+
+    if (method == "public/subscribe" || method == "private/subscribe" ||
+        method == "public/unsubscribe" || method == "private/unsubscribe") {
+        if (MockExchange::isPrivate(method) && !session.authenticated) {
+            send(hdl, session, errorFrame(id, 13009, "unauthorized"));
+            return;
+        }
+        const nlohmann::json* channels = nullptr;
+        if (request.contains("params") && request["params"].contains("channels") &&
+            request["params"]["channels"].is_array()) {
+            channels = &request["params"]["channels"];
+        }
+        if (!channels) {
+            send(hdl, session, errorFrame(id, -32602, "Invalid params"));
+            return;
+        }
+
+        bool subscribe = method.find("/subscribe") != std::string::npos;
+        nlohmann::json result = nlohmann::json::array();
+        std::vector<std::string> snapshots;
+        for (const auto& entry : *channels) {
+            if (!entry.is_string()) {
+                continue;
+            }
+            std::string channel = entry.get<std::string>();
+            if (subscribe) {
+                session.channels.insert(channel);
+                // A new book subscription starts from a full snapshot, as on the exchange
+                if (channel.compare(0, 5, "book.") == 0) {
+                    std::string instrument_name = channel.substr(5, channel.find('.', 5) - 5);
+                    if (exchange_.hasInstrument(instrument_name)) {
+                        snapshots.push_back(channel);
+                    }
+                }
+            } else {
+                session.channels.erase(channel);
+            }
+            result.push_back(channel);
+        }
+
+        nlohmann::json response = {{"jsonrpc", "2.0"}, {"id", id}, {"result", result}};
+        send(hdl, session, response.dump());
+        for (const auto& channel : snapshots) {
+            std::string instrument_name = channel.substr(5, channel.find('.', 5) - 5);
+            nlohmann::json notification = {
+                {"jsonrpc", "2.0"},
+                {"method", "subscription"},
+                {"params", {{"channel", channel}, {"data", exchange_.bookSnapshot(instrument_name)}}}
+            };
+            send(hdl, session, notification.dump());
+        }
+        return;
+    }
+
+    if (method == "public/set_heartbeat" || method == "public/disable_heartbeat") {
+        nlohmann::json response = {{"jsonrpc", "2.0"}, {"id", id}, {"result", "ok"}};
+        send(hdl, session, response.dump());
+        return;
+    }
+
+    nlohmann::json response = exchange_.respond(request, session.authenticated);
+    if (method == "public/auth" && response.contains("result")) {
+        session.authenticated = true;
+    }
+    send(hdl, session, response.dump());
+}
+
+void WsServer::scheduleFeed() {
+    feed_timer_->expires_after(kFeedInterval);
+    feed_timer_->async_wait([this](const asio::error_code& ec) {
+        if (ec) {
+            return;
+        }
+        tick();
+        scheduleFeed();
+    });
+}
+
+void WsServer::tick() {
+    Clock::time_point now = Clock::now();
+    uint64_t index = 0;
+    const MockPhase* phase = scenario_.phaseAt(now - started_, index);
+    if (index != phase_index_) {
+        if (phase_ && phase_->disconnect) {
+            closeAll("phase " + phase_->name + " ended");
+        }
+        phase_ = phase;
+        phase_index_ = index;
+        DERIBIT_LOG_INFO("Mock phase {}", phase_ ? phase_->name : "finished");
+    }
+
+    double elapsed = std::chrono::duration<double>(now - last_tick_).count();
+    last_tick_ = now;
+    if (phase_) {
+        for (size_t i = 0; i < scenario_.instruments.size(); ++i) {
+            const std::string& instrument_name = scenario_.instruments[i];
+
+            book_credit_[i] = std::min(book_credit_[i] + phase_->book_rate * elapsed,
+                                       phase_->book_rate * kMaxCreditSeconds + 1.0);
+            for (; book_credit_[i] >= 1.0; book_credit_[i] -= 1.0) {
+                // The book always moves; a gap only withholds the notification
+                nlohmann::json change = exchange_.bookChange(instrument_name);
+                ++book_changes_;
+                if (phase_->gap_every > 0 && book_changes_ % phase_->gap_every == 0) {
+                    ++dropped_changes_;
+                    continue;
+                }
+                publish("book." + instrument_name + ".", change);
+            }
+
+            trade_credit_[i] = std::min(trade_credit_[i] + phase_->trade_rate * elapsed,
+                                        phase_->trade_rate * kMaxCreditSeconds + 1.0);
+            for (; trade_credit_[i] >= 1.0; trade_credit_[i] -= 1.0) {
+                publish("trades." + instrument_name + ".", exchange_.publicTrade(instrument_name));
+                ++trades_;
+            }
+        }
+    }
+
+    if (now - last_stats_ >= kStatsInterval) {
+        last_stats_ = now;
+        DERIBIT_LOG_INFO("Mock feed: {} sessions, {} book changes ({} dropped), {} trades, {} frames sent",
+            sessions_.size(), book_changes_, dropped_changes_, trades_, frames_sent_);
+    }
+}
+
+void WsServer::publish(const std::string& channel_prefix, const nlohmann::json& data) {
+    std::string body;
+    for (auto& entry : sessions_) {
+        for (const auto& channel : entry.second.channels) {
+            if (channel.compare(0, channel_prefix.size(), channel_prefix) != 0) {
+                continue;
+            }
+            // Serialize the data once and splice it into each subscriber's envelope
+            if (body.empty()) {
+                body = data.dump();
+            }
+            send(entry.first, entry.second,
+                "{\"jsonrpc\":\"2.0\",\"method\":\"subscription\",\"params\":{\"channel\":" +
+                nlohmann::json(channel).dump() + ",\"data\":" + body + "}}");
+        }
+    }
+}
+
+void WsServer::send(websocketpp::connection_hdl hdl, Session& session, std::string payload) {
+    Clock::duration delay = phase_ ? Clock::duration(phase_->latency) : Clock::duration::zero();
+    if (phase_ && phase_->jitter.count() > 0) {
+        delay += std::chrono::microseconds(jitter_rng_() % static_cast<uint64_t>(phase_->jitter.count() + 1));
+    }
+
+    if (delay == Clock::duration::zero() && session.pending.empty()) {
+        websocketpp::lib::error_code ec;
+        server_.send(hdl, payload, websocketpp::frame::opcode::text, ec);
+        if (!ec) {
+            ++frames_sent_;
+        }
+        return;
+    }
+
+    // Jitter never reorders: a frame is due no earlier than the one queued before it
+    Clock::time_point due = std::max(Clock::now() + delay, session.last_due);
+    session.last_due = due;
+    session.pending.emplace_back(due, std::move(payload));
+    if (!session.timer_armed) {
+        session.timer_armed = true;
+        session.timer->expires_at(due);
+        session.timer->async_wait([this, hdl](const asio::error_code& ec) {
+            if (!ec) {
+                flush(hdl);
+            }
+        });
+    }
+}
+
+void WsServer::flush(websocketpp::connection_hdl hdl) {
+    auto it = sessions_.find(hdl);
+    if (it == sessions_.end()) {
+        return;
+    }
+    Session& session = it->second;
+    session.timer_armed = false;
+
+    Clock::time_point now = Clock::now();
+    while (!session.pending.empty() && session.pending.front().first <= now) {
+        websocketpp::lib::error_code ec;
+        server_.send(hdl, session.pending.front().second, websocketpp::frame::opcode::text, ec);
+        if (!ec) {
+            ++frames_sent_;
+        }
+        session.pending.pop_front();
+    }
+
+    if (!session.pending.empty()) {
+        session.timer_armed = true;
+        session.timer->expires_at(session.pending.front().first);
+        session.timer->async_wait([this, hdl](const asio::error_code& ec) {
+            if (!ec) {
+                flush(hdl);
+            }
+        });
+    }
+}
+
+void WsServer::closeAll(const std::string& reason) {
+    if (!sessions_.empty()) {
+        DERIBIT_LOG_INFO("Closing {} mock connections: {}", sessions_.size(), reason);
+    }
+    for (auto& entry : sessions_) {
+        entry.second.timer->cancel();
+        entry.second.pending.clear();
+        entry.second.timer_armed = false;
+        websocketpp::lib::error_code ec;
+        server_.close(entry.first, websocketpp::close::status::going_away, reason, ec);
+    }
+}
+
+} // namespace mock
+} // namespace deribit
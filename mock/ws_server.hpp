@@ -0,0 +1,124 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+#define ASIO_STANDALONE
+#include <asio.hpp>
+#include <asio/ssl.hpp>
+#include <websocketpp/config/asio.hpp>
+#include <websocketpp/server.hpp>
+
+#include "mock_exchange.hpp"
+#include "scenario.hpp"
+
+namespace deribit {
+namespace mock {
+
+/**
+ * @brief Mock of Deribit's JSON-RPC WebSocket endpoint
+ *
+ * Serves wss:// on localhost with a self-signed certificate generated at
+ * start-up; the client does not verify peers, so it connects unchanged. Handles
+ * subscribe and unsubscribe itself, passes every other request to the exchange
+ * and streams book.*, trades.* and user.* notifications at the rates of the
+ * active scenario phase. Everything runs on one I/O thread.
+ */
+class WsServer {
+public:
+    /**
+     * @brief Constructor
+     * @param exchange The exchange to serve
+     * @param scenario The port, instruments and phases to run
+     */
+    WsServer(MockExchange& exchange, const MockScenario& scenario);
+
+    /**
+     * @brief Destructor
+     */
+    ~WsServer();
+
+    /**
+     * @brief Bind the port, start the feed and the I/O thread
+     * @return true if the server started, false otherwise
+     */
+    bool start();
+
+    /**
+     * @brief Close every connection, stop the feed and join the I/O thread
+     */
+    void stop();
+
+    /**
+     * @brief Push an order change to user.orders, user.trades and user.changes subscribers
+     * @param order The order after the change
+     * @param trades The fills, if any
+     * @param position The position after the fills, or null
+     *
+     * Safe to call from any thread.
+     */
+    void publishOrderEvent(const nlohmann::json& order, const nlohmann::json& trades, const nlohmann::json& position);
+
+private:
+    using Server = websocketpp::server<websocketpp::config::asio_tls>;
+    using Clock = std::chrono::steady_clock;
+
+    // Per-connection state; frames wait in pending until their injected delay has passed
+    struct Session {
+        bool authenticated{false};
+        std::set<std::string> channels;
+        std::deque<std::pair<Clock::time_point, std::string>> pending;
+        std::unique_ptr<asio::steady_timer> timer;
+        bool timer_armed{false};
+        Clock::time_point last_due;
+    };
+
+    MockExchange& exchange_;
+    MockScenario scenario_;
+    Server server_;
+    std::thread thread_;
+    bool running_{false};
+    std::string certificate_pem_;
+    std::string private_key_pem_;
+
+    // Owned by the I/O thread
+    std::map<websocketpp::connection_hdl, Session, std::owner_less<websocketpp::connection_hdl>> sessions_;
+    std::unique_ptr<asio::steady_timer> feed_timer_;
+    Clock::time_point started_;
+    Clock::time_point last_tick_;
+    Clock::time_point last_stats_;
+    const MockPhase* phase_{nullptr};
+    uint64_t phase_index_{0};
+    std::vector<double> book_credit_;
+    std::vector<double> trade_credit_;
+    uint64_t book_changes_{0};
+    uint64_t dropped_changes_{0};
+    uint64_t trades_{0};
+    uint64_t frames_sent_{0};
+    std::mt19937_64 jitter_rng_;
+
+    // Internal methods
+    bool generateCertificate();
+    std::shared_ptr<asio::ssl::context> onTlsInit(websocketpp::connection_hdl);
+    void onOpen(websocketpp::connection_hdl hdl);
+    void onClose(websocketpp::connection_hdl hdl);
+    void onMessage(websocketpp::connection_hdl hdl, Server::message_ptr msg);
+    void scheduleFeed();
+    void tick();
+    void publish(const std::string& channel_prefix, const nlohmann::json& data);
+    void send(websocketpp::connection_hdl hdl, Session& session, std::string payload);
+    void flush(websocketpp::connection_hdl hdl);
+    void closeAll(const std::string& reason);
+};
+
+} // namespace mock
+} // namespace deribit
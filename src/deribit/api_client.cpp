@@ -1,143 +1,298 @@
 #include "deribit/api_client.hpp"
-#include <iostream>
+#include "deribit/logger.hpp"
+#include "deribit/trace.hpp"
 #include <sstream>
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <iterator>
+#include <cctype>
 
 namespace deribit {
 
 ApiClient::ApiClient(const Config& config)
-    : config_(config) {
+    : config_(config)
+    , rate_limiter_(std::make_unique<RateLimiter>(config))
+    , risk_engine_(config.getRiskLimits())
+    , candle_engine_(config.getCandleIntervals(), config.getCandleHistory())
+    , portfolio_engine_(instrument_store_) {
+    Logger::instance().setLevel(config.getLogLevel());
+    Logger::instance().setRateLimit(config.getLogRateLimit());
+    registerMetrics();
 }
 
 ApiClient::~ApiClient() {
+    // Scrapes read the components below, so the endpoint goes first
+    if (metrics_server_) {
+        metrics_server_->stop();
+    }
+    stopMaintenance();
+    if (quote_engine_) {
+        quote_engine_->stop();
+    }
     if (ws_running_) {
         ws_running_ = false;
         if (ws_thread_.joinable()) {
             ws_thread_.join();
         }
     }
+    order_latency_.printReport();
+    Logger::instance().flush();
 }
 
 bool ApiClient::initialize() {
     // Initialize REST client
     rest_client_ = std::make_unique<RestClient>(config_);
     if (!rest_client_->initialize()) {
-        std::cerr << "Failed to initialize REST client" << std::endl;
+        DERIBIT_LOG_ERROR("Failed to initialize REST client");
+        return false;
+    }
+    
+    // Initialize asynchronous REST client
+    async_rest_client_ = std::make_unique<AsyncRestClient>(config_);
+    async_rest_client_->setTokenProvider([this]() {
+        return rest_client_->getAccessToken();
+    });
+    if (!async_rest_client_->initialize()) {
+        DERIBIT_LOG_ERROR("Failed to initialize async REST client");
         return false;
     }
     
     // Initialize WebSocket client
     ws_client_ = std::make_unique<WebSocketClient>(config_);
     if (!ws_client_->initialize()) {
-        std::cerr << "Failed to initialize WebSocket client" << std::endl;
+        DERIBIT_LOG_ERROR("Failed to initialize WebSocket client");
         return false;
     }
     
+    // Quotes are pipelined over the WebSocket; deferred sides are retried on the engine's own thread
+    quote_engine_ = std::make_unique<QuoteEngine>(
+        config_, instrument_store_, *rate_limiter_, risk_engine_,
+        [this](const std::string& message) {
+            return ws_client_->send(message);
+        });
+    quote_engine_->start();
+    
+    // Books that lost a change are rebuilt from the snapshot a fresh subscription sends
+    addMaintenanceTask(std::chrono::milliseconds(100), [this]() {
+        resyncBooks();
+    });
+    
+    // The panic path writes pre-encoded cancels straight to the socket
+    kill_switch_ = std::make_unique<KillSwitch>(
+        config_.getInstrumentCurrencies(),
+        [this](const std::string& message) {
+            return ws_client_->send(message);
+        });
+    
+    // Exchange clock offset from public/get_time round trips; probed once connected
+    time_sync_ = std::make_unique<TimeSync>(
+        [this](const std::string& message) {
+            return ws_client_->send(message);
+        });
+    
+    // Load instrument reference data, preferring the local snapshot
+    loadInstruments();
+    addMaintenanceTask(config_.getInstrumentRefreshInterval(), [this]() {
+        refreshInstruments();
+    });
+    startMaintenance();
+    
+    // The metrics endpoint is opt-in; scrapes run on its own thread
+    if (config_.getMetricsPort() != 0) {
+        metrics_server_ = std::make_unique<MetricsServer>(metrics_, config_.getMetricsPort());
+        if (!metrics_server_->start()) {
+            DERIBIT_LOG_WARN("Failed to start metrics endpoint; continuing without it");
+        }
+    }
+    
     is_initialized_ = true;
     return true;
 }
 
 bool ApiClient::authenticate() {
     if (!is_initialized_) {
-        std::cerr << "API client not initialized" << std::endl;
+        DERIBIT_LOG_ERROR("API client not initialized");
         return false;
     }
     
     // First authenticate with REST API
     nlohmann::json auth_response = rest_client_->authenticate();
     if (!rest_client_->isAuthenticated()) {
-        std::cerr << "REST authentication failed" << std::endl;
+        DERIBIT_LOG_ERROR("REST authentication failed");
         return false;
     }
     
-    std::cout << "REST authentication successful" << std::endl;
+    DERIBIT_LOG_INFO("REST authentication successful");
     
     // Connect to WebSocket API
     if (!ws_client_->connect()) {
-        std::cerr << "WebSocket connection failed" << std::endl;
+        DERIBIT_LOG_ERROR("WebSocket connection failed");
         return false;
     }
     
     // Authenticate with WebSocket API using the access token from REST
     if (!ws_client_->authenticate(rest_client_->getAccessToken())) {
-        std::cerr << "WebSocket authentication failed" << std::endl;
+        DERIBIT_LOG_ERROR("WebSocket authentication failed");
         return false;
     }
     
-    std::cout << "WebSocket authentication successful" << std::endl;
+    DERIBIT_LOG_INFO("WebSocket authentication successful");
     is_authenticated_ = true;
     
     // Start WebSocket message processing thread
     ws_running_ = true;
     ws_thread_ = std::thread(&ApiClient::processWebSocketMessages, this);
     
+    // Keep the exchange clock offset current for wire latency and stale feed checks
+    addMaintenanceTask(config_.getTimeSyncInterval(), [this]() {
+        if (ws_client_->isConnected()) {
+            throttle("public/get_time");
+            time_sync_->probe();
+        }
+    }, true);
+    
+    // Have the exchange pull our orders if this session drops
+    if (config_.isCancelOnDisconnect() && !enableCancelOnDisconnect()) {
+        DERIBIT_LOG_ERROR("Failed to enable cancel-on-disconnect");
+    }
+    
+    // Keep the order store live from private channels, reconciling via REST
+    throttle("private/subscribe");
+    bool orders_subscribed = ws_client_->subscribe("user.orders.any.any.raw");
+    throttle("private/subscribe");
+    bool trades_subscribed = ws_client_->subscribe("user.trades.any.any.raw");
+    if (orders_subscribed && trades_subscribed) {
+        addMaintenanceTask(config_.getOrderReconcileInterval(), [this]() {
+            if (reconcileOrders() && ws_client_->isConnected()) {
+                order_store_.setLive(true);
+            }
+        }, true);
+    } else {
+        DERIBIT_LOG_WARN("Failed to subscribe to order updates; open orders will use REST");
+    }
+    
+    // Keep the position store live the same way; the index values PnL in USD
+    throttle("private/subscribe");
+    bool positions_subscribed = ws_client_->subscribe("user.changes.any.any.raw");
+    for (const auto& currency : config_.getInstrumentCurrencies()) {
+        std::string channel = "user.portfolio.";
+        std::transform(currency.begin(), currency.end(), std::back_inserter(channel),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        throttle("private/subscribe");
+        ws_client_->subscribe(channel);
+        throttle("public/subscribe");
+        ws_client_->subscribe("deribit_price_index." + channel.substr(15) + "_usd");
+    }
+    if (positions_subscribed) {
+        addMaintenanceTask(config_.getPositionReconcileInterval(), [this]() {
+            if (reconcilePositions() && ws_client_->isConnected()) {
+                position_store_.setLive(true);
+            }
+        }, true);
+    } else {
+        DERIBIT_LOG_WARN("Failed to subscribe to position updates; positions will use REST");
+    }
+    
     return true;
 }
 
-bool ApiClient::placeBuyOrder(const std::string& instrument_name, double amount, const std::string& type, double price, const std::string& label) {
+bool ApiClient::placeBuyOrder(const std::string& instrument_name, double amount, const std::string& type, double price,
+                              const std::string& label, const std::string& client_order_id, bool reduce_only) {
+    DERIBIT_TRACE_SCOPE("order.buy");
     try {
         // Ensure the client is authenticated
         if (!is_authenticated_) {
-            std::cerr << "API client not authenticated" << std::endl;
+            DERIBIT_LOG_ERROR("API client not authenticated");
             return false;
         }
 
-        // Refresh token if needed
-        if (rest_client_->needsRefresh()) {
-            if (!rest_client_->refreshToken().contains("result")) {
-                std::cerr << "Failed to refresh authentication token" << std::endl;
-                return false;
-            }
+        // The client order id travels at the end of the label; only a caller's own id is retried
+        if (client_order_id.find('/') != std::string::npos) {
+            DERIBIT_LOG_ERROR("Client order id {} must not contain '/'", client_order_id);
+            countOrder(OrderMethod::Buy, OrderOutcome::Blocked);
+            return false;
         }
-
-        // Define contract size (example value, adjust as needed)
-        const double contract_size = 0.01;  // Example contract size
-
-        // Check if amount is a multiple of contract size
-        if (fmod(amount, contract_size) != 0.0) {
-            std::cerr << "Amount must be a multiple of contract size: " << contract_size << std::endl;
+        if (!client_order_id.empty() && !needsSend(client_order_id, instrument_name, "buy", amount)) {
+            countOrder(OrderMethod::Buy, OrderOutcome::Duplicate);
             return false;
         }
+        std::string order_id = client_order_id.empty() ? client_orders_.nextClientOrderId() : client_order_id;
+        std::string order_label = ClientOrderTracker::labelFor(label, order_id);
 
-        // Create JSON-RPC request
-        nlohmann::json request = {
-            {"jsonrpc", "2.0"},
-            {"id", 5275},
-            {"method", "private/buy"},
-            {"params", {
-                {"instrument_name", instrument_name},
-                {"amount", amount},
-                {"type", type},
-                {"access_token", rest_client_->getAccessToken()}
-            }}
-        };
-
-        if (type == "limit") {
-            request["params"]["price"] = price;
+        // Validate amount and snap the price onto the instrument's tick grid
+        if (!validateOrder(instrument_name, amount, type, price, true)) {
+            countOrder(OrderMethod::Buy, OrderOutcome::Blocked);
+            return false;
         }
 
-        if (!label.empty()) {
-            request["params"]["label"] = label;
+        uint64_t request_id = client_orders_.track(
+            order_id, order_label, instrument_name, "buy", amount, type == "limit" ? price : 0.0);
+        if (request_id == 0) {
+            DERIBIT_LOG_WARN("Order {} is already being sent; not resending", order_id);
+            countOrder(OrderMethod::Buy, OrderOutcome::Duplicate);
+            return false;
         }
 
-        // Send the request over WebSocket
-        if (!ws_client_->send(request.dump())) {
-            std::cerr << "Failed to send order request" << std::endl;
+        // Create JSON-RPC request; the rate limiter wait is kept out of the encode stamp
+        throttle("private/buy", reduce_only);
+        auto encoded = OrderLatencyTracker::Clock::now();
+        std::string payload = encodeOrderRequest(
+            "private/buy", request_id, instrument_name, amount, type, price,
+            order_label, rest_client_->getAccessToken(), reduce_only);
+
+        // Send the request over WebSocket; register before sending so the response cannot beat it
+        order_latency_.onSent(request_id, OrderMethod::Buy, OrderTransport::WebSocket,
+                              encoded, OrderLatencyTracker::Clock::now(), order_label);
+        if (!ws_client_->send(payload)) {
+            DERIBIT_LOG_ERROR("Failed to send order request");
+            client_orders_.onReject(order_id, "send failed");
+            countOrder(OrderMethod::Buy, OrderOutcome::Failed);
             return false;
         }
 
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "Error placing buy order: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error placing buy order: {}", e.what());
+        countOrder(OrderMethod::Buy, OrderOutcome::Failed);
         return false;
     }
 }
 
-bool ApiClient::placeSellOrder(const std::string& instrument_name, double amount, const std::string& type, double price, const std::string& label) {
+bool ApiClient::placeSellOrder(const std::string& instrument_name, double amount, const std::string& type, double price,
+                               const std::string& label, const std::string& client_order_id, bool reduce_only) {
+    DERIBIT_TRACE_SCOPE("order.sell");
     try {
+        // The client order id travels at the end of the label; only a caller's own id is retried
+        if (client_order_id.find('/') != std::string::npos) {
+            DERIBIT_LOG_ERROR("Client order id {} must not contain '/'", client_order_id);
+            countOrder(OrderMethod::Sell, OrderOutcome::Blocked);
+            return false;
+        }
+        if (!client_order_id.empty() && !needsSend(client_order_id, instrument_name, "sell", amount)) {
+            countOrder(OrderMethod::Sell, OrderOutcome::Duplicate);
+            return false;
+        }
+        std::string order_id = client_order_id.empty() ? client_orders_.nextClientOrderId() : client_order_id;
+        std::string order_label = ClientOrderTracker::labelFor(label, order_id);
+
+        // Validate amount and snap the price onto the instrument's tick grid
+        if (!validateOrder(instrument_name, amount, type, price, false)) {
+            countOrder(OrderMethod::Sell, OrderOutcome::Blocked);
+            return false;
+        }
+        
+        if (client_orders_.track(order_id, order_label, instrument_name, "sell", amount,
+                                 type == "limit" ? price : 0.0) == 0) {
+            DERIBIT_LOG_WARN("Order {} is already being sent; not resending", order_id);
+            countOrder(OrderMethod::Sell, OrderOutcome::Duplicate);
+            return false;
+        }
+        
         // Build the endpoint with query parameters
         std::string endpoint = "private/sell";
+        throttle(endpoint, reduce_only);
+        auto encoded = OrderLatencyTracker::Clock::now();
         std::string query = "amount=" + std::to_string(amount) + 
                            "&instrument_name=" + instrument_name + 
                            "&type=" + type;
@@ -146,34 +301,52 @@ bool ApiClient::placeSellOrder(const std::string& instrument_name, double amount
             query += "&price=" + std::to_string(price);
         }
         
-        if (!label.empty()) {
-            query += "&label=" + label;
+        query += "&label=" + order_label;
+        if (reduce_only) {
+            query += "&reduce_only=true";
         }
         
         // Use GET request with query parameters
+        uint64_t latency_key = order_latency_.nextLocalKey();
+        order_latency_.onSent(latency_key, OrderMethod::Sell, OrderTransport::Rest,
+                              encoded, OrderLatencyTracker::Clock::now(), order_label);
         auto response = rest_client_->get(endpoint + "?" + query, nlohmann::json());
+        order_latency_.onAck(latency_key, response);
         
         if (response.contains("result")) {
-            std::cout << "Order placed successfully" << std::endl;
+            if (response["result"].contains("order")) {
+                client_orders_.onOrder(Order(response["result"]["order"]));
+            }
+            countOrder(OrderMethod::Sell, OrderOutcome::Accepted);
+            DERIBIT_LOG_INFO("Order placed successfully");
             return true;
         } else if (response.contains("error")) {
-            std::cerr << "Order placement failed: " << response["error"]["message"].get<std::string>() << std::endl;
+            std::string message = response["error"]["message"].get<std::string>();
+            client_orders_.onReject(order_id, message);
+            countOrder(OrderMethod::Sell, OrderOutcome::Rejected);
+            DERIBIT_LOG_ERROR("Order placement failed: {}", message);
             return false;
         }
         
+        // No answer: leave it pending so a retry looks the label up first
+        countOrder(OrderMethod::Sell, OrderOutcome::Failed);
         return false;
     } catch (const std::exception& e) {
-        std::cerr << "Error placing sell order: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error placing sell order: {}", e.what());
+        countOrder(OrderMethod::Sell, OrderOutcome::Failed);
         return false;
     }
 }
 
 bool ApiClient::cancelOrder(const std::string& order_id) {
+    DERIBIT_TRACE_SCOPE("order.cancel");
     if (!is_authenticated_) {
-        std::cerr << "API client not authenticated" << std::endl;
+        DERIBIT_LOG_ERROR("API client not authenticated");
         return false;
     }
     
+    throttle("private/cancel");
+    auto encoded = OrderLatencyTracker::Clock::now();
     nlohmann::json request = {
         {"jsonrpc", "2.0"},
         {"id", 42},
@@ -183,14 +356,21 @@ bool ApiClient::cancelOrder(const std::string& order_id) {
         }}
     };
     
+    uint64_t latency_key = order_latency_.nextLocalKey();
+    order_latency_.onSent(latency_key, OrderMethod::Cancel, OrderTransport::Rest,
+                          encoded, OrderLatencyTracker::Clock::now());
     nlohmann::json response = rest_client_->post("", request);
+    order_latency_.onAck(latency_key, response);
     
     if (response.contains("error")) {
-        std::cerr << "Order cancellation failed: " << response["error"]["message"].get<std::string>() << std::endl;
+        DERIBIT_LOG_ERROR("Order cancellation failed: {}", response["error"]["message"].get<std::string>());
+        countOrder(OrderMethod::Cancel, OrderOutcome::Rejected);
         return false;
     }
     
-    return response.contains("result");
+    bool accepted = response.contains("result");
+    countOrder(OrderMethod::Cancel, accepted ? OrderOutcome::Accepted : OrderOutcome::Failed);
+    return accepted;
 }
 
 bool ApiClient::modifyOrder(
@@ -198,11 +378,27 @@ bool ApiClient::modifyOrder(
     double amount,
     double price) {
     
+    DERIBIT_TRACE_SCOPE("order.edit");
     if (!is_authenticated_) {
-        std::cerr << "API client not authenticated" << std::endl;
+        DERIBIT_LOG_ERROR("API client not authenticated");
         return false;
     }
     
+    // An edit can grow the order, so it passes the same checks as a new one; the order it replaces is netted off
+    Order order;
+    if (order_store_.findOrder(order_id, order) || fetchOrderState(order_id, order)) {
+        if (!validateOrder(order.getInstrumentName(), amount, order.getOrderType(), price,
+                           order.getDirection() == "buy", order.getAmount())) {
+            countOrder(OrderMethod::Edit, OrderOutcome::Blocked);
+            return false;
+        }
+    } else {
+        // The exchange refuses edits of orders it does not know, so only the risk check is lost
+        DERIBIT_LOG_WARN("Could not look up order {}; sending the edit without a risk check", order_id);
+    }
+    
+    throttle("private/edit");
+    auto encoded = OrderLatencyTracker::Clock::now();
     nlohmann::json request = {
         {"jsonrpc", "2.0"},
         {"id", 42},
@@ -214,20 +410,63 @@ bool ApiClient::modifyOrder(
         }}
     };
     
+    uint64_t latency_key = order_latency_.nextLocalKey();
+    order_latency_.onSent(latency_key, OrderMethod::Edit, OrderTransport::Rest,
+                          encoded, OrderLatencyTracker::Clock::now());
     nlohmann::json response = rest_client_->post("", request);
+    order_latency_.onAck(latency_key, response);
     
     if (response.contains("error")) {
-        std::cerr << "Order modification failed: " << response["error"]["message"].get<std::string>() << std::endl;
+        DERIBIT_LOG_ERROR("Order modification failed: {}", response["error"]["message"].get<std::string>());
+        countOrder(OrderMethod::Edit, OrderOutcome::Rejected);
         return false;
     }
     
-    return response.contains("result");
+    bool accepted = response.contains("result");
+    countOrder(OrderMethod::Edit, accepted ? OrderOutcome::Accepted : OrderOutcome::Failed);
+    return accepted;
+}
+
+bool ApiClient::fetchOrderState(const std::string& order_id, Order& order) {
+    nlohmann::json request = {
+        {"jsonrpc", "2.0"},
+        {"id", 42},
+        {"method", "private/get_order_state"},
+        {"params", {
+            {"order_id", order_id}
+        }}
+    };
+    
+    throttle("private/get_order_state");
+    nlohmann::json response = rest_client_->get("", request);
+    if (!response.contains("result") || !response["result"].is_object()) {
+        return false;
+    }
+    order = Order(response["result"]);
+    return true;
 }
 
 Orderbook ApiClient::getOrderbook(
     const std::string& instrument_name,
     int depth) {
     
+    // Prefer the live WebSocket book when we have one
+    {
+        std::lock_guard<std::mutex> lock(books_mutex_);
+        auto it = live_books_.find(instrument_name);
+        if (it != live_books_.end()) {
+            const Orderbook& book = it->second;
+            size_t levels = depth > 0 ? static_cast<size_t>(depth) : 0;
+            const auto& bids = book.getBids();
+            const auto& asks = book.getAsks();
+            return Orderbook(
+                book.getInstrumentName(),
+                book.getTimestamp(),
+                std::vector<PriceLevel>(bids.begin(), bids.begin() + std::min(levels, bids.size())),
+                std::vector<PriceLevel>(asks.begin(), asks.begin() + std::min(levels, asks.size())));
+        }
+    }
+    
     nlohmann::json request = {
         {"jsonrpc", "2.0"},
         {"id", 42},
@@ -238,6 +477,7 @@ Orderbook ApiClient::getOrderbook(
         }}
     };
     
+    throttle("public/get_order_book");
     nlohmann::json response = rest_client_->get("", request);
     
     if (response.contains("result")) {
@@ -252,10 +492,14 @@ std::vector<Position> ApiClient::getPositions(
     const std::string& kind) {
     
     if (!is_authenticated_) {
-        std::cerr << "API client not authenticated" << std::endl;
+        DERIBIT_LOG_ERROR("API client not authenticated");
         return {};
     }
     
+    if (position_store_.isLive() && ws_client_->isConnected()) {
+        return position_store_.getPositions(currency, kind);
+    }
+    
     nlohmann::json request = {
         {"jsonrpc", "2.0"},
         {"id", 42},
@@ -269,6 +513,7 @@ std::vector<Position> ApiClient::getPositions(
         request["params"]["kind"] = kind;
     }
     
+    throttle("private/get_positions");
     nlohmann::json response = rest_client_->get("", request);
     
     std::vector<Position> positions;
@@ -287,10 +532,14 @@ std::vector<Order> ApiClient::getOpenOrders(
     const std::string& instrument_name) {
     
     if (!is_authenticated_) {
-        std::cerr << "API client not authenticated" << std::endl;
+        DERIBIT_LOG_ERROR("API client not authenticated");
         return {};
     }
     
+    if (order_store_.isLive() && ws_client_->isConnected()) {
+        return order_store_.getOpenOrders(instrument_name);
+    }
+    
     nlohmann::json request = {
         {"jsonrpc", "2.0"},
         {"id", 42},
@@ -302,6 +551,7 @@ std::vector<Order> ApiClient::getOpenOrders(
         request["params"]["instrument_name"] = instrument_name;
     }
     
+    throttle("private/get_open_orders_by_currency");
     nlohmann::json response = rest_client_->get("", request);
     
     std::vector<Order> orders;
@@ -316,12 +566,82 @@ std::vector<Order> ApiClient::getOpenOrders(
     return orders;
 }
 
+std::vector<Orderbook> ApiClient::getOrderbooksBulk(
+    const std::vector<std::string>& instrument_names,
+    int depth) {
+    
+    // Issue every request up front so they run concurrently
+    std::vector<std::future<nlohmann::json>> responses;
+    responses.reserve(instrument_names.size());
+    for (const auto& instrument_name : instrument_names) {
+        throttle("public/get_order_book");
+        responses.push_back(async_rest_client_->call("public/get_order_book", {
+            {"instrument_name", instrument_name},
+            {"depth", depth}
+        }));
+    }
+    
+    std::vector<Orderbook> orderbooks;
+    orderbooks.reserve(responses.size());
+    for (auto& future : responses) {
+        nlohmann::json response = future.get();
+        if (response.contains("result")) {
+            orderbooks.emplace_back(response["result"]);
+        } else {
+            orderbooks.emplace_back();
+        }
+    }
+    
+    return orderbooks;
+}
+
+std::vector<Position> ApiClient::getPositionsBulk(
+    const std::vector<std::string>& currencies,
+    const std::string& kind) {
+    
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return {};
+    }
+    
+    // Issue every request up front so they run concurrently
+    std::vector<std::future<nlohmann::json>> responses;
+    responses.reserve(currencies.size());
+    for (const auto& currency : currencies) {
+        nlohmann::json params = {{"currency", currency}};
+        if (!kind.empty()) {
+            params["kind"] = kind;
+        }
+        throttle("private/get_positions");
+        responses.push_back(async_rest_client_->call("private/get_positions", params));
+    }
+    
+    std::vector<Position> positions;
+    for (auto& future : responses) {
+        nlohmann::json response = future.get();
+        if (response.contains("result")) {
+            for (const auto& position_json : response["result"]) {
+                positions.emplace_back(position_json);
+            }
+        }
+    }
+    
+    return positions;
+}
+
+std::future<nlohmann::json> ApiClient::callAsync(
+    const std::string& method,
+    const nlohmann::json& params) {
+    throttle(method);
+    return async_rest_client_->call(method, params);
+}
+
 bool ApiClient::subscribeOrderbook(
     const std::string& instrument_name,
     std::function<void(const Orderbook&)> callback) {
     
     if (!is_authenticated_) {
-        std::cerr << "API client not authenticated" << std::endl;
+        DERIBIT_LOG_ERROR("API client not authenticated");
         return false;
     }
     
@@ -337,12 +657,13 @@ bool ApiClient::subscribeOrderbook(
     nlohmann::json params;
     params["instrument_name"] = instrument_name;
     
+    throttle("public/subscribe");
     return ws_client_->subscribe(channel, params);
 }
 
 bool ApiClient::unsubscribeOrderbook(const std::string& instrument_name) {
     if (!is_authenticated_) {
-        std::cerr << "API client not authenticated" << std::endl;
+        DERIBIT_LOG_ERROR("API client not authenticated");
         return false;
     }
     
@@ -353,31 +674,700 @@ bool ApiClient::unsubscribeOrderbook(const std::string& instrument_name) {
         std::lock_guard<std::mutex> lock(callbacks_mutex_);
         orderbook_callbacks_.erase(instrument_name);
     }
+    {
+        std::lock_guard<std::mutex> lock(books_mutex_);
+        live_books_.erase(instrument_name);
+    }
     
+    throttle("public/unsubscribe");
     return ws_client_->unsubscribe(channel);
 }
 
+bool ApiClient::subscribeTrades(const std::string& instrument_name, const std::string& interval) {
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(trade_rings_mutex_);
+        if (trade_rings_.find(instrument_name) == trade_rings_.end()) {
+            trade_rings_[instrument_name] = std::make_shared<TradeRing>(config_.getTradeHistoryCapacity());
+        }
+    }
+    
+    throttle("public/subscribe");
+    return ws_client_->subscribe("trades." + instrument_name + "." + interval);
+}
+
+bool ApiClient::unsubscribeTrades(const std::string& instrument_name, const std::string& interval) {
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return false;
+    }
+    
+    throttle("public/unsubscribe");
+    return ws_client_->unsubscribe("trades." + instrument_name + "." + interval);
+}
+
+std::shared_ptr<const TradeRing> ApiClient::getTradeRing(const std::string& instrument_name) const {
+    std::lock_guard<std::mutex> lock(trade_rings_mutex_);
+    auto it = trade_rings_.find(instrument_name);
+    return it != trade_rings_.end() ? it->second : nullptr;
+}
+
+bool ApiClient::subscribeQuote(const std::string& instrument_name) {
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return false;
+    }
+    
+    addTopOfBookSlot(instrument_name);
+    throttle("public/subscribe");
+    return ws_client_->subscribe("quote." + instrument_name);
+}
+
+bool ApiClient::unsubscribeQuote(const std::string& instrument_name) {
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return false;
+    }
+    
+    throttle("public/unsubscribe");
+    return ws_client_->unsubscribe("quote." + instrument_name);
+}
+
+bool ApiClient::subscribeTicker(const std::string& instrument_name, const std::string& interval) {
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return false;
+    }
+    
+    addTopOfBookSlot(instrument_name);
+    throttle("public/subscribe");
+    return ws_client_->subscribe("ticker." + instrument_name + "." + interval);
+}
+
+bool ApiClient::unsubscribeTicker(const std::string& instrument_name, const std::string& interval) {
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return false;
+    }
+    
+    throttle("public/unsubscribe");
+    return ws_client_->unsubscribe("ticker." + instrument_name + "." + interval);
+}
+
+std::shared_ptr<const SeqLock<TopOfBook>> ApiClient::getTopOfBookSlot(const std::string& instrument_name) const {
+    std::lock_guard<std::mutex> lock(top_of_book_mutex_);
+    auto it = top_of_book_.find(instrument_name);
+    return it != top_of_book_.end() ? it->second : nullptr;
+}
+
+bool ApiClient::getTopOfBook(const std::string& instrument_name, TopOfBook& top) const {
+    auto slot = getTopOfBookSlot(instrument_name);
+    if (!slot) {
+        return false;
+    }
+    top = slot->load();
+    return true;
+}
+
+void ApiClient::addTopOfBookSlot(const std::string& instrument_name) {
+    std::lock_guard<std::mutex> lock(top_of_book_mutex_);
+    if (top_of_book_.find(instrument_name) == top_of_book_.end()) {
+        top_of_book_[instrument_name] = std::make_shared<SeqLock<TopOfBook>>();
+    }
+}
+
+void ApiClient::trackCandles(const std::string& instrument_name, CandleSource source) {
+    candle_engine_.track(instrument_name, source);
+}
+
+void ApiClient::untrackCandles(const std::string& instrument_name) {
+    candle_engine_.untrack(instrument_name);
+}
+
+void ApiClient::setCandleCallback(CandleEngine::BarCallback callback) {
+    candle_engine_.setBarCallback(std::move(callback));
+}
+
+std::vector<Candle> ApiClient::getCandles(
+    const std::string& instrument_name,
+    std::chrono::milliseconds interval) const {
+    return candle_engine_.getCandles(instrument_name, interval);
+}
+
+bool ApiClient::trackOptionChain(const std::string& currency) {
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return false;
+    }
+    
+    size_t added = 0;
+    for (const auto& entry : *instrument_store_.snapshot()) {
+        const auto& instrument = *entry.second;
+        if (instrument.isActive() && instrument.getBaseCurrency() == currency &&
+            options_engine_.addOption(instrument)) {
+            ++added;
+        }
+    }
+    DERIBIT_LOG_INFO("Tracking {} {} options", added, currency);
+    
+    std::string index_name = currency + "_usd";
+    std::transform(index_name.begin(), index_name.end(), index_name.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    
+    throttle("public/subscribe");
+    bool success = ws_client_->subscribe("deribit_price_index." + index_name);
+    throttle("public/subscribe");
+    return ws_client_->subscribe("markprice.options." + index_name) && success;
+}
+
+bool ApiClient::getOptionGreeks(const std::string& instrument_name, OptionGreeks& greeks) const {
+    return options_engine_.getGreeks(instrument_name, greeks);
+}
+
+OptionsEngineStats ApiClient::getOptionsEngineStats() const {
+    return options_engine_.getStats();
+}
+
 bool ApiClient::isConnected() const {
     return is_authenticated_ && ws_client_->isConnected();
 }
 
+RateLimiterStats ApiClient::getRateLimiterStats(RequestClass request_class) const {
+    return rate_limiter_->getStats(request_class);
+}
+
+ResponseCacheStats ApiClient::getResponseCacheStats() const {
+    return rest_client_->getCacheStats();
+}
+
+void ApiClient::setRiskLimits(const RiskLimits& limits) {
+    risk_engine_.setLimits(limits);
+}
+
+RiskStats ApiClient::getRiskStats() const {
+    return risk_engine_.getStats();
+}
+
+void ApiClient::setQuote(const std::string& instrument_name, const Quote& quote) {
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return;
+    }
+    quote_engine_->setQuote(instrument_name, quote);
+}
+
+void ApiClient::cancelQuotes(const std::string& instrument_name) {
+    if (!is_authenticated_) {
+        DERIBIT_LOG_ERROR("API client not authenticated");
+        return;
+    }
+    quote_engine_->cancelQuotes(instrument_name);
+}
+
+QuoteEngineStats ApiClient::getQuoteEngineStats() const {
+    return quote_engine_ ? quote_engine_->getStats() : QuoteEngineStats();
+}
+
+bool ApiClient::killSwitch(const std::string& currency) {
+    if (!kill_switch_) {
+        DERIBIT_LOG_ERROR("API client not initialized");
+        return false;
+    }
+    
+    // Halt first so nothing new is sent behind the cancel
+    risk_engine_.setHalted(true);
+    bool sent = currency.empty() ? kill_switch_->cancelAll() : kill_switch_->cancelCurrency(currency);
+    quote_engine_->reset();
+    
+    DERIBIT_LOG_WARN("Kill switch engaged{}", currency.empty() ? "" : " for " + currency);
+    return sent;
+}
+
+bool ApiClient::cancelAllByInstrument(const std::string& instrument_name) {
+    if (!kill_switch_) {
+        DERIBIT_LOG_ERROR("API client not initialized");
+        return false;
+    }
+    
+    bool sent = kill_switch_->cancelInstrument(instrument_name);
+    quote_engine_->reset(instrument_name);
+    return sent;
+}
+
+void ApiClient::resetKillSwitch() {
+    risk_engine_.setHalted(false);
+    DERIBIT_LOG_INFO("Kill switch reset; trading resumed");
+}
+
+KillSwitchStats ApiClient::getKillSwitchStats() const {
+    return kill_switch_ ? kill_switch_->getStats() : KillSwitchStats();
+}
+
+int64_t ApiClient::getExchangeTime() const {
+    if (time_sync_) {
+        return time_sync_->exchangeNowMs();
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+TimeSyncStats ApiClient::getTimeSyncStats() const {
+    return time_sync_ ? time_sync_->getStats() : TimeSyncStats();
+}
+
+bool ApiClient::isBookStale(const std::string& instrument_name) const {
+    // Until the offset is known both measures include our clock error rather than feed lag
+    if (!time_sync_ || !time_sync_->isSynced()) {
+        return false;
+    }
+    
+    int64_t threshold = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.getStaleFeedThreshold()).count();
+    int64_t now_ms = getExchangeTime();
+    std::lock_guard<std::mutex> lock(books_mutex_);
+    auto it = live_books_.find(instrument_name);
+    if (it == live_books_.end()) {
+        return false;
+    }
+    
+    // A feed that stopped arriving keeps its last latency, so the book's age counts too
+    int64_t age_ns = (now_ms - it->second.getTimestamp()) * 1000000;
+    return it->second.getWireLatency() > threshold || age_ns > threshold;
+}
+
+LatencySnapshot ApiClient::getLatency(LatencyStage stage) const {
+    return latency_.snapshot(static_cast<size_t>(stage));
+}
+
+LatencySnapshot ApiClient::getOrderLatency(
+    OrderMethod method,
+    OrderTransport transport,
+    OrderLatencyMetric metric) const {
+    return order_latency_.getLatency(method, transport, metric);
+}
+
+void ApiClient::printOrderLatencyReport() const {
+    order_latency_.printReport();
+}
+
+bool ApiClient::dumpTrace(const std::string& path) const {
+#if defined(DERIBIT_ENABLE_TRACING)
+    return Tracer::instance().dump(path);
+#else
+    DERIBIT_LOG_WARN("Tracing is compiled out; rebuild with DERIBIT_ENABLE_TRACING to dump {}", path);
+    return false;
+#endif
+}
+
+void ApiClient::printLatencyReport() const {
+    for (size_t i = 0; i < static_cast<size_t>(LatencyStage::Count); ++i) {
+        auto stage = static_cast<LatencyStage>(i);
+        DERIBIT_LOG_INFO("{}: {}", toString(stage), getLatency(stage).summary());
+    }
+}
+
+bool ApiClient::enableCancelOnDisconnect() {
+    nlohmann::json request = {
+        {"jsonrpc", "2.0"},
+        {"id", 9932},
+        {"method", "private/enable_cancel_on_disconnect"},
+        {"params", {
+            {"scope", "connection"}
+        }}
+    };
+    
+    throttle("private/enable_cancel_on_disconnect");
+    return ws_client_->send(request.dump());
+}
+
+PositionStore::PositionPtr ApiClient::getPosition(const std::string& instrument_name) const {
+    return position_store_.find(instrument_name);
+}
+
+PositionStore::PortfolioPtr ApiClient::getPortfolio(const std::string& currency) const {
+    return position_store_.getPortfolio(currency);
+}
+
+bool ApiClient::getPositionRisk(const std::string& instrument_name, PositionRisk& risk) const {
+    return portfolio_engine_.getPositionRisk(instrument_name, risk);
+}
+
+bool ApiClient::getPortfolioTotals(const std::string& currency, PortfolioTotals& totals) const {
+    return portfolio_engine_.getTotals(currency, totals);
+}
+
+std::shared_ptr<const PortfolioSnapshot> ApiClient::getPortfolioSnapshot(const std::string& currency) const {
+    return portfolio_engine_.getSnapshot(currency);
+}
+
+bool ApiClient::reconcilePositions() {
+    const auto& currencies = config_.getInstrumentCurrencies();
+    int64_t requested_at = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    // Fetch every currency concurrently
+    std::vector<std::future<nlohmann::json>> responses;
+    responses.reserve(currencies.size());
+    for (const auto& currency : currencies) {
+        throttle("private/get_positions");
+        responses.push_back(async_rest_client_->call("private/get_positions", {
+            {"currency", currency}
+        }));
+    }
+    
+    bool complete = true;
+    for (size_t i = 0; i < responses.size(); ++i) {
+        nlohmann::json response = responses[i].get();
+        if (!response.contains("result")) {
+            DERIBIT_LOG_ERROR("Failed to reconcile positions for {}", currencies[i]);
+            complete = false;
+            continue;
+        }
+        
+        std::vector<Position> positions;
+        for (const auto& position_json : response["result"]) {
+            positions.emplace_back(position_json);
+        }
+        position_store_.reconcile(currencies[i], positions, requested_at);
+    }
+    
+    auto positions = position_store_.snapshot();
+    risk_engine_.syncPositions(*positions);
+    portfolio_engine_.syncPositions(*positions);
+    
+    return complete;
+}
+
+std::string ApiClient::newClientOrderId() {
+    return client_orders_.nextClientOrderId();
+}
+
+bool ApiClient::findClientOrder(const std::string& client_order_id, ClientOrder& order) const {
+    return client_orders_.find(client_order_id, order);
+}
+
+bool ApiClient::needsSend(const std::string& client_order_id, const std::string& instrument_name,
+                          const std::string& direction, double amount) {
+    ClientOrder existing;
+    if (!client_orders_.find(client_order_id, existing)) {
+        return true;
+    }
+    
+    // A reused id must describe the same order, or the retry would silently become a different one
+    if (existing.instrument_name != instrument_name || existing.direction != direction ||
+        existing.amount != amount) {
+        DERIBIT_LOG_ERROR("Order {} was sent as {} {} {}; refusing to reuse it for {} {} {}",
+            client_order_id, existing.direction, existing.amount, existing.instrument_name,
+            direction, amount, instrument_name);
+        return false;
+    }
+    if (existing.state == ClientOrderState::Rejected) {
+        return true;
+    }
+    
+    if (existing.state != ClientOrderState::Pending) {
+        DERIBIT_LOG_WARN("Order {} already placed as {}; not resending", client_order_id, existing.order_id);
+        return false;
+    }
+    
+    // Give an unacknowledged send time to land before asking the exchange
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (now - existing.sent_at < kAckTimeoutMs) {
+        DERIBIT_LOG_WARN("Order {} is awaiting its ack; not resending", client_order_id);
+        return false;
+    }
+    
+    Order order;
+    if (order_store_.findOrderByLabel(existing.label, order)) {
+        client_orders_.onOrder(order);
+        return false;
+    }
+    
+    // The ack was lost; the label tells us whether the order reached the book
+    const std::string& name = existing.instrument_name;
+    throttle("private/get_order_state_by_label");
+    auto lookup = async_rest_client_->call("private/get_order_state_by_label", {
+        {"currency", instrument_store_.settlementCurrency(name)},
+        {"label", existing.label}
+    });
+    // The caller's order thread waits here, so an unanswered lookup counts as unresolved
+    if (lookup.wait_for(std::chrono::milliseconds(kLookupTimeoutMs)) != std::future_status::ready) {
+        DERIBIT_LOG_WARN("Lookup of order {} timed out; not resending", client_order_id);
+        return false;
+    }
+    nlohmann::json response = lookup.get();
+    if (!response.contains("result")) {
+        DERIBIT_LOG_WARN("Could not resolve order {}; not resending", client_order_id);
+        return false;
+    }
+    
+    if (response["result"].empty()) {
+        client_orders_.onReject(client_order_id, "not found after ack timeout");
+        return true;
+    }
+    
+    for (const auto& order_json : response["result"]) {
+        client_orders_.onOrder(Order(order_json));
+    }
+    return false;
+}
+
+bool ApiClient::findOrder(const std::string& order_id, Order& order) const {
+    return order_store_.findOrder(order_id, order);
+}
+
+bool ApiClient::reconcileOrders() {
+    const auto& currencies = config_.getInstrumentCurrencies();
+    int64_t requested_at = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    // Fetch every currency concurrently
+    std::vector<std::future<nlohmann::json>> responses;
+    responses.reserve(currencies.size());
+    for (const auto& currency : currencies) {
+        throttle("private/get_open_orders_by_currency");
+        responses.push_back(async_rest_client_->call("private/get_open_orders_by_currency", {
+            {"currency", currency}
+        }));
+    }
+    
+    bool complete = true;
+    for (size_t i = 0; i < responses.size(); ++i) {
+        nlohmann::json response = responses[i].get();
+        if (!response.contains("result")) {
+            DERIBIT_LOG_ERROR("Failed to reconcile open orders for {}", currencies[i]);
+            complete = false;
+            continue;
+        }
+        
+        std::vector<Order> orders;
+        for (const auto& order_json : response["result"]) {
+            orders.emplace_back(order_json);
+        }
+        order_store_.reconcile(currencies[i], orders, requested_at);
+    }
+    risk_engine_.syncOpenOrders(order_store_.getOpenOrders());
+    
+    return complete;
+}
+
+InstrumentStore::InstrumentPtr ApiClient::getInstrument(const std::string& instrument_name) const {
+    return instrument_store_.find(instrument_name);
+}
+
+bool ApiClient::refreshInstruments() {
+    const auto& currencies = config_.getInstrumentCurrencies();
+    
+    // Fetch every currency concurrently
+    std::vector<std::future<nlohmann::json>> responses;
+    responses.reserve(currencies.size());
+    for (const auto& currency : currencies) {
+        throttle("public/get_instruments");
+        responses.push_back(async_rest_client_->call("public/get_instruments", {
+            {"currency", currency},
+            {"expired", false}
+        }));
+    }
+    
+    bool complete = true;
+    size_t changes = 0;
+    for (size_t i = 0; i < responses.size(); ++i) {
+        nlohmann::json response = responses[i].get();
+        if (!response.contains("result")) {
+            DERIBIT_LOG_ERROR("Failed to load instruments for {}", currencies[i]);
+            complete = false;
+            continue;
+        }
+        changes += instrument_store_.applyInstruments(currencies[i], response["result"]);
+    }
+    
+    if (changes > 0 && !config_.getInstrumentSnapshotPath().empty()) {
+        instrument_store_.saveSnapshot(config_.getInstrumentSnapshotPath(), config_.isTestnet());
+    }
+    return complete;
+}
+
+void ApiClient::loadInstruments() {
+    const std::string& snapshot_path = config_.getInstrumentSnapshotPath();
+    if (!snapshot_path.empty() &&
+        instrument_store_.loadSnapshot(snapshot_path, config_.isTestnet())) {
+        DERIBIT_LOG_INFO("Loaded {} instruments from {}", instrument_store_.size(), snapshot_path);
+        return;
+    }
+    
+    if (refreshInstruments()) {
+        DERIBIT_LOG_INFO("Loaded {} instruments", instrument_store_.size());
+    }
+}
+
+bool ApiClient::validateOrder(
+    const std::string& instrument_name,
+    double amount,
+    const std::string& type,
+    double& price,
+    bool is_buy,
+    double replaced_amount) {
+    
+    auto instrument = instrument_store_.find(instrument_name);
+    if (!instrument) {
+        // Let the exchange validate instruments we have no reference data for
+        return amount > 0.0 && checkRisk(instrument_name, amount, type, price, is_buy, nullptr, replaced_amount);
+    }
+    
+    if (!instrument->isActive()) {
+        DERIBIT_LOG_WARN("Instrument is not active: {}", instrument_name);
+        return false;
+    }
+    
+    if (!instrument->isValidAmount(amount)) {
+        DERIBIT_LOG_WARN("Amount must be a multiple of the minimum trade amount: {}", instrument->getMinTradeAmount());
+        return false;
+    }
+    
+    if (type == "limit") {
+        // Round passively so a rounded order is never more aggressive
+        price = is_buy ? instrument->roundPriceDown(price) : instrument->roundPriceUp(price);
+        if (price <= 0.0) {
+            DERIBIT_LOG_WARN("Invalid limit price for {}", instrument_name);
+            return false;
+        }
+    }
+    
+    return checkRisk(instrument_name, amount, type, price, is_buy, instrument.get(), replaced_amount);
+}
+
+bool ApiClient::checkRisk(
+    const std::string& instrument_name,
+    double amount,
+    const std::string& type,
+    double price,
+    bool is_buy,
+    const Instrument* instrument,
+    double replaced_amount) {
+    
+    RiskReason reason = risk_engine_.check(
+        instrument_name, is_buy, amount, type == "limit" ? price : 0.0, instrument, replaced_amount);
+    if (reason != RiskReason::Accepted) {
+        DERIBIT_LOG_WARN("Order rejected by risk check ({}): {}{} {}",
+            toString(reason), (is_buy ? "buy " : "sell "), amount, instrument_name);
+        return false;
+    }
+    return true;
+}
+
+void ApiClient::updateOpenOrderRisk(const std::string& instrument_name) {
+    double buy_amount = 0.0;
+    double sell_amount = 0.0;
+    for (const auto& order : order_store_.getOpenOrders(instrument_name)) {
+        double remaining = order.getAmount() - order.getFilledAmount();
+        (order.getDirection() == "buy" ? buy_amount : sell_amount) += remaining;
+    }
+    risk_engine_.updateOpenOrders(instrument_name, buy_amount, sell_amount);
+}
+
+void ApiClient::addMaintenanceTask(
+    std::chrono::steady_clock::duration interval,
+    std::function<void()> task,
+    bool run_now) {
+    std::lock_guard<std::mutex> lock(maintenance_mutex_);
+    auto now = std::chrono::steady_clock::now();
+    maintenance_tasks_.push_back({interval, run_now ? now : now + interval, std::move(task)});
+    maintenance_cv_.notify_all();
+}
+
+void ApiClient::startMaintenance() {
+    std::lock_guard<std::mutex> lock(maintenance_mutex_);
+    if (maintenance_running_) {
+        return;
+    }
+    maintenance_running_ = true;
+    maintenance_thread_ = std::thread(&ApiClient::runMaintenance, this);
+}
+
+void ApiClient::stopMaintenance() {
+    {
+        std::lock_guard<std::mutex> lock(maintenance_mutex_);
+        maintenance_running_ = false;
+    }
+    maintenance_cv_.notify_all();
+    if (maintenance_thread_.joinable()) {
+        maintenance_thread_.join();
+    }
+}
+
+void ApiClient::runMaintenance() {
+    DERIBIT_TRACE_THREAD_NAME("maintenance");
+    std::unique_lock<std::mutex> lock(maintenance_mutex_);
+    while (maintenance_running_) {
+        auto now = std::chrono::steady_clock::now();
+        auto next_wakeup = now + std::chrono::seconds(1);
+        
+        for (size_t i = 0; i < maintenance_tasks_.size(); ++i) {
+            if (maintenance_tasks_[i].next_run <= now) {
+                maintenance_tasks_[i].next_run = now + maintenance_tasks_[i].interval;
+                auto task = maintenance_tasks_[i].run;
+                
+                // Run without the lock so tasks may register further tasks
+                lock.unlock();
+                try {
+                    DERIBIT_TRACE_SCOPE("maintenance.task");
+                    task();
+                } catch (const std::exception& e) {
+                    DERIBIT_LOG_ERROR("Error in maintenance task: {}", e.what());
+                }
+                lock.lock();
+                if (!maintenance_running_) {
+                    return;
+                }
+            }
+            next_wakeup = std::min(next_wakeup, maintenance_tasks_[i].next_run);
+        }
+        
+        maintenance_cv_.wait_until(lock, next_wakeup);
+    }
+}
+
 void ApiClient::processWebSocketMessages() {
     // Set up message callback
     ws_client_->setMessageCallback([this](const std::string& message) {
+        receive_time_ = ws_client_->getReceiveTime();
         try {
-            nlohmann::json json = nlohmann::json::parse(message);
+            nlohmann::json json;
+            {
+                DERIBIT_TRACE_SCOPE("api.parse");
+                json = nlohmann::json::parse(message);
+            }
+            latency_.recordSince(static_cast<size_t>(LatencyStage::Parse), receive_time_);
             
             // Check if it's a notification
             if (json.contains("method") && json["method"] == "subscription") {
-                // Check if it's an orderbook update
-                if (json.contains("params") && json["params"].contains("channel") && 
-                    json["params"]["channel"].get<std::string>().find("book.") == 0) {
-                    
-                    handleOrderbookUpdate(json["params"]["data"]);
+                if (json.contains("params") && json["params"].contains("channel") &&
+                    json["params"].contains("data")) {
+                    // Exchange timestamps are wall-clock milliseconds, corrected by the estimated clock offset
+                    const auto& data = json["params"]["data"];
+                    auto timestamp = data.is_object() ? data.find("timestamp") : data.end();
+                    wire_latency_ns_ = 0;
+                    if (timestamp != data.end() && timestamp->is_number_integer()) {
+                        auto received = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            ws_client_->getReceiveWallTime().time_since_epoch()).count();
+                        wire_latency_ns_ = time_sync_->wireLatencyNs(timestamp->get<int64_t>(), received);
+                        latency_.record(static_cast<size_t>(LatencyStage::ExchangeToReceive),
+                                        static_cast<uint64_t>(wire_latency_ns_));
+                    }
+                    dispatchNotification(
+                        json["params"]["channel"].get<std::string>(),
+                        json["params"]["data"]);
                 }
+            } else if (json.contains("id")) {
+                handleResponse(json);
             }
         } catch (const nlohmann::json::exception& e) {
-            std::cerr << "JSON parsing error: " << e.what() << std::endl;
+            parse_errors_->inc();
+            DERIBIT_LOG_ERROR("JSON parsing error: {}", e.what());
         }
     });
     
@@ -387,6 +1377,167 @@ void ApiClient::processWebSocketMessages() {
     }
 }
 
+void ApiClient::dispatchNotification(const std::string& channel, const nlohmann::json& data) {
+    DERIBIT_TRACE_SCOPE("api.dispatch");
+    if (channel.compare(0, 5, "book.") == 0) {
+        countChannel(ChannelKind::Book);
+        handleOrderbookUpdate(data);
+    } else if (channel.compare(0, 6, "quote.") == 0 || channel.compare(0, 7, "ticker.") == 0) {
+        countChannel(ChannelKind::TopOfBook);
+        handleTopOfBookUpdate(data);
+    } else if (channel.compare(0, 7, "trades.") == 0) {
+        countChannel(ChannelKind::Trades);
+        handlePublicTrades(data);
+    } else if (channel.compare(0, 20, "deribit_price_index.") == 0) {
+        countChannel(ChannelKind::Index);
+        handleIndexUpdate(data);
+    } else if (channel.compare(0, 18, "markprice.options.") == 0) {
+        countChannel(ChannelKind::OptionMarks);
+        handleOptionMarkPrices(data);
+    } else if (channel.compare(0, 12, "user.orders.") == 0) {
+        countChannel(ChannelKind::UserOrders);
+        handleOrderUpdate(data);
+    } else if (channel.compare(0, 12, "user.trades.") == 0) {
+        countChannel(ChannelKind::UserTrades);
+        handleTradeUpdate(data);
+    } else if (channel.compare(0, 13, "user.changes.") == 0) {
+        countChannel(ChannelKind::UserChanges);
+        handleChangesUpdate(data);
+    } else if (channel.compare(0, 15, "user.portfolio.") == 0) {
+        countChannel(ChannelKind::UserPortfolio);
+        handlePortfolioUpdate(data);
+    } else {
+        countChannel(ChannelKind::Other);
+    }
+}
+
+void ApiClient::registerMetrics() {
+    // Hot-path metrics are resolved once here; handlers bump them through raw pointers
+    static const char* const kChannelNames[] = {
+        "book", "top_of_book", "trades", "price_index", "option_marks",
+        "user_orders", "user_trades", "user_changes", "user_portfolio", "other"
+    };
+    static_assert(sizeof(kChannelNames) / sizeof(kChannelNames[0]) == static_cast<size_t>(ChannelKind::Count),
+                  "one name per channel kind");
+    for (size_t i = 0; i < channel_messages_.size(); ++i) {
+        channel_messages_[i] = &metrics_.counter(
+            "deribit_ws_notifications_total", "Subscription notifications received, by channel family",
+            {{"channel", kChannelNames[i]}});
+    }
+    parse_errors_ = &metrics_.counter(
+        "deribit_ws_parse_errors_total", "WebSocket frames that failed to parse as JSON");
+    stale_book_updates_ = &metrics_.counter(
+        "deribit_stale_book_updates_total", "Book updates whose wire latency exceeded the stale feed threshold");
+    book_gaps_ = &metrics_.counter(
+        "deribit_book_gaps_total", "Book changes whose prev_change_id did not follow the live book");
+
+    static const char* const kOutcomeNames[] = {"accepted", "rejected", "blocked", "failed", "duplicate"};
+    static_assert(sizeof(kOutcomeNames) / sizeof(kOutcomeNames[0]) == static_cast<size_t>(OrderOutcome::Count),
+                  "one name per order outcome");
+    for (size_t m = 0; m < static_cast<size_t>(OrderMethod::Count); ++m) {
+        for (size_t o = 0; o < static_cast<size_t>(OrderOutcome::Count); ++o) {
+            order_outcomes_[m * static_cast<size_t>(OrderOutcome::Count) + o] = &metrics_.counter(
+                "deribit_orders_total", "Order requests by method and outcome",
+                {{"method", toString(static_cast<OrderMethod>(m))}, {"outcome", kOutcomeNames[o]}});
+        }
+    }
+
+    // Seconds; the limiter only waits when a bucket is empty, so most samples land in the first bucket
+    const std::vector<double> wait_bounds{0.0001, 0.001, 0.005, 0.01, 0.05, 0.1, 0.25, 0.5, 1.0, 5.0};
+    rate_limit_waits_[static_cast<size_t>(RequestClass::MatchingEngine)] = &metrics_.histogram(
+        "deribit_rate_limit_wait_seconds", "Time requests waited for rate limit credits",
+        wait_bounds, {{"class", "matching_engine"}});
+    rate_limit_waits_[static_cast<size_t>(RequestClass::NonMatching)] = &metrics_.histogram(
+        "deribit_rate_limit_wait_seconds", "Time requests waited for rate limit credits",
+        wait_bounds, {{"class", "non_matching"}});
+
+    // Everything below is read from its owner at scrape time, on the metrics thread
+    metrics_.callback("deribit_ws_connected", "Whether the WebSocket is connected", MetricsRegistry::Type::Gauge,
+        [this]() { return ws_client_ && ws_client_->isConnected() ? 1.0 : 0.0; });
+    metrics_.callback("deribit_ws_connects_total", "WebSocket connections opened", MetricsRegistry::Type::Counter,
+        [this]() { return ws_client_ ? static_cast<double>(ws_client_->getConnectCount()) : 0.0; });
+    metrics_.callback("deribit_ws_disconnects_total", "WebSocket connections closed or failed",
+        MetricsRegistry::Type::Counter,
+        [this]() { return ws_client_ ? static_cast<double>(ws_client_->getDisconnectCount()) : 0.0; });
+    metrics_.callback("deribit_frame_journal_frames_total", "WebSocket frames written to the frame journal",
+        MetricsRegistry::Type::Counter,
+        [this]() { return ws_client_ ? static_cast<double>(ws_client_->getFrameJournalStats().frames) : 0.0; });
+    metrics_.callback("deribit_frame_journal_dropped_total", "WebSocket frames the frame journal had no room for",
+        MetricsRegistry::Type::Counter,
+        [this]() { return ws_client_ ? static_cast<double>(ws_client_->getFrameJournalStats().dropped) : 0.0; });
+    metrics_.callback("deribit_rest_queued_requests", "Async REST requests waiting for a connection slot",
+        MetricsRegistry::Type::Gauge,
+        [this]() { return async_rest_client_ ? static_cast<double>(async_rest_client_->getQueuedCount()) : 0.0; });
+    metrics_.callback("deribit_rest_in_flight_requests", "Async REST requests in flight",
+        MetricsRegistry::Type::Gauge,
+        [this]() { return async_rest_client_ ? static_cast<double>(async_rest_client_->getInFlightCount()) : 0.0; });
+
+    static const char* const kLaneNames[] = {"cancel", "risk_reducing", "order", "query"};
+    for (auto request_class : {RequestClass::MatchingEngine, RequestClass::NonMatching}) {
+        std::string class_name = request_class == RequestClass::MatchingEngine ? "matching_engine" : "non_matching";
+        metrics_.callback("deribit_rate_limit_available_credits", "Rate limit credits currently available",
+            MetricsRegistry::Type::Gauge,
+            [this, request_class]() { return rate_limiter_->getAvailableCredits(request_class); },
+            {{"class", class_name}});
+        for (size_t lane = 0; lane < 4; ++lane) {
+            metrics_.callback("deribit_rate_limit_queue_depth", "Requests queued for rate limit credits",
+                MetricsRegistry::Type::Gauge,
+                [this, request_class, lane]() {
+                    return static_cast<double>(
+                        rate_limiter_->getQueueDepth(request_class, static_cast<RequestPriority>(lane)));
+                },
+                {{"class", class_name}, {"lane", kLaneNames[lane]}});
+        }
+    }
+
+    for (size_t i = 1; i < static_cast<size_t>(RiskReason::Count); ++i) {
+        metrics_.callback("deribit_risk_rejections_total", "Orders refused by pre-trade risk checks",
+            MetricsRegistry::Type::Counter,
+            [this, i]() { return static_cast<double>(risk_engine_.getStats().rejections[i]); },
+            {{"reason", toString(static_cast<RiskReason>(i))}});
+    }
+    metrics_.callback("deribit_clock_offset_seconds", "Estimated exchange clock minus local wall clock",
+        MetricsRegistry::Type::Gauge,
+        [this]() { return static_cast<double>(getTimeSyncStats().offset_ns) / 1e9; });
+    metrics_.callback("deribit_clock_rtt_seconds", "Round trip of the public/get_time probe the offset is taken from",
+        MetricsRegistry::Type::Gauge,
+        [this]() { return static_cast<double>(getTimeSyncStats().rtt_ns) / 1e9; });
+    metrics_.callback("deribit_kill_switch_engaged", "Whether the kill switch has halted trading",
+        MetricsRegistry::Type::Gauge,
+        [this]() { return risk_engine_.isHalted() ? 1.0 : 0.0; });
+    metrics_.callback("deribit_kill_switch_triggers_total", "Kill switch cancel requests sent",
+        MetricsRegistry::Type::Counter,
+        [this]() { return static_cast<double>(getKillSwitchStats().triggers); });
+}
+
+void ApiClient::handleResponse(const nlohmann::json& response) {
+    DERIBIT_TRACE_SCOPE("api.response");
+    if (!response["id"].is_number_unsigned()) {
+        return;
+    }
+    
+    uint64_t id = response["id"].get<uint64_t>();
+    if (QuoteEngine::ownsRequest(id)) {
+        quote_engine_->onResponse(response);
+    } else if (ClientOrderTracker::ownsRequest(id)) {
+        order_latency_.onAck(id, response);
+        client_orders_.onResponse(response);
+        countOrder(OrderMethod::Buy, response.contains("error") ? OrderOutcome::Rejected : OrderOutcome::Accepted);
+        if (response.contains("error")) {
+            DERIBIT_LOG_ERROR("Order placement failed: {}", response["error"].value("message", std::string()));
+        }
+    } else if (KillSwitch::ownsRequest(id)) {
+        kill_switch_->onResponse(response);
+    } else if (TimeSync::ownsRequest(id)) {
+        time_sync_->onResponse(response, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            ws_client_->getReceiveWallTime().time_since_epoch()).count());
+    } else if (id == 9932 && response.contains("result")) {
+        DERIBIT_LOG_INFO("Cancel-on-disconnect enabled");
+    } else if (response.contains("error")) {
+        DERIBIT_LOG_ERROR("WebSocket request {} failed: {}", id, response["error"].value("message", std::string()));
+    }
+}
+
 void ApiClient::handleOrderbookUpdate(const nlohmann::json& data) {
     if (!data.contains("instrument_name")) {
         return;
@@ -404,14 +1555,315 @@ void ApiClient::handleOrderbookUpdate(const nlohmann::json& data) {
         }
     }
     
-    // Call the callback if found
-    if (callback) {
-        try {
-            Orderbook orderbook(data);
+    try {
+        // Apply the update to the live book; snapshots replace it outright
+        Orderbook orderbook;
+        double mid = 0.0;
+        int64_t book_time = 0;
+        {
+            DERIBIT_TRACE_SCOPE("book.apply");
+            std::lock_guard<std::mutex> lock(books_mutex_);
+            auto it = live_books_.find(instrument_name);
+            bool is_delta = data.contains("type") && data["type"] == "change";
+            if (is_delta) {
+                // No book means a resync is pending; its snapshot starts the book again
+                if (it == live_books_.end()) {
+                    return;
+                }
+                if (data.contains("prev_change_id") &&
+                    data["prev_change_id"].get<int64_t>() != it->second.getChangeId()) {
+                    DERIBIT_LOG_WARN("Book {} missed changes after {} (next follows {}); resubscribing",
+                        instrument_name, it->second.getChangeId(), data["prev_change_id"].get<int64_t>());
+                    book_gaps_->inc();
+                    live_books_.erase(it);
+                    book_resyncs_.push_back(instrument_name);
+                    return;
+                }
+            }
+            int64_t previous_latency = it != live_books_.end() ? it->second.getWireLatency() : 0;
+            if (is_delta) {
+                it->second.update(data);
+            } else {
+                it = live_books_.insert_or_assign(instrument_name, Orderbook(data)).first;
+            }
+            it->second.setWireLatency(wire_latency_ns_);
+            
+            // Log only transitions; every late update is counted once the clock offset is known
+            int64_t stale_after = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                config_.getStaleFeedThreshold()).count();
+            bool synced = time_sync_->isSynced();
+            if (synced && wire_latency_ns_ > stale_after) {
+                stale_book_updates_->inc();
+                if (previous_latency <= stale_after) {
+                    DERIBIT_LOG_WARN("Book {} is stale: update arrived {}ms after its exchange timestamp",
+                        instrument_name, wire_latency_ns_ / 1000000);
+                }
+            } else if (synced && previous_latency > stale_after) {
+                DERIBIT_LOG_INFO("Book {} caught up", instrument_name);
+            }
+            double best_bid = it->second.getBestBidPrice();
+            double best_ask = it->second.getBestAskPrice();
+            if (best_bid > 0.0 && best_ask > 0.0) {
+                mid = (best_bid + best_ask) / 2.0;
+                book_time = it->second.getTimestamp();
+            }
+            if (callback) {
+                orderbook = it->second;
+            }
+        }
+        
+        // Outside the book lock: bar callbacks may read books back and option solves would stall book readers
+        if (mid > 0.0) {
+            risk_engine_.updateMid(instrument_name, mid);
+            candle_engine_.onMid(instrument_name, book_time, mid);
+            if (options_engine_.updateOptionPrice(instrument_name, mid, 0.0)) {
+                options_engine_.recompute(book_time);
+            }
+            updatePortfolioMark(instrument_name, mid, book_time, false);
+        }
+        latency_.recordSince(static_cast<size_t>(LatencyStage::BookApply), receive_time_);
+        
+        // Call the callback if found
+        if (callback) {
+            auto entry = std::chrono::steady_clock::now();
+            latency_.record(static_cast<size_t>(LatencyStage::CallbackEntry), static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(entry - receive_time_).count()));
+            DERIBIT_TRACE_SCOPE("book.callback");
             callback(orderbook);
-        } catch (const std::exception& e) {
-            std::cerr << "Error processing orderbook update: " << e.what() << std::endl;
+            latency_.recordSince(static_cast<size_t>(LatencyStage::CallbackDuration), entry);
+        }
+    } catch (const std::exception& e) {
+        DERIBIT_LOG_ERROR("Error processing orderbook update: {}", e.what());
+    }
+}
+
+void ApiClient::resyncBooks() {
+    std::vector<std::string> instruments;
+    {
+        std::lock_guard<std::mutex> lock(books_mutex_);
+        instruments.swap(book_resyncs_);
+    }
+    
+    for (const auto& instrument_name : instruments) {
+        {
+            std::lock_guard<std::mutex> lock(callbacks_mutex_);
+            if (orderbook_callbacks_.find(instrument_name) == orderbook_callbacks_.end()) {
+                continue;
+            }
+        }
+        
+        // Changes still in flight on the old subscription arrive before the new snapshot and are dropped
+        std::string channel = "book." + instrument_name + ".100ms";
+        throttle("public/unsubscribe");
+        ws_client_->unsubscribe(channel);
+        throttle("public/subscribe");
+        nlohmann::json params;
+        params["instrument_name"] = instrument_name;
+        if (!ws_client_->subscribe(channel, params)) {
+            DERIBIT_LOG_ERROR("Failed to resubscribe to {}; retrying", channel);
+            std::lock_guard<std::mutex> lock(books_mutex_);
+            book_resyncs_.push_back(instrument_name);
+        }
+    }
+}
+
+void ApiClient::handleOrderUpdate(const nlohmann::json& data) {
+    // Raw channels send one order, aggregated channels an array
+    auto apply = [this](const Order& order) {
+        order_store_.applyOrder(order);
+        updateOpenOrderRisk(order.getInstrumentName());
+        client_orders_.onOrder(order);
+        order_latency_.onOrder(order);
+        quote_engine_->onOrderUpdate(order);
+    };
+    
+    if (data.is_array()) {
+        for (const auto& order_json : data) {
+            apply(Order(order_json));
         }
+    } else {
+        apply(Order(data));
+    }
+}
+
+void ApiClient::handleTopOfBookUpdate(const nlohmann::json& data) {
+    if (!data.contains("instrument_name")) {
+        return;
+    }
+    
+    const std::string& instrument_name = data["instrument_name"].get_ref<const std::string&>();
+    DERIBIT_TRACE_SCOPE("top_of_book.update");
+    std::shared_ptr<SeqLock<TopOfBook>> slot;
+    {
+        std::lock_guard<std::mutex> lock(top_of_book_mutex_);
+        auto it = top_of_book_.find(instrument_name);
+        if (it == top_of_book_.end()) {
+            return;
+        }
+        slot = it->second;
+    }
+    
+    // Only this thread writes the slot, so the read-modify-write cannot race
+    TopOfBook top = slot->load();
+    top.update(data);
+    slot->store(top);
+    
+    double mid = top.getMidPrice();
+    if (mid > 0.0) {
+        risk_engine_.updateMid(instrument_name, mid);
+        candle_engine_.onMid(instrument_name, top.timestamp, mid);
+    }
+    
+    // Options without a two-sided market are priced off their mark
+    double option_price = mid > 0.0 ? mid : top.mark_price;
+    if (option_price > 0.0 &&
+        options_engine_.updateOptionPrice(instrument_name, option_price, data.value("underlying_price", 0.0))) {
+        options_engine_.recompute(top.timestamp);
+    }
+    
+    if (top.mark_price > 0.0) {
+        updatePortfolioMark(instrument_name, top.mark_price, top.timestamp, true);
+    } else if (mid > 0.0) {
+        updatePortfolioMark(instrument_name, mid, top.timestamp, false);
+    }
+}
+
+void ApiClient::handleIndexUpdate(const nlohmann::json& data) {
+    if (!data.contains("index_name") || !data.contains("price")) {
+        return;
+    }
+    
+    // Index names look like "btc_usd"
+    std::string currency = data["index_name"].get<std::string>();
+    currency = currency.substr(0, currency.find('_'));
+    std::transform(currency.begin(), currency.end(), currency.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    
+    int64_t timestamp = data.value("timestamp", int64_t(0));
+    options_engine_.updateIndex(currency, data["price"].get<double>(), timestamp);
+    portfolio_engine_.updateIndex(currency, data["price"].get<double>(), timestamp);
+    risk_engine_.updateIndex(currency, data["price"].get<double>());
+    
+    // Prices queued before the first index had no forward yet
+    options_engine_.recompute(timestamp);
+}
+
+void ApiClient::updatePortfolioMark(const std::string& instrument_name, double mark_price, int64_t timestamp,
+                                    bool exchange_mark) {
+    PositionRisk held;
+    if (!portfolio_engine_.getPositionRisk(instrument_name, held)) {
+        return;
+    }
+    
+    double option_delta = std::numeric_limits<double>::quiet_NaN();
+    OptionGreeks greeks;
+    if (options_engine_.getGreeks(instrument_name, greeks)) {
+        // Coin-settled option deltas are premium-adjusted, matching what Deribit reports
+        auto instrument = instrument_store_.find(instrument_name);
+        bool coin_settled = instrument && instrument->getSettlementCurrency() == instrument->getBaseCurrency();
+        option_delta = coin_settled ? greeks.delta - mark_price : greeks.delta;
+    }
+    
+    // The book mid only stands in until the exchange has published a mark
+    if (exchange_mark) {
+        portfolio_engine_.updateMark(instrument_name, mark_price, timestamp, option_delta);
+    } else {
+        portfolio_engine_.updateMid(instrument_name, mark_price, timestamp, option_delta);
+    }
+}
+
+void ApiClient::handleOptionMarkPrices(const nlohmann::json& data) {
+    if (!data.is_array() || data.empty()) {
+        return;
+    }
+    
+    // One message carries the whole chain; queue it all and solve as one batch
+    int64_t timestamp = 0;
+    for (const auto& mark : data) {
+        if (mark.contains("instrument_name") && mark.contains("mark_price")) {
+            options_engine_.updateOptionPrice(
+                mark["instrument_name"].get_ref<const std::string&>(),
+                mark["mark_price"].get<double>(), 0.0);
+            timestamp = std::max(timestamp, mark.value("timestamp", int64_t(0)));
+        }
+    }
+    options_engine_.recompute(timestamp);
+    
+    // Held options are revalued after the solve so they pick up fresh deltas
+    for (const auto& mark : data) {
+        if (mark.contains("instrument_name") && mark.contains("mark_price")) {
+            updatePortfolioMark(
+                mark["instrument_name"].get_ref<const std::string&>(),
+                mark["mark_price"].get<double>(), timestamp, true);
+        }
+    }
+}
+
+void ApiClient::handlePublicTrades(const nlohmann::json& data) {
+    if (!data.is_array() || data.empty() || !data[0].contains("instrument_name")) {
+        return;
+    }
+    
+    // Each trades.* channel carries a single instrument
+    std::shared_ptr<TradeRing> ring;
+    {
+        std::lock_guard<std::mutex> lock(trade_rings_mutex_);
+        auto it = trade_rings_.find(data[0]["instrument_name"].get<std::string>());
+        if (it == trade_rings_.end()) {
+            return;
+        }
+        ring = it->second;
+    }
+    
+    const std::string& instrument_name = data[0]["instrument_name"].get_ref<const std::string&>();
+    for (const auto& trade_json : data) {
+        TradeRecord record = TradeRecord::fromJson(trade_json);
+        ring->push(record);
+        candle_engine_.onTrade(instrument_name, record);
+    }
+}
+
+void ApiClient::handleTradeUpdate(const nlohmann::json& data) {
+    if (data.is_array()) {
+        for (const auto& trade_json : data) {
+            order_store_.applyTrade(trade_json);
+            client_orders_.onTrade(trade_json);
+        }
+    } else {
+        order_store_.applyTrade(data);
+        client_orders_.onTrade(data);
+    }
+}
+
+void ApiClient::handleChangesUpdate(const nlohmann::json& data) {
+    // Orders and trades also arrive on their own channels; only positions are used here
+    if (data.contains("positions")) {
+        position_store_.applyPositions(data["positions"]);
+        for (const auto& position_json : data["positions"]) {
+            portfolio_engine_.applyPosition(Position(position_json));
+            if (position_json.contains("instrument_name") && position_json.contains("size")) {
+                risk_engine_.updatePosition(
+                    position_json["instrument_name"].get<std::string>(),
+                    position_json["size"].get<double>());
+            }
+        }
+    }
+}
+
+void ApiClient::handlePortfolioUpdate(const nlohmann::json& data) {
+    position_store_.applyPortfolio(Portfolio(data));
+}
+
+void ApiClient::throttle(const std::string& method, bool reduce_only) {
+    auto waited = rate_limiter_->acquire(
+        RateLimiter::classify(method),
+        RateLimiter::prioritize(method, reduce_only));
+    rate_limit_waits_[static_cast<size_t>(RateLimiter::classify(method))]->observe(
+        std::chrono::duration<double>(waited).count());
+    
+    if (waited > std::chrono::milliseconds(100)) {
+        DERIBIT_LOG_WARN("Rate limiter delayed {} by {}ms",
+            method, std::chrono::duration_cast<std::chrono::milliseconds>(waited).count());
     }
 }
 
@@ -0,0 +1,301 @@
+#include "deribit/async_rest_client.hpp"
+#include "deribit/curl_global.hpp"
+#include "deribit/logger.hpp"
+#include "deribit/trace.hpp"
+#include <vector>
+
+namespace deribit {
+
+// A stalled connection fails its request instead of leaving the future unresolved
+constexpr long kConnectTimeoutMs = 5000;
+constexpr long kRequestTimeoutMs = 10000;
+
+// Callback function for CURL to write response data
+static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
+    userp->append((char*)contents, size * nmemb);
+    return size * nmemb;
+}
+
+AsyncRestClient::AsyncRestClient(const Config& config)
+    : config_(config) {
+}
+
+AsyncRestClient::~AsyncRestClient() {
+    shutdown();
+}
+
+bool AsyncRestClient::initialize() {
+    if (is_running_) {
+        return true;
+    }
+
+    if (!curlGlobalInit()) {
+        return false;
+    }
+
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        return false;
+    }
+
+    // Multiplex concurrent requests over a single HTTP/2 connection where possible
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS,
+        static_cast<long>(config_.getMaxConcurrentRequests()));
+
+    is_running_ = true;
+    event_thread_ = std::thread(&AsyncRestClient::run, this);
+    return true;
+}
+
+void AsyncRestClient::shutdown() {
+    if (!multi_) {
+        return;
+    }
+
+    // Flipped under the queue lock so no call() can enqueue or wake multi_ after this
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        is_running_ = false;
+        curl_multi_wakeup(multi_);
+    }
+    if (event_thread_.joinable()) {
+        event_thread_.join();
+    }
+
+    // Fail anything still queued so that no future is left dangling
+    std::deque<std::unique_ptr<Request>> pending;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        pending.swap(queue_);
+    }
+    for (auto& request : pending) {
+        failRequest(std::move(request));
+    }
+
+    curl_multi_cleanup(multi_);
+    multi_ = nullptr;
+}
+
+void AsyncRestClient::setTokenProvider(TokenProvider provider) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    token_provider_ = std::move(provider);
+}
+
+std::future<nlohmann::json> AsyncRestClient::call(
+    const std::string& method,
+    const nlohmann::json& params) {
+
+    auto promise = std::make_shared<std::promise<nlohmann::json>>();
+    auto future = promise->get_future();
+
+    call(method, params, [promise](const nlohmann::json& response) {
+        promise->set_value(response);
+    });
+
+    return future;
+}
+
+void AsyncRestClient::call(
+    const std::string& method,
+    const nlohmann::json& params,
+    ResponseCallback callback) {
+
+    auto request = std::make_unique<Request>();
+    request->callback = std::move(callback);
+
+    if (!is_running_) {
+        DERIBIT_LOG_ERROR("Async REST client not running");
+        failRequest(std::move(request));
+        return;
+    }
+
+    nlohmann::json body = {
+        {"jsonrpc", "2.0"},
+        {"id", next_id_++},
+        {"method", method},
+        {"params", params.is_null() ? nlohmann::json::object() : params}
+    };
+    request->body = body.dump();
+
+    request->headers = curl_slist_append(request->headers, "Content-Type: application/json");
+
+    std::string token;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (token_provider_ && method.compare(0, 8, "private/") == 0) {
+            token = token_provider_();
+        }
+    }
+    if (!token.empty()) {
+        std::string auth_header = "Authorization: Bearer " + token;
+        request->headers = curl_slist_append(request->headers, auth_header.c_str());
+    }
+
+    request->easy = curl_easy_init();
+    if (!request->easy) {
+        DERIBIT_LOG_ERROR("Failed to create CURL handle");
+        failRequest(std::move(request));
+        return;
+    }
+
+    std::string url = config_.getRestApiUrl();
+    CURL* easy = request->easy;
+    curl_easy_setopt(easy, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(easy, CURLOPT_POST, 1L);
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request->body.c_str());
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(request->body.size()));
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, request->headers);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &request->response);
+    curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT_MS, kConnectTimeoutMs);
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, kRequestTimeoutMs);
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, request.get());
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (is_running_) {
+            queue_.push_back(std::move(request));
+            // Under the lock, so shutdown() cannot have cleaned up multi_
+            curl_multi_wakeup(multi_);
+        }
+    }
+    if (request) {
+        DERIBIT_LOG_ERROR("Async REST client not running");
+        failRequest(std::move(request));
+    }
+}
+
+size_t AsyncRestClient::getQueuedCount() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return queue_.size();
+}
+
+void AsyncRestClient::run() {
+    DERIBIT_TRACE_THREAD_NAME("rest_async");
+    while (is_running_) {
+        startQueuedRequests();
+
+        int running_handles = 0;
+        CURLMcode mc = curl_multi_perform(multi_, &running_handles);
+        if (mc != CURLM_OK) {
+            DERIBIT_LOG_ERROR("curl_multi_perform failed: {}", curl_multi_strerror(mc));
+        }
+
+        int messages_left = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &messages_left)) {
+            if (msg->msg == CURLMSG_DONE) {
+                completeRequest(msg->easy_handle, msg->data.result);
+            }
+        }
+
+        // Sleep until there is socket activity, a wakeup or the timeout expires
+        mc = curl_multi_poll(multi_, nullptr, 0, 100, nullptr);
+        if (mc != CURLM_OK) {
+            DERIBIT_LOG_ERROR("curl_multi_poll failed: {}", curl_multi_strerror(mc));
+        }
+    }
+
+    // Abort whatever is still in flight
+    std::unordered_set<CURL*> handles;
+    handles.swap(active_handles_);
+    for (CURL* handle : handles) {
+        completeRequest(handle, CURLE_ABORTED_BY_CALLBACK);
+    }
+}
+
+void AsyncRestClient::startQueuedRequests() {
+    const size_t max_in_flight = config_.getMaxConcurrentRequests();
+
+    std::vector<std::unique_ptr<Request>> ready;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        while (!queue_.empty() && in_flight_ + ready.size() < max_in_flight) {
+            ready.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+    }
+
+    for (auto& request : ready) {
+        CURLMcode mc = curl_multi_add_handle(multi_, request->easy);
+        if (mc != CURLM_OK) {
+            DERIBIT_LOG_ERROR("Failed to start request: {}", curl_multi_strerror(mc));
+            failRequest(std::move(request));
+            continue;
+        }
+        active_handles_.insert(request->easy);
+        request.release();
+        ++in_flight_;
+    }
+}
+
+void AsyncRestClient::completeRequest(CURL* easy, CURLcode result) {
+    DERIBIT_TRACE_SCOPE("rest_async.complete");
+    Request* raw = nullptr;
+    curl_easy_getinfo(easy, CURLINFO_PRIVATE, &raw);
+    curl_multi_remove_handle(multi_, easy);
+    active_handles_.erase(easy);
+    --in_flight_;
+
+    std::unique_ptr<Request> request(raw);
+    if (!request) {
+        curl_easy_cleanup(easy);
+        return;
+    }
+
+    if (result != CURLE_OK) {
+        DERIBIT_LOG_ERROR("Async request failed: {}", curl_easy_strerror(result));
+        failRequest(std::move(request));
+        return;
+    }
+
+    long http_code = 0;
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &http_code);
+    nlohmann::json response = handleResponse(*request, http_code);
+
+    curl_easy_cleanup(request->easy);
+    curl_slist_free_all(request->headers);
+    request->easy = nullptr;
+    request->headers = nullptr;
+
+    try {
+        request->callback(response);
+    } catch (const std::exception& e) {
+        DERIBIT_LOG_ERROR("Error in async response callback: {}", e.what());
+    }
+}
+
+void AsyncRestClient::failRequest(std::unique_ptr<Request> request) {
+    if (request->easy) {
+        curl_easy_cleanup(request->easy);
+    }
+    if (request->headers) {
+        curl_slist_free_all(request->headers);
+    }
+
+    if (request->callback) {
+        try {
+            request->callback(nlohmann::json());
+        } catch (const std::exception& e) {
+            DERIBIT_LOG_ERROR("Error in async response callback: {}", e.what());
+        }
+    }
+}
+
+nlohmann::json AsyncRestClient::handleResponse(const Request& request, long http_code) const {
+    try {
+        auto json = nlohmann::json::parse(request.response);
+        if (http_code != 200 && json.contains("error")) {
+            DERIBIT_LOG_ERROR("HTTP request failed with code {}: {}", http_code, json["error"]["message"].dump());
+        }
+        return json;  // Error responses are returned for better error handling
+    } catch (const nlohmann::json::exception& e) {
+        DERIBIT_LOG_ERROR("JSON parsing error (HTTP {}): {}", http_code, e.what());
+        return nlohmann::json();
+    }
+}
+
+} // namespace deribit
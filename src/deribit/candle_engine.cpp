@@ -0,0 +1,158 @@
+#include "deribit/candle_engine.hpp"
+#include "deribit/logger.hpp"
+#include <algorithm>
+
+namespace deribit {
+
+CandleEngine::CandleEngine(const std::vector<std::chrono::milliseconds>& intervals, size_t history)
+    : history_(std::max<size_t>(history, 1)) {
+    // Bars are aligned with timestamp % interval, which needs a positive interval
+    for (const auto& interval : intervals) {
+        if (interval.count() <= 0) {
+            DERIBIT_LOG_WARN("Ignoring candle interval of {} ms", interval.count());
+            continue;
+        }
+        intervals_.push_back(interval);
+    }
+}
+
+void CandleEngine::track(const std::string& instrument_name, CandleSource source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& instrument = instruments_[instrument_name];
+    instrument.source = source;
+    if (!instrument.series.empty()) {
+        return;
+    }
+
+    instrument.series.reserve(intervals_.size());
+    for (const auto& interval : intervals_) {
+        Series series;
+        series.interval_ms = interval.count();
+        series.history.resize(history_);
+        instrument.series.push_back(std::move(series));
+    }
+}
+
+void CandleEngine::untrack(const std::string& instrument_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    instruments_.erase(instrument_name);
+}
+
+void CandleEngine::setBarCallback(BarCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bar_callback_ = std::move(callback);
+}
+
+void CandleEngine::onTrade(const std::string& instrument_name, const TradeRecord& trade) {
+    apply(instrument_name, CandleSource::Trades, trade.timestamp, trade.price, trade.amount);
+}
+
+void CandleEngine::onMid(const std::string& instrument_name, int64_t timestamp, double mid) {
+    apply(instrument_name, CandleSource::Mid, timestamp, toFixedPoint(mid), 0);
+}
+
+std::vector<Candle> CandleEngine::getCandles(
+    const std::string& instrument_name,
+    std::chrono::milliseconds interval) const {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Candle> candles;
+    const Series* series = findSeries(instrument_name, interval);
+    if (!series) {
+        return candles;
+    }
+
+    candles.reserve(series->count);
+    size_t first = (series->next + series->history.size() - series->count) % series->history.size();
+    for (size_t i = 0; i < series->count; ++i) {
+        candles.push_back(series->history[(first + i) % series->history.size()]);
+    }
+    return candles;
+}
+
+bool CandleEngine::getCurrentCandle(
+    const std::string& instrument_name,
+    std::chrono::milliseconds interval,
+    Candle& candle) const {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Series* series = findSeries(instrument_name, interval);
+    if (!series || !series->has_current) {
+        return false;
+    }
+    candle = series->current;
+    return true;
+}
+
+void CandleEngine::apply(
+    const std::string& instrument_name,
+    CandleSource source,
+    int64_t timestamp,
+    int64_t price,
+    int64_t volume) {
+
+    std::vector<ClosedBar> closed;
+    BarCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = instruments_.find(instrument_name);
+        if (it == instruments_.end() || it->second.source != source) {
+            return;
+        }
+
+        for (auto& series : it->second.series) {
+            int64_t start = timestamp - timestamp % series.interval_ms;
+            Candle& current = series.current;
+
+            // Late updates for an already closed bar are dropped
+            if (series.has_current && start < current.start) {
+                continue;
+            }
+
+            if (!series.has_current || start > current.start) {
+                if (series.has_current) {
+                    series.history[series.next] = current;
+                    series.next = (series.next + 1) % series.history.size();
+                    series.count = std::min(series.count + 1, series.history.size());
+                    if (bar_callback_) {
+                        closed.push_back({std::chrono::milliseconds(series.interval_ms), current});
+                    }
+                }
+                current = Candle{start, price, price, price, price, 0, 0};
+                series.has_current = true;
+            }
+
+            current.high = std::max(current.high, price);
+            current.low = std::min(current.low, price);
+            current.close = price;
+            current.volume += volume;
+            ++current.trades;
+        }
+
+        if (!closed.empty()) {
+            callback = bar_callback_;
+        }
+    }
+
+    for (const auto& bar : closed) {
+        callback(instrument_name, bar.interval, bar.candle);
+    }
+}
+
+const CandleEngine::Series* CandleEngine::findSeries(
+    const std::string& instrument_name,
+    std::chrono::milliseconds interval) const {
+
+    auto it = instruments_.find(instrument_name);
+    if (it == instruments_.end()) {
+        return nullptr;
+    }
+    for (const auto& series : it->second.series) {
+        if (series.interval_ms == interval.count()) {
+            return &series;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace deribit
@@ -0,0 +1,211 @@
+#include "deribit/client_order_tracker.hpp"
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <algorithm>
+
+namespace deribit {
+
+namespace {
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+ClientOrderTracker::ClientOrderTracker() {
+    // A random session prefix keeps ids unique across restarts
+    std::random_device random;
+    std::ostringstream prefix;
+    prefix << "c" << std::hex << random();
+    prefix_ = prefix.str();
+}
+
+std::string ClientOrderTracker::nextClientOrderId() {
+    return prefix_ + "-" + std::to_string(next_sequence_.fetch_add(1, std::memory_order_relaxed));
+}
+
+std::string ClientOrderTracker::labelFor(const std::string& label, const std::string& client_order_id) {
+    return label.empty() ? client_order_id : label + "/" + client_order_id;
+}
+
+std::string ClientOrderTracker::clientOrderIdOf(const std::string& label) {
+    size_t separator = label.rfind('/');
+    return separator == std::string::npos ? label : label.substr(separator + 1);
+}
+
+uint64_t ClientOrderTracker::track(
+    const std::string& client_order_id,
+    const std::string& label,
+    const std::string& instrument_name,
+    const std::string& direction,
+    double amount,
+    double price) {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(client_order_id);
+    if (it != orders_.end() && it->second.state != ClientOrderState::Rejected) {
+        return 0;
+    }
+
+    uint64_t request_id = next_request_id_++;
+    if (next_request_id_ == kLastRequestId) {
+        next_request_id_ = kFirstRequestId;
+    }
+
+    ClientOrder& tracked = orders_[client_order_id];
+    tracked = ClientOrder();
+    tracked.client_order_id = client_order_id;
+    tracked.label = label;
+    tracked.instrument_name = instrument_name;
+    tracked.direction = direction;
+    tracked.amount = amount;
+    tracked.price = price;
+    tracked.request_id = request_id;
+    tracked.sent_at = nowMs();
+    client_id_by_request_[request_id] = client_order_id;
+    return request_id;
+}
+
+bool ClientOrderTracker::find(const std::string& client_order_id, ClientOrder& order) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(client_order_id);
+    if (it == orders_.end()) {
+        return false;
+    }
+    order = it->second;
+    return true;
+}
+
+bool ClientOrderTracker::findByOrderId(const std::string& order_id, ClientOrder& order) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto index_it = client_id_by_order_id_.find(order_id);
+    if (index_it == client_id_by_order_id_.end()) {
+        return false;
+    }
+    auto it = orders_.find(index_it->second);
+    if (it == orders_.end()) {
+        return false;
+    }
+    order = it->second;
+    return true;
+}
+
+void ClientOrderTracker::onResponse(const nlohmann::json& response) {
+    if (!response.contains("id")) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto request_it = client_id_by_request_.find(response["id"].get<uint64_t>());
+    if (request_it == client_id_by_request_.end()) {
+        return;
+    }
+    auto it = orders_.find(request_it->second);
+    client_id_by_request_.erase(request_it);
+    if (it == orders_.end()) {
+        return;
+    }
+
+    if (response.contains("error")) {
+        reject(it->second, response["error"].value("message", std::string()));
+    } else if (response.contains("result") && response["result"].contains("order")) {
+        applyOrder(it->second, Order(response["result"]["order"]));
+    }
+}
+
+void ClientOrderTracker::onReject(const std::string& client_order_id, const std::string& reason) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(client_order_id);
+    if (it != orders_.end() && it->second.state == ClientOrderState::Pending) {
+        reject(it->second, reason);
+    }
+}
+
+void ClientOrderTracker::onOrder(const Order& order) {
+    if (order.getLabel().empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(clientOrderIdOf(order.getLabel()));
+    if (it != orders_.end()) {
+        applyOrder(it->second, order);
+    }
+}
+
+void ClientOrderTracker::onTrade(const nlohmann::json& trade) {
+    std::string label = trade.value("label", std::string());
+    if (label.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(clientOrderIdOf(label));
+    if (it == orders_.end() || it->second.state == ClientOrderState::Closed) {
+        return;
+    }
+    ClientOrder& tracked = it->second;
+
+    // A fill before the ack still tells us the order exists
+    if (tracked.order_id.empty() && trade.contains("order_id")) {
+        tracked.order_id = trade["order_id"].get<std::string>();
+        client_id_by_order_id_[tracked.order_id] = tracked.client_order_id;
+    }
+    if (tracked.state == ClientOrderState::Pending || tracked.state == ClientOrderState::Rejected) {
+        client_id_by_request_.erase(tracked.request_id);
+        tracked.state = ClientOrderState::Acked;
+    }
+}
+
+void ClientOrderTracker::applyOrder(ClientOrder& tracked, const Order& order) {
+    if (tracked.state == ClientOrderState::Closed) {
+        return;
+    }
+
+    if (tracked.order_id != order.getOrderId()) {
+        client_id_by_order_id_.erase(tracked.order_id);
+        tracked.order_id = order.getOrderId();
+        client_id_by_order_id_[tracked.order_id] = tracked.client_order_id;
+    }
+
+    // Fills are cumulative on orders; ignore an older update arriving late
+    tracked.filled_amount = std::max(tracked.filled_amount, order.getFilledAmount());
+    client_id_by_request_.erase(tracked.request_id);
+    tracked.state = ClientOrderState::Acked;
+
+    const std::string& order_state = order.getOrderState();
+    if (order_state != "open" && order_state != "untriggered") {
+        close(tracked);
+    }
+}
+
+void ClientOrderTracker::reject(ClientOrder& tracked, const std::string& reason) {
+    client_id_by_request_.erase(tracked.request_id);
+    tracked.state = ClientOrderState::Rejected;
+    tracked.reject_reason = reason;
+    closed_orders_.push_back(tracked.client_order_id);
+}
+
+void ClientOrderTracker::close(ClientOrder& tracked) {
+    tracked.state = ClientOrderState::Closed;
+    closed_orders_.push_back(tracked.client_order_id);
+
+    // Finished requests age out; anything re-sent since is kept
+    while (closed_orders_.size() > kMaxClosedOrders) {
+        std::string oldest = closed_orders_.front();
+        closed_orders_.pop_front();
+        auto it = orders_.find(oldest);
+        if (it == orders_.end() ||
+            (it->second.state != ClientOrderState::Closed &&
+             it->second.state != ClientOrderState::Rejected)) {
+            continue;
+        }
+        client_id_by_order_id_.erase(it->second.order_id);
+        orders_.erase(it);
+    }
+}
+
+} // namespace deribit
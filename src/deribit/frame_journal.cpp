@@ -0,0 +1,350 @@
+#include "deribit/frame_journal.hpp"
+#include "deribit/logger.hpp"
+#include "deribit/trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace deribit {
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'R', 'B', 'J', 'R', 'N', 'L', '1'};
+constexpr uint32_t kVersion = 1;
+
+// Ring records are 16-byte aligned so a padding header always fits before the wrap
+constexpr size_t kRingAlign = 16;
+constexpr size_t kFileAlign = 8;
+constexpr uint32_t kPaddingLength = std::numeric_limits<uint32_t>::max();
+
+// Writer poll interval while the ring is empty
+constexpr std::chrono::milliseconds kIdleWait(1);
+
+// Smallest file worth rolling over to
+constexpr uint64_t kMinFileSize = 64 * 1024;
+
+// How often the writer retries a file it failed to create
+constexpr std::chrono::seconds kReopenInterval(1);
+
+static_assert(sizeof(FrameRecordHeader) == 16, "FrameRecordHeader must stay 16 bytes");
+static_assert(sizeof(FrameJournalFileHeader) == 40, "FrameJournalFileHeader layout changed");
+
+constexpr size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+int64_t nowNs(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+int64_t nowNs(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+// A file created at its full size and mapped read-write; trimmed to what was written on close
+struct FrameJournal::MappedFile {
+    std::string name;
+    uint64_t size{0};
+    char* data{nullptr};
+#ifdef _WIN32
+    HANDLE file{INVALID_HANDLE_VALUE};
+    HANDLE mapping{nullptr};
+#else
+    int fd{-1};
+#endif
+
+    bool open(const std::string& file_name, uint64_t file_size) {
+        name = file_name;
+        size = file_size;
+#ifdef _WIN32
+        file = CreateFileA(name.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                     static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xffffffff), nullptr);
+        if (mapping == nullptr) {
+            close(0);
+            return false;
+        }
+        data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(size)));
+#else
+        fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(0);
+            return false;
+        }
+        void* mapped = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        data = mapped == MAP_FAILED ? nullptr : static_cast<char*>(mapped);
+#endif
+        if (data == nullptr) {
+            close(0);
+            return false;
+        }
+        return true;
+    }
+
+    void close(uint64_t used) {
+#ifdef _WIN32
+        if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            LARGE_INTEGER end;
+            end.QuadPart = static_cast<LONGLONG>(used);
+            SetFilePointerEx(file, end, nullptr, FILE_BEGIN);
+            SetEndOfFile(file);
+            CloseHandle(file);
+        }
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data != nullptr) {
+            ::munmap(data, static_cast<size_t>(size));
+        }
+        if (fd >= 0) {
+            if (::ftruncate(fd, static_cast<off_t>(used)) != 0) {
+                DERIBIT_LOG_WARN("Failed to trim frame journal {}", name);
+            }
+            ::close(fd);
+        }
+        fd = -1;
+#endif
+        data = nullptr;
+    }
+};
+
+FrameJournal::FrameJournal(const std::string& path, uint64_t file_size, size_t buffer_capacity)
+    : path_(path)
+    , file_size_(std::max(file_size, kMinFileSize)) {
+    size_t rounded = kRingAlign * 4;
+    while (rounded < buffer_capacity) {
+        rounded <<= 1;
+    }
+    // Value-initialized so every page is faulted in before the first frame
+    buffer_.reset(new char[rounded]());
+    capacity_ = rounded;
+    mask_ = rounded - 1;
+}
+
+FrameJournal::~FrameJournal() {
+    stop();
+}
+
+bool FrameJournal::start() {
+    if (running_) {
+        return true;
+    }
+
+    start_ms_ = nowNs(std::chrono::system_clock::now()) / 1000000;
+    file_index_ = 0;
+    if (!openFile()) {
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&FrameJournal::run, this);
+    DERIBIT_LOG_INFO("Recording WebSocket frames to {}.{}.*", path_, start_ms_);
+    return true;
+}
+
+void FrameJournal::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    drain();
+    closeFile();
+}
+
+bool FrameJournal::append(uint32_t connection_id, int64_t receive_ns, const char* data, size_t length) {
+    // A zero length ends a file, so empty frames are not recorded
+    if (length == 0) {
+        return true;
+    }
+    size_t record_size = alignUp(sizeof(FrameRecordHeader) + length, kRingAlign);
+    if (record_size > capacity_ / 2 || length >= kPaddingLength) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // A record never wraps; the space left before the end is skipped instead
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t offset = head & mask_;
+    size_t to_end = capacity_ - offset;
+    size_t needed = record_size <= to_end ? record_size : to_end + record_size;
+    if (head + needed - cached_tail_ > capacity_) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head + needed - cached_tail_ > capacity_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    if (record_size > to_end) {
+        FrameRecordHeader padding{kPaddingLength, 0, 0};
+        std::memcpy(buffer_.get() + offset, &padding, sizeof(padding));
+        offset = 0;
+    }
+    FrameRecordHeader header{static_cast<uint32_t>(length), connection_id, receive_ns};
+    std::memcpy(buffer_.get() + offset, &header, sizeof(header));
+    std::memcpy(buffer_.get() + offset + sizeof(header), data, length);
+    head_.store(head + needed, std::memory_order_release);
+    return true;
+}
+
+FrameJournalStats FrameJournal::getStats() const {
+    FrameJournalStats stats;
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.files = files_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool FrameJournal::read(const std::string& file,
+                        const std::function<void(const FrameRecordHeader&, const std::string&)>& callback) {
+    std::ifstream in(file, std::ios::binary);
+    FrameJournalFileHeader file_header{};
+    if (!in.read(reinterpret_cast<char*>(&file_header), sizeof(file_header)) ||
+        std::memcmp(file_header.magic, kMagic, sizeof(kMagic)) != 0 || file_header.version != kVersion) {
+        DERIBIT_LOG_ERROR("Not a frame journal: {}", file);
+        return false;
+    }
+    in.seekg(file_header.header_size);
+
+    std::string payload;
+    FrameRecordHeader header{};
+    while (in.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.length != 0) {
+        payload.resize(header.length);
+        size_t padded = alignUp(header.length, kFileAlign);
+        if (!in.read(&payload[0], header.length)) {
+            DERIBIT_LOG_ERROR("Truncated record in frame journal {}", file);
+            return false;
+        }
+        in.seekg(static_cast<std::streamoff>(padded - header.length), std::ios::cur);
+        callback(header, payload);
+    }
+    return true;
+}
+
+void FrameJournal::run() {
+    DERIBIT_TRACE_THREAD_NAME("frame_journal");
+    while (running_) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(kIdleWait);
+        }
+    }
+}
+
+size_t FrameJournal::drain() {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t drained = 0;
+
+    while (tail != head) {
+        size_t offset = tail & mask_;
+        FrameRecordHeader header;
+        std::memcpy(&header, buffer_.get() + offset, sizeof(header));
+        if (header.length == kPaddingLength) {
+            tail += capacity_ - offset;
+            continue;
+        }
+
+        // A record that cannot fit even an empty file is dropped without rolling over
+        uint64_t file_record = alignUp(sizeof(header) + header.length, kFileAlign);
+        uint64_t file_header_size = alignUp(sizeof(FrameJournalFileHeader), kFileAlign);
+        bool fits = file_header_size + file_record + sizeof(header) <= file_size_;
+
+        // Roll over when the record and an end marker no longer fit
+        if (fits && file_ && write_offset_ + file_record + sizeof(header) > file_size_) {
+            closeFile();
+            ++file_index_;
+            openFile();
+        }
+        if (fits && !file_ && std::chrono::steady_clock::now() >= next_open_attempt_) {
+            openFile();
+        }
+
+        if (!fits || !file_ || write_offset_ + file_record + sizeof(header) > file_size_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            // Payload before header so a reader of a crashed process never sees a half-written record
+            char* out = file_->data + write_offset_;
+            std::memcpy(out + sizeof(header), buffer_.get() + offset + sizeof(header), header.length);
+            std::memcpy(out, &header, sizeof(header));
+            write_offset_ += file_record;
+            frames_.fetch_add(1, std::memory_order_relaxed);
+            bytes_.fetch_add(header.length, std::memory_order_relaxed);
+        }
+
+        tail += alignUp(sizeof(header) + header.length, kRingAlign);
+        tail_.store(tail, std::memory_order_release);
+        ++drained;
+    }
+    return drained;
+}
+
+bool FrameJournal::openFile() {
+    std::string name = path_ + "." + std::to_string(start_ms_) + "." + std::to_string(file_index_);
+    auto file = std::make_unique<MappedFile>();
+    if (!file->open(name, file_size_)) {
+        DERIBIT_LOG_ERROR("Failed to create frame journal {}", name);
+        next_open_attempt_ = std::chrono::steady_clock::now() + kReopenInterval;
+        return false;
+    }
+
+    FrameJournalFileHeader file_header{};
+    std::memcpy(file_header.magic, kMagic, sizeof(kMagic));
+    file_header.version = kVersion;
+    file_header.header_size = static_cast<uint32_t>(alignUp(sizeof(file_header), kFileAlign));
+    file_header.wall_ns = nowNs(std::chrono::system_clock::now());
+    file_header.steady_ns = nowNs(std::chrono::steady_clock::now());
+    file_header.file_index = file_index_;
+    std::memcpy(file->data, &file_header, sizeof(file_header));
+
+    file_ = std::move(file);
+    write_offset_ = file_header.header_size;
+    files_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void FrameJournal::closeFile() {
+    if (!file_) {
+        return;
+    }
+    file_->close(write_offset_);
+    file_.reset();
+    write_offset_ = 0;
+}
+
+} // namespace deribit
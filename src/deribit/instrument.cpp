@@ -0,0 +1,157 @@
+#include "deribit/instrument.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace deribit {
+
+namespace {
+
+// Tolerance for floating point grid checks, relative to one step
+constexpr double kGridEpsilon = 1e-9;
+
+bool onGrid(double value, double step) {
+    if (step <= 0.0) {
+        return true;
+    }
+    double steps = value / step;
+    return std::fabs(steps - std::round(steps)) < kGridEpsilon * std::max(1.0, std::fabs(steps));
+}
+
+} // namespace
+
+Instrument::Instrument(const nlohmann::json& json) {
+    if (json.contains("instrument_name")) {
+        instrument_name_ = json["instrument_name"].get<std::string>();
+    }
+
+    if (json.contains("kind")) {
+        kind_ = json["kind"].get<std::string>();
+    }
+
+    if (json.contains("base_currency")) {
+        base_currency_ = json["base_currency"].get<std::string>();
+    }
+
+    if (json.contains("quote_currency")) {
+        quote_currency_ = json["quote_currency"].get<std::string>();
+    }
+
+    if (json.contains("settlement_currency") && json["settlement_currency"].is_string()) {
+        settlement_currency_ = json["settlement_currency"].get<std::string>();
+    }
+
+    if (json.contains("tick_size")) {
+        tick_size_ = json["tick_size"].get<double>();
+    }
+
+    if (json.contains("min_trade_amount")) {
+        min_trade_amount_ = json["min_trade_amount"].get<double>();
+    }
+
+    if (json.contains("contract_size")) {
+        contract_size_ = json["contract_size"].get<double>();
+    }
+
+    if (json.contains("strike") && json["strike"].is_number()) {
+        strike_ = json["strike"].get<double>();
+    }
+
+    if (json.contains("option_type") && json["option_type"].is_string()) {
+        option_type_ = json["option_type"].get<std::string>();
+    }
+
+    if (json.contains("expiration_timestamp")) {
+        expiration_timestamp_ = json["expiration_timestamp"].get<int64_t>();
+    }
+
+    if (json.contains("is_active")) {
+        is_active_ = json["is_active"].get<bool>();
+    }
+}
+
+std::string Instrument::settlementCurrencyOf(const std::string& instrument_name) {
+    size_t dash = instrument_name.find('-');
+    size_t underscore = instrument_name.find('_');
+    if (underscore != std::string::npos && underscore < dash) {
+        return instrument_name.substr(underscore + 1, dash == std::string::npos ? dash : dash - underscore - 1);
+    }
+    return instrument_name.substr(0, dash);
+}
+
+double Instrument::roundPrice(double price) const {
+    if (tick_size_ <= 0.0) {
+        return price;
+    }
+    return std::round(price / tick_size_) * tick_size_;
+}
+
+double Instrument::roundPriceDown(double price) const {
+    if (tick_size_ <= 0.0) {
+        return price;
+    }
+    return std::floor(price / tick_size_ + kGridEpsilon) * tick_size_;
+}
+
+double Instrument::roundPriceUp(double price) const {
+    if (tick_size_ <= 0.0) {
+        return price;
+    }
+    return std::ceil(price / tick_size_ - kGridEpsilon) * tick_size_;
+}
+
+double Instrument::roundAmount(double amount) const {
+    if (min_trade_amount_ <= 0.0) {
+        return amount;
+    }
+    return std::floor(amount / min_trade_amount_ + kGridEpsilon) * min_trade_amount_;
+}
+
+bool Instrument::isValidAmount(double amount) const {
+    if (amount <= 0.0) {
+        return false;
+    }
+    if (min_trade_amount_ > 0.0 && amount + kGridEpsilon < min_trade_amount_) {
+        return false;
+    }
+    return onGrid(amount, min_trade_amount_);
+}
+
+bool Instrument::isValidPrice(double price) const {
+    return price > 0.0 && onGrid(price, tick_size_);
+}
+
+nlohmann::json Instrument::toJson() const {
+    nlohmann::json json;
+    json["instrument_name"] = instrument_name_;
+    json["kind"] = kind_;
+    json["base_currency"] = base_currency_;
+    json["quote_currency"] = quote_currency_;
+    json["settlement_currency"] = settlement_currency_;
+    json["tick_size"] = tick_size_;
+    json["min_trade_amount"] = min_trade_amount_;
+    json["contract_size"] = contract_size_;
+    json["expiration_timestamp"] = expiration_timestamp_;
+    json["is_active"] = is_active_;
+    if (!option_type_.empty()) {
+        json["strike"] = strike_;
+        json["option_type"] = option_type_;
+    }
+    return json;
+}
+
+bool Instrument::operator==(const Instrument& other) const {
+    return instrument_name_ == other.instrument_name_
+        && kind_ == other.kind_
+        && base_currency_ == other.base_currency_
+        && quote_currency_ == other.quote_currency_
+        && settlement_currency_ == other.settlement_currency_
+        && tick_size_ == other.tick_size_
+        && min_trade_amount_ == other.min_trade_amount_
+        && contract_size_ == other.contract_size_
+        && strike_ == other.strike_
+        && option_type_ == other.option_type_
+        && expiration_timestamp_ == other.expiration_timestamp_
+        && is_active_ == other.is_active_;
+}
+
+} // namespace deribit
@@ -0,0 +1,170 @@
+#include "deribit/instrument_store.hpp"
+#include "deribit/logger.hpp"
+#include <fstream>
+#include <unordered_set>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+namespace deribit {
+
+InstrumentStore::InstrumentStore()
+    : instruments_(std::make_shared<const InstrumentMap>()) {
+}
+
+InstrumentStore::InstrumentPtr InstrumentStore::find(const std::string& instrument_name) const {
+    auto instruments = std::atomic_load(&instruments_);
+    auto it = instruments->find(instrument_name);
+    return it != instruments->end() ? it->second : nullptr;
+}
+
+std::string InstrumentStore::settlementCurrency(const std::string& instrument_name) const {
+    InstrumentPtr instrument = find(instrument_name);
+    if (instrument && !instrument->getSettlementCurrency().empty()) {
+        return instrument->getSettlementCurrency();
+    }
+    return Instrument::settlementCurrencyOf(instrument_name);
+}
+
+std::shared_ptr<const InstrumentStore::InstrumentMap> InstrumentStore::snapshot() const {
+    return std::atomic_load(&instruments_);
+}
+
+size_t InstrumentStore::size() const {
+    return std::atomic_load(&instruments_)->size();
+}
+
+size_t InstrumentStore::applyInstruments(const std::string& currency, const nlohmann::json& instruments) {
+    if (!instruments.is_array()) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    auto current = std::atomic_load(&instruments_);
+    auto next = std::make_shared<InstrumentMap>(*current);
+    size_t changes = 0;
+
+    std::unordered_set<std::string> seen;
+    for (const auto& instrument_json : instruments) {
+        auto instrument = std::make_shared<const Instrument>(instrument_json);
+        const std::string& name = instrument->getInstrumentName();
+        if (name.empty()) {
+            continue;
+        }
+        seen.insert(name);
+
+        auto it = next->find(name);
+        if (it != next->end() && *it->second == *instrument) {
+            continue;
+        }
+        (*next)[name] = std::move(instrument);
+        ++changes;
+    }
+
+    // Drop instruments of this currency that are no longer listed
+    auto& names = names_by_currency_[currency];
+    for (const auto& name : names) {
+        if (seen.count(name) == 0 && next->erase(name) > 0) {
+            ++changes;
+        }
+    }
+    names.assign(seen.begin(), seen.end());
+
+    if (changes > 0) {
+        std::atomic_store(&instruments_, std::shared_ptr<const InstrumentMap>(std::move(next)));
+    }
+    return changes;
+}
+
+bool InstrumentStore::loadSnapshot(const std::string& path, bool testnet) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    try {
+        nlohmann::json json = nlohmann::json::parse(file);
+        if (!json.contains("testnet") || json["testnet"].get<bool>() != testnet ||
+            !json.contains("currencies")) {
+            DERIBIT_LOG_WARN("Ignoring instrument snapshot from a different environment: {}", path);
+            return false;
+        }
+
+        auto next = std::make_shared<InstrumentMap>();
+        std::unordered_map<std::string, std::vector<std::string>> names_by_currency;
+        for (const auto& currency : json["currencies"].items()) {
+            auto& names = names_by_currency[currency.key()];
+            for (const auto& instrument_json : currency.value()) {
+                auto instrument = std::make_shared<const Instrument>(instrument_json);
+                if (!instrument->getInstrumentName().empty()) {
+                    names.push_back(instrument->getInstrumentName());
+                    (*next)[instrument->getInstrumentName()] = std::move(instrument);
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(update_mutex_);
+        names_by_currency_ = std::move(names_by_currency);
+        std::atomic_store(&instruments_, std::shared_ptr<const InstrumentMap>(std::move(next)));
+        return true;
+    } catch (const nlohmann::json::exception& e) {
+        DERIBIT_LOG_ERROR("Failed to read instrument snapshot {}: {}", path, e.what());
+        return false;
+    }
+}
+
+bool InstrumentStore::saveSnapshot(const std::string& path, bool testnet) {
+    nlohmann::json json;
+    json["testnet"] = testnet;
+    json["currencies"] = nlohmann::json::object();
+    {
+        std::lock_guard<std::mutex> lock(update_mutex_);
+        auto instruments = std::atomic_load(&instruments_);
+        for (const auto& currency : names_by_currency_) {
+            auto& currency_json = json["currencies"][currency.first];
+            currency_json = nlohmann::json::array();
+            for (const auto& name : currency.second) {
+                auto it = instruments->find(name);
+                if (it != instruments->end()) {
+                    currency_json.push_back(it->second->toJson());
+                }
+            }
+        }
+    }
+
+    // Write to a temporary file first so a crash never leaves a torn snapshot
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        if (!file.is_open()) {
+            DERIBIT_LOG_ERROR("Failed to write instrument snapshot {}", tmp_path);
+            return false;
+        }
+        file << json.dump();
+        if (!file.good()) {
+            return false;
+        }
+    }
+
+    // Replace in one step so the previous snapshot survives until the new one is in place
+#ifdef _WIN32
+    bool replaced = MoveFileExA(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool replaced = std::rename(tmp_path.c_str(), path.c_str()) == 0;
+#endif
+    if (!replaced) {
+        DERIBIT_LOG_ERROR("Failed to replace instrument snapshot {}", path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace deribit
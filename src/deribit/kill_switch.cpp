@@ -0,0 +1,107 @@
+#include "deribit/kill_switch.hpp"
+#include "deribit/logger.hpp"
+#include <chrono>
+
+namespace deribit {
+
+namespace {
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+KillSwitch::KillSwitch(const std::vector<std::string>& currencies, SendFunction send)
+    : send_(std::move(send))
+    , cancel_all_message_(encode("private/cancel_all", nlohmann::json::object())) {
+    for (const auto& currency : currencies) {
+        cancel_currency_messages_[currency] =
+            encode("private/cancel_all_by_currency", {{"currency", currency}});
+    }
+}
+
+bool KillSwitch::cancelAll() {
+    return fire(cancel_all_message_);
+}
+
+bool KillSwitch::cancelCurrency(const std::string& currency) {
+    auto it = cancel_currency_messages_.find(currency);
+    if (it != cancel_currency_messages_.end()) {
+        return fire(it->second);
+    }
+    return fire(encode("private/cancel_all_by_currency", {{"currency", currency}}));
+}
+
+bool KillSwitch::cancelInstrument(const std::string& instrument_name) {
+    return fire(encode("private/cancel_all_by_instrument", {{"instrument_name", instrument_name}}));
+}
+
+void KillSwitch::onResponse(const nlohmann::json& response) {
+    if (!response.contains("id") || !ownsRequest(response["id"].get<uint64_t>())) {
+        return;
+    }
+    int64_t sent_at = sent_at_ns_[response["id"].get<uint64_t>() - kFirstRequestId].exchange(0, std::memory_order_acq_rel);
+    uint64_t latency = sent_at > 0 ? static_cast<uint64_t>(nowNs() - sent_at) : 0;
+
+    if (response.contains("error")) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        DERIBIT_LOG_ERROR("Kill switch cancel failed: {}", response["error"].value("message", std::string()));
+        return;
+    }
+
+    acks_.fetch_add(1, std::memory_order_relaxed);
+    if (response.contains("result") && response["result"].is_number()) {
+        last_cancelled_.store(response["result"].get<uint64_t>(), std::memory_order_relaxed);
+    }
+    // A repeated id has no send time left to measure from
+    if (sent_at > 0) {
+        last_latency_ns_.store(latency, std::memory_order_relaxed);
+        uint64_t max_latency = max_latency_ns_.load(std::memory_order_relaxed);
+        while (latency > max_latency &&
+               !max_latency_ns_.compare_exchange_weak(max_latency, latency, std::memory_order_relaxed)) {
+        }
+    }
+
+    DERIBIT_LOG_INFO("Kill switch cancelled {} orders in {}us",
+        last_cancelled_.load(std::memory_order_relaxed), latency / 1000);
+}
+
+KillSwitchStats KillSwitch::getStats() const {
+    KillSwitchStats stats;
+    stats.triggers = triggers_.load(std::memory_order_relaxed);
+    stats.acks = acks_.load(std::memory_order_relaxed);
+    stats.errors = errors_.load(std::memory_order_relaxed);
+    stats.last_cancelled = last_cancelled_.load(std::memory_order_relaxed);
+    stats.last_latency_ns = last_latency_ns_.load(std::memory_order_relaxed);
+    stats.max_latency_ns = max_latency_ns_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::string KillSwitch::encode(const std::string& method, const nlohmann::json& params) {
+    nlohmann::json request = {
+        {"jsonrpc", "2.0"},
+        {"method", method},
+        {"params", params}
+    };
+    // Drop the opening brace; fire() prepends it with the id
+    return request.dump().substr(1);
+}
+
+bool KillSwitch::fire(const std::string& encoded) {
+    triggers_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t slot = next_request_.fetch_add(1, std::memory_order_relaxed) % kRequestIds;
+    std::string message = "{\"id\":" + std::to_string(kFirstRequestId + slot) + "," + encoded;
+    sent_at_ns_[slot].store(nowNs(), std::memory_order_release);
+
+    if (!send_(message)) {
+        sent_at_ns_[slot].store(0, std::memory_order_relaxed);
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        DERIBIT_LOG_ERROR("Kill switch failed to send cancel request");
+        return false;
+    }
+    return true;
+}
+
+} // namespace deribit
@@ -0,0 +1,169 @@
+#include "deribit/latency_histogram.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace deribit {
+
+namespace {
+
+unsigned highestBit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+std::atomic<uint64_t> next_recorder_id{1};
+
+} // namespace
+
+const char* toString(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::ExchangeToReceive: return "exchange_to_receive";
+        case LatencyStage::Parse: return "parse";
+        case LatencyStage::BookApply: return "book_apply";
+        case LatencyStage::CallbackEntry: return "callback_entry";
+        case LatencyStage::CallbackDuration: return "callback_duration";
+        case LatencyStage::Count: break;
+    }
+    return "unknown";
+}
+
+void LatencySnapshot::merge(const LatencySnapshot& other) {
+    if (buckets_.size() < other.buckets_.size()) {
+        buckets_.resize(other.buckets_.size(), 0);
+    }
+    for (size_t i = 0; i < other.buckets_.size(); ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+}
+
+uint64_t LatencySnapshot::percentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    // Rank of the sample at the percentile, 1-based
+    double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    uint64_t rank = std::max<uint64_t>(
+        static_cast<uint64_t>(clamped / 100.0 * static_cast<double>(count_) + 0.5), 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::min(LatencyHistogram::highestValueOf(i), max_);
+        }
+    }
+    return max_;
+}
+
+std::string LatencySnapshot::summary() const {
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer),
+                  "count=%llu p50=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus",
+                  static_cast<unsigned long long>(count_),
+                  static_cast<double>(percentile(50.0)) / 1000.0,
+                  static_cast<double>(percentile(99.0)) / 1000.0,
+                  static_cast<double>(percentile(99.9)) / 1000.0,
+                  static_cast<double>(max_) / 1000.0);
+    return buffer;
+}
+
+void LatencyHistogram::mergeInto(LatencySnapshot& snapshot) const {
+    if (snapshot.buckets_.size() < kBucketCount) {
+        snapshot.buckets_.resize(kBucketCount, 0);
+    }
+
+    // Count is rebuilt from the buckets so percentiles stay self-consistent
+    uint64_t count = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t bucket = buckets_[i].load(std::memory_order_relaxed);
+        snapshot.buckets_[i] += bucket;
+        count += bucket;
+    }
+    snapshot.count_ += count;
+    snapshot.sum_ += sum_.load(std::memory_order_relaxed);
+    snapshot.max_ = std::max(snapshot.max_, max_.load(std::memory_order_relaxed));
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+    constexpr uint64_t kMaxValue = (uint64_t(1) << kMaxValueBits) - 1;
+
+    value = std::min(value, kMaxValue);
+    if (value < 2 * kSubBuckets) {
+        return static_cast<size_t>(value);
+    }
+
+    unsigned shift = highestBit(value) - kSubBucketBits;
+    return static_cast<size_t>(shift * kSubBuckets + (value >> shift));
+}
+
+uint64_t LatencyHistogram::highestValueOf(size_t bucket) {
+    constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    if (bucket < 2 * kSubBuckets) {
+        return bucket;
+    }
+
+    size_t shift = bucket / kSubBuckets - 1;
+    uint64_t mantissa = bucket % kSubBuckets + kSubBuckets;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+LatencyRecorder::LatencyRecorder(size_t series)
+    : series_(series)
+    , id_(next_recorder_id.fetch_add(1, std::memory_order_relaxed)) {
+}
+
+void LatencyRecorder::record(size_t series, uint64_t nanoseconds) {
+    if (series < series_) {
+        (*local()[series]).record(nanoseconds);
+    }
+}
+
+LatencySnapshot LatencyRecorder::snapshot(size_t series) const {
+    LatencySnapshot snapshot;
+    if (series >= series_) {
+        return snapshot;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& thread : threads_) {
+        (*thread)[series]->mergeInto(snapshot);
+    }
+    return snapshot;
+}
+
+LatencyRecorder::ThreadHistograms& LatencyRecorder::local() {
+    // Recorder ids are never reused, so entries of destroyed recorders are never matched
+    thread_local std::vector<std::pair<uint64_t, ThreadHistograms*>> cache;
+    for (const auto& entry : cache) {
+        if (entry.first == id_) {
+            return *entry.second;
+        }
+    }
+
+    auto histograms = std::make_unique<ThreadHistograms>();
+    histograms->reserve(series_);
+    for (size_t i = 0; i < series_; ++i) {
+        histograms->push_back(std::make_unique<LatencyHistogram>());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.push_back(std::move(histograms));
+    cache.emplace_back(id_, threads_.back().get());
+    return *threads_.back();
+}
+
+} // namespace deribit
@@ -0,0 +1,251 @@
+#include "deribit/logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+namespace deribit {
+
+namespace {
+
+// Most records taken from one ring per pass, so a busy thread cannot starve the others
+constexpr size_t kMaxDrainPerRing = 1024;
+
+// Idle polling backs off up to this long; flush() wakes the thread early
+constexpr std::chrono::milliseconds kMaxIdleWait{10};
+
+void appendTimestamp(std::string& out, int64_t timestamp_ns) {
+    std::time_t seconds = static_cast<std::time_t>(timestamp_ns / 1000000000);
+    std::tm utc{};
+#if defined(_WIN32)
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+    char buffer[40];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%06dZ",
+                  static_cast<int>(timestamp_ns % 1000000000 / 1000));
+    out += buffer;
+}
+
+void appendArg(std::string& out, const LogRecord& record, size_t index) {
+    const LogRecord::Value& value = record.values[index];
+    char buffer[32];
+    switch (record.types[index]) {
+        case LogArgType::Bool:
+            out += value.b ? "true" : "false";
+            return;
+        case LogArgType::Int:
+            std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value.i));
+            break;
+        case LogArgType::UInt:
+            std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value.u));
+            break;
+        case LogArgType::Double:
+            std::snprintf(buffer, sizeof(buffer), "%.10g", value.d);
+            break;
+        case LogArgType::Text:
+        case LogArgType::TruncatedText:
+            out.append(record.text + value.text.offset, value.text.length);
+            if (record.types[index] == LogArgType::TruncatedText) {
+                out += "...";
+            }
+            return;
+    }
+    out += buffer;
+}
+
+void format(std::string& out, const LogRecord& record) {
+    appendTimestamp(out, record.timestamp_ns);
+    out += ' ';
+    out += toString(record.level);
+    out += ' ';
+
+    size_t arg = 0;
+    for (const char* c = record.format; *c != '\0'; ++c) {
+        if (c[0] == '{' && c[1] == '}' && arg < record.arg_count) {
+            appendArg(out, record, arg++);
+            ++c;
+        } else {
+            out += *c;
+        }
+    }
+    if (record.suppressed > 0) {
+        out += " (" + std::to_string(record.suppressed) + " similar messages suppressed)";
+    }
+    out += '\n';
+}
+
+} // namespace
+
+const char* toString(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Off: return "OFF";
+    }
+    return "UNKNOWN";
+}
+
+LogRing::LogRing(size_t capacity) {
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    records_ = std::make_unique<LogRecord[]>(rounded);
+    mask_ = rounded - 1;
+}
+
+size_t LogRing::drain(std::vector<LogRecord>& out, size_t max) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t available = std::min(head_.load(std::memory_order_acquire) - tail, max);
+    for (size_t i = 0; i < available; ++i) {
+        out.push_back(records_[(tail + i) & mask_]);
+    }
+    tail_.store(tail + available, std::memory_order_release);
+    return available;
+}
+
+Logger& Logger::instance() {
+    // Never destroyed: threads may still log during static destruction
+    static Logger* logger = [] {
+        Logger* created = new Logger();
+        std::atexit([] { Logger::instance().stop(); });
+        return created;
+    }();
+    return *logger;
+}
+
+Logger::Logger() {
+    running_ = true;
+    thread_ = std::thread(&Logger::run, this);
+}
+
+void Logger::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_) {
+        return;
+    }
+    uint64_t ticket = ++flush_requested_;
+    cv_.notify_all();
+    cv_.wait(lock, [this, ticket]() { return flush_completed_ >= ticket || !running_; });
+}
+
+void Logger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+LogRing* Logger::addRing() {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings_.push_back(std::make_unique<LogRing>(kRingCapacity));
+    return rings_.back().get();
+}
+
+bool Logger::admit(LogSite& site, int64_t now_ns, uint64_t& suppressed) {
+    uint32_t limit = rate_limit_.load(std::memory_order_relaxed);
+    if (limit == 0) {
+        return true;
+    }
+
+    // Racing threads may both reset the window; that only admits a few extra records
+    int64_t second = now_ns / 1000000000;
+    if (site.window.load(std::memory_order_relaxed) != second) {
+        site.window.store(second, std::memory_order_relaxed);
+        site.count.store(0, std::memory_order_relaxed);
+    }
+    if (site.count.fetch_add(1, std::memory_order_relaxed) >= limit) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (site.suppressed.load(std::memory_order_relaxed) > 0) {
+        suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool Logger::drainOnce() {
+    batch_.clear();
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        for (const auto& ring : rings_) {
+            ring->drain(batch_, kMaxDrainPerRing);
+        }
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (batch_.empty() && dropped == reported_dropped_) {
+        return false;
+    }
+
+    // Rings are each in order; merge them so output follows wall-clock order
+    std::stable_sort(batch_.begin(), batch_.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+
+    out_.clear();
+    err_.clear();
+    for (const auto& record : batch_) {
+        format(record.level >= LogLevel::Warn ? err_ : out_, record);
+    }
+    if (dropped != reported_dropped_) {
+        err_ += "Logger dropped " + std::to_string(dropped - reported_dropped_) + " records: ring full\n";
+        reported_dropped_ = dropped;
+    }
+
+    if (!out_.empty()) {
+        std::fwrite(out_.data(), 1, out_.size(), stdout);
+        std::fflush(stdout);
+    }
+    if (!err_.empty()) {
+        std::fwrite(err_.data(), 1, err_.size(), stderr);
+        std::fflush(stderr);
+    }
+    return true;
+}
+
+void Logger::run() {
+    auto idle_wait = std::chrono::microseconds(100);
+    while (true) {
+        uint64_t requested;
+        bool running;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            requested = flush_requested_;
+            running = running_;
+        }
+
+        // Drain until empty so a flush or stop sees everything logged before it
+        bool wrote = false;
+        while (drainOnce()) {
+            wrote = true;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        flush_completed_ = requested;
+        cv_.notify_all();
+        if (!running) {
+            return;
+        }
+
+        idle_wait = wrote ? std::chrono::microseconds(100)
+                          : std::min<std::chrono::microseconds>(idle_wait * 2, kMaxIdleWait);
+        cv_.wait_for(lock, idle_wait, [this, requested]() {
+            return flush_requested_ != requested || !running_;
+        });
+    }
+}
+
+} // namespace deribit
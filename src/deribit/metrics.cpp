@@ -0,0 +1,210 @@
+#include "deribit/metrics.hpp"
+#include "deribit/logger.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace deribit {
+
+namespace {
+
+const char* typeName(MetricsRegistry::Type type) {
+    switch (type) {
+        case MetricsRegistry::Type::Counter: return "counter";
+        case MetricsRegistry::Type::Gauge: return "gauge";
+        case MetricsRegistry::Type::Histogram: return "histogram";
+    }
+    return "untyped";
+}
+
+std::string escape(const std::string& text, bool quotes) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '\\') {
+            escaped += "\\\\";
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else if (c == '"' && quotes) {
+            escaped += "\\\"";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string formatValue(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    // Shortest form that reads back exactly, so bounds print as 0.1 and not 0.10000000000000001
+    char buffer[32];
+    for (int precision = 6; precision <= 17; ++precision) {
+        std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        if (std::strtod(buffer, nullptr) == value) {
+            break;
+        }
+    }
+    return buffer;
+}
+
+// Joins a rendered label set with one extra label, e.g. le="0.5"
+std::string withLabel(const std::string& labels, const std::string& extra) {
+    return "{" + labels + (labels.empty() ? "" : ",") + extra + "}";
+}
+
+std::string braced(const std::string& labels) {
+    return labels.empty() ? std::string() : "{" + labels + "}";
+}
+
+} // namespace
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds))
+    , counts_(new std::atomic<uint64_t>[bounds_.size() + 1]) {
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value) {
+    // Bounds lists are short; a linear scan beats a binary search here
+    size_t bucket = 0;
+    while (bucket < bounds_.size() && value > bounds_[bucket]) {
+        ++bucket;
+    }
+    counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    double sum = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& entry = series(name, help, Type::Counter, labels);
+    if (!entry.counter) {
+        entry.counter = std::make_unique<Counter>();
+    }
+    return *entry.counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& entry = series(name, help, Type::Gauge, labels);
+    if (!entry.gauge) {
+        entry.gauge = std::make_unique<Gauge>();
+    }
+    return *entry.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(
+    const std::string& name,
+    const std::string& help,
+    const std::vector<double>& bounds,
+    const MetricLabels& labels) {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& entry = series(name, help, Type::Histogram, labels);
+    if (!entry.histogram) {
+        entry.histogram = std::make_unique<Histogram>(bounds);
+    }
+    return *entry.histogram;
+}
+
+void MetricsRegistry::callback(
+    const std::string& name,
+    const std::string& help,
+    Type type,
+    std::function<double()> read,
+    const MetricLabels& labels) {
+
+    if (type == Type::Histogram) {
+        DERIBIT_LOG_ERROR("Histogram metrics cannot be callbacks: {}", name);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    series(name, help, type, labels).read = std::move(read);
+}
+
+std::string MetricsRegistry::render() const {
+    std::string out;
+    out.reserve(4096);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& family : families_) {
+        out += "# HELP " + family->name + " " + escape(family->help, false) + "\n";
+        out += "# TYPE " + family->name + " " + typeName(family->type) + "\n";
+
+        for (const auto& entry : family->series) {
+            if (entry->histogram) {
+                const Histogram& histogram = *entry->histogram;
+                const auto& bounds = histogram.bounds();
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i <= bounds.size(); ++i) {
+                    cumulative += histogram.bucketCount(i);
+                    std::string le = i < bounds.size() ? formatValue(bounds[i]) : "+Inf";
+                    out += family->name + "_bucket" + withLabel(entry->labels, "le=\"" + le + "\"") + " "
+                        + std::to_string(cumulative) + "\n";
+                }
+                out += family->name + "_sum" + braced(entry->labels) + " " + formatValue(histogram.sum()) + "\n";
+                out += family->name + "_count" + braced(entry->labels) + " " + std::to_string(cumulative) + "\n";
+            } else if (entry->counter) {
+                out += family->name + braced(entry->labels) + " " + std::to_string(entry->counter->value()) + "\n";
+            } else if (entry->gauge) {
+                out += family->name + braced(entry->labels) + " " + formatValue(entry->gauge->value()) + "\n";
+            } else if (entry->read) {
+                out += family->name + braced(entry->labels) + " " + formatValue(entry->read()) + "\n";
+            }
+        }
+    }
+    return out;
+}
+
+MetricsRegistry::Series& MetricsRegistry::series(
+    const std::string& name,
+    const std::string& help,
+    Type type,
+    const MetricLabels& labels) {
+
+    Family* family;
+    auto it = families_by_name_.find(name);
+    if (it != families_by_name_.end()) {
+        family = it->second;
+        if (family->type != type) {
+            DERIBIT_LOG_ERROR("Metric {} re-registered as {}, already a {}",
+                name, typeName(type), typeName(family->type));
+        }
+    } else {
+        families_.push_back(std::make_unique<Family>(Family{name, help, type, {}}));
+        family = families_.back().get();
+        families_by_name_[name] = family;
+    }
+
+    std::string rendered = renderLabels(labels);
+    for (const auto& entry : family->series) {
+        if (entry->labels == rendered) {
+            return *entry;
+        }
+    }
+    family->series.push_back(std::make_unique<Series>());
+    family->series.back()->labels = std::move(rendered);
+    return *family->series.back();
+}
+
+std::string MetricsRegistry::renderLabels(const MetricLabels& labels) {
+    std::string rendered;
+    for (const auto& label : labels) {
+        if (!rendered.empty()) {
+            rendered += ",";
+        }
+        rendered += label.first + "=\"" + escape(label.second, true) + "\"";
+    }
+    return rendered;
+}
+
+} // namespace deribit
@@ -0,0 +1,142 @@
+#include "deribit/metrics_server.hpp"
+#include "deribit/logger.hpp"
+#include <chrono>
+
+namespace deribit {
+
+namespace {
+
+// Scrape requests are a request line and a few headers
+constexpr size_t kMaxRequestSize = 8192;
+
+// A client that has not sent its request headers by then is disconnected
+constexpr std::chrono::seconds kReadTimeout(5);
+
+std::string httpResponse(const std::string& status, const std::string& content_type, const std::string& body) {
+    return "HTTP/1.1 " + status + "\r\n"
+           "Content-Type: " + content_type + "\r\n"
+           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+           "Connection: close\r\n"
+           "\r\n" + body;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(const MetricsRegistry& registry, uint16_t port)
+    : registry_(registry)
+    , port_(port)
+    , acceptor_(io_context_) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    if (running_) {
+        return true;
+    }
+
+    try {
+        asio::ip::tcp::endpoint endpoint(asio::ip::make_address("127.0.0.1"), port_);
+        acceptor_.open(endpoint.protocol());
+        acceptor_.set_option(asio::ip::tcp::acceptor::reuse_address(true));
+        acceptor_.bind(endpoint);
+        acceptor_.listen();
+    } catch (const std::exception& e) {
+        DERIBIT_LOG_ERROR("Error starting metrics listener on port {}: {}", port_, e.what());
+        acceptor_.close();
+        return false;
+    }
+
+    accept();
+    io_context_.restart();
+    thread_ = std::thread([this]() { io_context_.run(); });
+    running_ = true;
+    DERIBIT_LOG_INFO("Serving metrics on http://127.0.0.1:{}/metrics", port_);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_) {
+        return;
+    }
+
+    // Stopping the context abandons open connections; their sockets close with the handlers
+    io_context_.stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    asio::error_code ec;
+    acceptor_.close(ec);
+    running_ = false;
+}
+
+void MetricsServer::accept() {
+    acceptor_.async_accept([this](const asio::error_code& ec, asio::ip::tcp::socket socket) {
+        if (ec) {
+            if (ec != asio::error::operation_aborted) {
+                DERIBIT_LOG_ERROR("Error accepting metrics connection: {}", ec.message());
+            }
+            return;
+        }
+
+        struct Connection {
+            explicit Connection(asio::ip::tcp::socket s)
+                : socket(std::move(s)), timer(socket.get_executor()), buffer(kMaxRequestSize) {}
+            asio::ip::tcp::socket socket;
+            asio::steady_timer timer;
+            asio::streambuf buffer;
+            std::string response;
+        };
+        auto connection = std::make_shared<Connection>(std::move(socket));
+
+        // A stalled client would otherwise hold its socket until the server stops
+        connection->timer.expires_after(kReadTimeout);
+        connection->timer.async_wait([connection](const asio::error_code& timer_ec) {
+            if (!timer_ec) {
+                asio::error_code ignored;
+                connection->socket.close(ignored);
+            }
+        });
+
+        asio::async_read_until(connection->socket, connection->buffer, "\r\n\r\n",
+            [this, connection](const asio::error_code& read_ec, size_t bytes) {
+                connection->timer.cancel();
+                if (read_ec) {
+                    return;
+                }
+                std::string request(asio::buffers_begin(connection->buffer.data()),
+                                    asio::buffers_begin(connection->buffer.data()) + bytes);
+                connection->response = handle(request);
+                asio::async_write(connection->socket, asio::buffer(connection->response),
+                    [connection](const asio::error_code&, size_t) {
+                        asio::error_code ignored;
+                        connection->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+                    });
+            });
+
+        accept();
+    });
+}
+
+std::string MetricsServer::handle(const std::string& request) const {
+    // Request line: METHOD SP PATH SP VERSION
+    size_t method_end = request.find(' ');
+    size_t path_end = method_end == std::string::npos ? std::string::npos : request.find(' ', method_end + 1);
+    if (path_end == std::string::npos) {
+        return httpResponse("400 Bad Request", "text/plain", "Bad Request\n");
+    }
+
+    std::string method = request.substr(0, method_end);
+    std::string path = request.substr(method_end + 1, path_end - method_end - 1);
+    if (method != "GET") {
+        return httpResponse("405 Method Not Allowed", "text/plain", "Method Not Allowed\n");
+    }
+    if (path != "/metrics" && path.rfind("/metrics?", 0) != 0) {
+        return httpResponse("404 Not Found", "text/plain", "Not Found\n");
+    }
+    return httpResponse("200 OK", "text/plain; version=0.0.4; charset=utf-8", registry_.render());
+}
+
+} // namespace deribit
@@ -0,0 +1,222 @@
+#include "deribit/options_engine.hpp"
+#include "deribit/options_kernels.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace deribit {
+
+namespace {
+
+inline double yearsToExpiry(double expiry_ms, double now_ms) {
+    return std::max((expiry_ms - now_ms) / kMsPerYear, kMinYears);
+}
+
+} // namespace
+
+bool OptionsEngine::addOption(const Instrument& instrument) {
+    if (!instrument.isOption() || instrument.getStrike() <= 0.0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (slots_.find(instrument.getInstrumentName()) != slots_.end()) {
+        return false;
+    }
+
+    Chain* chain = findChain(instrument.getBaseCurrency());
+    if (!chain) {
+        chains_.emplace_back();
+        chain = &chains_.back();
+        chain->currency = instrument.getBaseCurrency();
+    }
+
+    chain->strike.push_back(instrument.getStrike());
+    chain->expiry_ms.push_back(static_cast<double>(instrument.getExpirationTimestamp()));
+    chain->is_call.push_back(instrument.getOptionType() == "call" ? 1.0 : 0.0);
+    chain->price.push_back(0.0);
+    chain->basis.push_back(0.0);
+    chain->forward.push_back(0.0);
+    chain->vol.push_back(0.0);
+    chain->delta.push_back(0.0);
+    chain->gamma.push_back(0.0);
+    chain->vega.push_back(0.0);
+    chain->theta.push_back(0.0);
+    chain->queued.push_back(0);
+
+    slots_[instrument.getInstrumentName()] = Slot{
+        static_cast<uint32_t>(chain - chains_.data()),
+        static_cast<uint32_t>(chain->strike.size() - 1)};
+    ++options_;
+    return true;
+}
+
+bool OptionsEngine::updateOptionPrice(const std::string& instrument_name, double price, double underlying_price) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(instrument_name);
+    if (it == slots_.end()) {
+        return false;
+    }
+
+    Chain& chain = chains_[it->second.chain];
+    uint32_t i = it->second.index;
+    chain.price[i] = price;
+    if (underlying_price > 0.0) {
+        chain.forward[i] = underlying_price;
+        chain.basis[i] = chain.index_price > 0.0 ? underlying_price / chain.index_price : 0.0;
+    } else if (chain.forward[i] <= 0.0 && chain.index_price > 0.0) {
+        chain.forward[i] = chain.index_price;
+        chain.basis[i] = 1.0;
+    }
+
+    if (!chain.queued[i]) {
+        chain.queued[i] = 1;
+        chain.pending.push_back(i);
+    }
+    return true;
+}
+
+size_t OptionsEngine::recompute(int64_t timestamp) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    double now_ms = static_cast<double>(timestamp);
+    size_t solved = 0;
+
+    for (auto& chain : chains_) {
+        if (chain.pending.empty()) {
+            continue;
+        }
+
+        // Gather queued options into contiguous inputs; those without a forward wait for the index
+        batch_forward_.clear();
+        batch_strike_.clear();
+        batch_expiry_ms_.clear();
+        batch_years_.clear();
+        batch_is_call_.clear();
+        batch_premium_.clear();
+        batch_slots_.clear();
+        size_t kept = 0;
+        for (uint32_t i : chain.pending) {
+            if (chain.forward[i] <= 0.0) {
+                chain.pending[kept++] = i;
+                continue;
+            }
+            chain.queued[i] = 0;
+            batch_slots_.push_back(i);
+            batch_forward_.push_back(chain.forward[i]);
+            batch_strike_.push_back(chain.strike[i]);
+            batch_expiry_ms_.push_back(chain.expiry_ms[i]);
+            batch_years_.push_back(yearsToExpiry(chain.expiry_ms[i], now_ms));
+            batch_is_call_.push_back(chain.is_call[i]);
+            batch_premium_.push_back(chain.price[i] * chain.forward[i]);
+        }
+
+        size_t n = batch_forward_.size();
+        for (auto* column : {&batch_log_fk_, &batch_lo_, &batch_hi_, &batch_vol_,
+                             &batch_delta_, &batch_gamma_, &batch_vega_, &batch_theta_}) {
+            column->resize(n);
+        }
+        impliedVolKernel(n, batch_forward_.data(), batch_strike_.data(), batch_years_.data(),
+                         batch_is_call_.data(), batch_premium_.data(), batch_log_fk_.data(),
+                         batch_lo_.data(), batch_hi_.data(), batch_vol_.data());
+        greeksKernel(n, now_ms, batch_strike_.data(), batch_expiry_ms_.data(), batch_is_call_.data(),
+                     batch_forward_.data(), batch_vol_.data(), batch_delta_.data(), batch_gamma_.data(),
+                     batch_vega_.data(), batch_theta_.data());
+
+        // Scatter results back to the solved options only
+        for (size_t b = 0; b < n; ++b) {
+            uint32_t i = batch_slots_[b];
+            chain.vol[i] = batch_vol_[b];
+            chain.delta[i] = batch_delta_[b];
+            chain.gamma[i] = batch_gamma_[b];
+            chain.vega[i] = batch_vega_[b];
+            chain.theta[i] = batch_theta_[b];
+        }
+        chain.pending.resize(kept);
+        solved += n;
+    }
+
+    iv_solves_ += solved;
+    greeks_updates_ += solved;
+    return solved;
+}
+
+size_t OptionsEngine::updateIndex(const std::string& currency, double index_price, int64_t timestamp) {
+    if (index_price <= 0.0) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Chain* chain = findChain(currency);
+    if (!chain) {
+        return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    chain->index_price = index_price;
+    size_t n = chain->strike.size();
+    double* forward = chain->forward.data();
+    double* basis = chain->basis.data();
+
+    // Options first quoted before any index keep their forward and learn their basis here
+    for (size_t i = 0; i < n; ++i) {
+        double learned = forward[i] > 0.0 ? forward[i] / index_price : 1.0;
+        basis[i] = basis[i] > 0.0 ? basis[i] : learned;
+        forward[i] = index_price * basis[i];
+    }
+
+    greeksKernel(n, static_cast<double>(timestamp), chain->strike.data(), chain->expiry_ms.data(),
+                 chain->is_call.data(), forward, chain->vol.data(), chain->delta.data(),
+                 chain->gamma.data(), chain->vega.data(), chain->theta.data());
+
+    greeks_updates_ += n;
+    last_batch_size_ = n;
+    last_batch_ns_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    return n;
+}
+
+bool OptionsEngine::getGreeks(const std::string& instrument_name, OptionGreeks& greeks) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(instrument_name);
+    if (it == slots_.end()) {
+        return false;
+    }
+
+    const Chain& chain = chains_[it->second.chain];
+    uint32_t i = it->second.index;
+    if (chain.vol[i] <= 0.0) {
+        return false;
+    }
+
+    greeks.implied_vol = chain.vol[i];
+    greeks.forward = chain.forward[i];
+    greeks.delta = chain.delta[i];
+    greeks.gamma = chain.gamma[i];
+    greeks.vega = chain.vega[i];
+    greeks.theta = chain.theta[i];
+    return true;
+}
+
+OptionsEngineStats OptionsEngine::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    OptionsEngineStats stats;
+    stats.options = options_;
+    stats.iv_solves = iv_solves_;
+    stats.greeks_updates = greeks_updates_;
+    stats.last_batch_size = last_batch_size_;
+    stats.last_batch_ns = last_batch_ns_;
+    stats.options_per_second = last_batch_ns_ > 0
+        ? static_cast<double>(last_batch_size_) * 1e9 / static_cast<double>(last_batch_ns_) : 0.0;
+    return stats;
+}
+
+OptionsEngine::Chain* OptionsEngine::findChain(const std::string& currency) {
+    for (auto& chain : chains_) {
+        if (chain.currency == currency) {
+            return &chain;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace deribit
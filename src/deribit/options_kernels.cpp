@@ -0,0 +1,131 @@
+#include "deribit/options_kernels.hpp"
+#include <cmath>
+
+// Built with fast-math where the toolchain supports it, so the erfc, exp and
+// log calls below can go to vector math routines. Nothing else belongs here.
+
+namespace deribit {
+
+namespace {
+
+constexpr double kMinVol = 0.01;
+constexpr double kMaxVol = 10.0;
+constexpr int kNewtonIterations = 20;
+constexpr double kInvSqrt2 = 0.70710678118654752440;
+constexpr double kInvSqrt2Pi = 0.39894228040143267794;
+constexpr double kSqrt2Pi = 2.50662827463100050242;
+
+// Local rather than std:: so no inline library code is compiled with these flags
+inline double maxOf(double a, double b) {
+    return a < b ? b : a;
+}
+
+inline double minOf(double a, double b) {
+    return b < a ? b : a;
+}
+
+inline double normCdf(double x) {
+    return 0.5 * std::erfc(-x * kInvSqrt2);
+}
+
+inline double normPdf(double x) {
+    return kInvSqrt2Pi * std::exp(-0.5 * x * x);
+}
+
+inline double yearsToExpiry(double expiry_ms, double now_ms) {
+    return maxOf((expiry_ms - now_ms) / kMsPerYear, kMinYears);
+}
+
+} // namespace
+
+void greeksKernel(
+    size_t n,
+    double now_ms,
+    const double* __restrict strike,
+    const double* __restrict expiry_ms,
+    const double* __restrict is_call,
+    const double* __restrict forward,
+    const double* __restrict vol,
+    double* __restrict delta,
+    double* __restrict gamma,
+    double* __restrict vega,
+    double* __restrict theta) {
+
+    for (size_t i = 0; i < n; ++i) {
+        double years = yearsToExpiry(expiry_ms[i], now_ms);
+        double sqrt_t = std::sqrt(years);
+        double sigma = maxOf(vol[i], kMinVol);
+        double f = maxOf(forward[i], 1e-12);
+        double sigma_t = sigma * sqrt_t;
+        double d1 = (std::log(f / strike[i]) + 0.5 * sigma_t * sigma_t) / sigma_t;
+        double pdf = normPdf(d1);
+
+        delta[i] = normCdf(d1) - (1.0 - is_call[i]);
+        gamma[i] = pdf / (f * sigma_t);
+        vega[i] = f * pdf * sqrt_t * 0.01;
+        theta[i] = -f * pdf * sigma / (2.0 * sqrt_t) / 365.0;
+    }
+}
+
+// Safeguarded Newton on the Black-76 price of the out-of-the-money side, which
+// carries the whole time value. Steps leaving the bracket fall back to
+// bisection. The iteration loop is outermost so every pass is one straight-line
+// loop across the batch, with each option's iterate kept in vol.
+void impliedVolKernel(
+    size_t n,
+    const double* __restrict forward,
+    const double* __restrict strike,
+    double* __restrict years,
+    const double* __restrict is_call,
+    double* __restrict premium,
+    double* __restrict log_fk,
+    double* __restrict lo,
+    double* __restrict hi,
+    double* __restrict vol) {
+
+    // years and premium become the root of time and the time value in place,
+    // always through their own names so the restrict promises hold
+    for (size_t i = 0; i < n; ++i) {
+        double f = forward[i];
+        double k = strike[i];
+        double intrinsic = maxOf(is_call[i] > 0.5 ? f - k : k - f, 0.0);
+        double sqrt_t = std::sqrt(years[i]);
+        double time_value = premium[i] - intrinsic;
+        years[i] = sqrt_t;
+        premium[i] = time_value;
+        log_fk[i] = std::log(f / k);
+
+        // Brenner-Subrahmanyam start, exact at the money
+        vol[i] = minOf(maxOf(kSqrt2Pi * time_value / (f * sqrt_t), 0.05), 3.0);
+        lo[i] = kMinVol;
+        hi[i] = kMaxVol;
+    }
+
+    for (int iter = 0; iter < kNewtonIterations; ++iter) {
+        for (size_t i = 0; i < n; ++i) {
+            double f = forward[i];
+            double k = strike[i];
+            double sigma = vol[i];
+            double sqrt_t = years[i];
+            double put_shift = k < f ? f - k : 0.0;  // Put-call parity at zero rates
+            double sigma_t = sigma * sqrt_t;
+            double d1 = (log_fk[i] + 0.5 * sigma_t * sigma_t) / sigma_t;
+            double d2 = d1 - sigma_t;
+            double diff = f * normCdf(d1) - k * normCdf(d2) - put_shift - premium[i];
+            double vega = maxOf(f * normPdf(d1) * sqrt_t, 1e-300);
+            double next_hi = diff > 0.0 ? sigma : hi[i];
+            double next_lo = diff > 0.0 ? lo[i] : sigma;
+            double step = sigma - diff / vega;
+            vol[i] = step >= next_lo && step <= next_hi ? step : 0.5 * (next_lo + next_hi);
+            lo[i] = next_lo;
+            hi[i] = next_hi;
+        }
+    }
+
+    // No vol reproduces a premium at or below intrinsic
+    for (size_t i = 0; i < n; ++i) {
+        vol[i] = premium[i] > 0.0 && forward[i] > 0.0 ? vol[i] : 0.0;
+    }
+}
+
+} // namespace deribit
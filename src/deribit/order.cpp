@@ -52,6 +52,19 @@ Order::Order(const nlohmann::json& json) {
     }
 }
 
+void Order::applyTrade(double amount, double price, int64_t timestamp) {
+    double filled = filled_amount_ + amount;
+    if (filled > 0.0) {
+        average_price_ = (average_price_ * filled_amount_ + price * amount) / filled;
+    }
+    filled_amount_ = filled;
+    last_update_timestamp_ = timestamp;
+    
+    if (filled_amount_ >= amount_) {
+        order_state_ = "filled";
+    }
+}
+
 nlohmann::json Order::toJson() const {
     nlohmann::json json;
     json["order_id"] = order_id_;
@@ -69,4 +82,37 @@ nlohmann::json Order::toJson() const {
     return json;
 }
 
+std::string encodeOrderRequest(
+    const std::string& method,
+    uint64_t request_id,
+    const std::string& instrument_name,
+    double amount,
+    const std::string& type,
+    double price,
+    const std::string& label,
+    const std::string& access_token,
+    bool reduce_only) {
+    nlohmann::json request = {
+        {"jsonrpc", "2.0"},
+        {"id", request_id},
+        {"method", method},
+        {"params", {
+            {"instrument_name", instrument_name},
+            {"amount", amount},
+            {"type", type},
+            {"label", label},
+            {"access_token", access_token}
+        }}
+    };
+    
+    if (type == "limit") {
+        request["params"]["price"] = price;
+    }
+    if (reduce_only) {
+        request["params"]["reduce_only"] = true;
+    }
+    
+    return request.dump();
+}
+
 } // namespace deribit 
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "deribit/order_latency.hpp"
+#include "deribit/logger.hpp"
+
+namespace deribit {
+
+namespace {
+
+constexpr size_t kMethods = static_cast<size_t>(OrderMethod::Count);
+constexpr size_t kTransports = static_cast<size_t>(OrderTransport::Count);
+constexpr size_t kMetrics = static_cast<size_t>(OrderLatencyMetric::Count);
+
+bool isResting(const std::string& state) {
+    return state == "open" || state == "untriggered";
+}
+
+} // namespace
+
+const char* toString(OrderMethod method) {
+    switch (method) {
+        case OrderMethod::Buy: return "buy";
+        case OrderMethod::Sell: return "sell";
+        case OrderMethod::Edit: return "edit";
+        case OrderMethod::Cancel: return "cancel";
+        case OrderMethod::Count: break;
+    }
+    return "unknown";
+}
+
+const char* toString(OrderTransport transport) {
+    switch (transport) {
+        case OrderTransport::WebSocket: return "websocket";
+        case OrderTransport::Rest: return "rest";
+        case OrderTransport::Count: break;
+    }
+    return "unknown";
+}
+
+const char* toString(OrderLatencyMetric metric) {
+    switch (metric) {
+        case OrderLatencyMetric::EncodeToWrite: return "encode_to_write";
+        case OrderLatencyMetric::SendToAck: return "send_to_ack";
+        case OrderLatencyMetric::SendToFill: return "send_to_fill";
+        case OrderLatencyMetric::Count: break;
+    }
+    return "unknown";
+}
+
+OrderLatencyTracker::OrderLatencyTracker()
+    : recorder_(kMethods * kTransports * kMetrics) {
+}
+
+uint64_t OrderLatencyTracker::nextLocalKey() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_local_key_++;
+}
+
+void OrderLatencyTracker::onSent(
+    uint64_t key,
+    OrderMethod method,
+    OrderTransport transport,
+    Clock::time_point encoded,
+    Clock::time_point written,
+    const std::string& label) {
+
+    Pending pending{method, transport, written, label};
+    record(pending, OrderLatencyMetric::EncodeToWrite, encoded, written);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (inflight_.size() + awaiting_fill_.size() >= kMaxPending) {
+        prune(written);
+    }
+    if (!label.empty()) {
+        inflight_by_label_[label] = key;
+    }
+    inflight_[key] = std::move(pending);
+}
+
+void OrderLatencyTracker::onAck(uint64_t key, const nlohmann::json& response) {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = inflight_.find(key);
+    if (it == inflight_.end()) {
+        return;
+    }
+
+    Pending pending = std::move(it->second);
+    inflight_.erase(it);
+    if (!pending.label.empty()) {
+        inflight_by_label_.erase(pending.label);
+    }
+    record(pending, OrderLatencyMetric::SendToAck, pending.written, now);
+
+    if (!response.contains("result") || !response["result"].is_object() || pending.filled) {
+        return;
+    }
+
+    // Order methods return {"order": ..., "trades": [...]}; cancel returns the order itself
+    const auto& result = response["result"];
+    const auto& order = result.contains("order") ? result["order"] : result;
+    bool filled = (result.contains("trades") && !result["trades"].empty()) ||
+                  order.value("filled_amount", 0.0) > 0.0;
+    if (filled) {
+        record(pending, OrderLatencyMetric::SendToFill, pending.written, now);
+    } else if (pending.method != OrderMethod::Cancel && order.contains("order_id") &&
+               isResting(order.value("order_state", std::string()))) {
+        awaiting_fill_[order["order_id"].get<std::string>()] = std::move(pending);
+    }
+}
+
+void OrderLatencyTracker::onOrder(const Order& order) {
+    auto now = Clock::now();
+    bool filled = order.getFilledAmount() > 0.0;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = awaiting_fill_.find(order.getOrderId());
+    if (it != awaiting_fill_.end()) {
+        if (filled) {
+            record(it->second, OrderLatencyMetric::SendToFill, it->second.written, now);
+        }
+        if (filled || !isResting(order.getOrderState())) {
+            awaiting_fill_.erase(it);
+        }
+        return;
+    }
+
+    // The fill can beat the response; match the still in-flight request by label
+    if (filled && !order.getLabel().empty()) {
+        auto label = inflight_by_label_.find(order.getLabel());
+        if (label != inflight_by_label_.end()) {
+            auto pending = inflight_.find(label->second);
+            if (pending != inflight_.end() && !pending->second.filled) {
+                record(pending->second, OrderLatencyMetric::SendToFill, pending->second.written, now);
+                pending->second.filled = true;
+            }
+        }
+    }
+}
+
+LatencySnapshot OrderLatencyTracker::getLatency(
+    OrderMethod method,
+    OrderTransport transport,
+    OrderLatencyMetric metric) const {
+    return recorder_.snapshot(seriesOf(method, transport, metric));
+}
+
+void OrderLatencyTracker::printReport() const {
+    for (size_t m = 0; m < kMethods; ++m) {
+        for (size_t t = 0; t < kTransports; ++t) {
+            for (size_t k = 0; k < kMetrics; ++k) {
+                auto method = static_cast<OrderMethod>(m);
+                auto transport = static_cast<OrderTransport>(t);
+                auto metric = static_cast<OrderLatencyMetric>(k);
+                LatencySnapshot snapshot = getLatency(method, transport, metric);
+                if (snapshot.count() > 0) {
+                    DERIBIT_LOG_INFO("{}/{} {}: {}", toString(method), toString(transport),
+                                     toString(metric), snapshot.summary());
+                }
+            }
+        }
+    }
+}
+
+void OrderLatencyTracker::record(
+    const Pending& pending,
+    OrderLatencyMetric metric,
+    Clock::time_point start,
+    Clock::time_point end) {
+
+    auto elapsed = end - start;
+    recorder_.record(seriesOf(pending.method, pending.transport, metric), static_cast<uint64_t>(
+        std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), 0)));
+}
+
+void OrderLatencyTracker::prune(Clock::time_point now) {
+    for (auto it = inflight_.begin(); it != inflight_.end();) {
+        if (now - it->second.written > kMaxPendingAge) {
+            if (!it->second.label.empty()) {
+                inflight_by_label_.erase(it->second.label);
+            }
+            it = inflight_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = awaiting_fill_.begin(); it != awaiting_fill_.end();) {
+        if (now - it->second.written > kMaxPendingAge) {
+            it = awaiting_fill_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t OrderLatencyTracker::seriesOf(OrderMethod method, OrderTransport transport, OrderLatencyMetric metric) {
+    return (static_cast<size_t>(method) * kTransports + static_cast<size_t>(transport)) * kMetrics
+        + static_cast<size_t>(metric);
+}
+
+} // namespace deribit
@@ -0,0 +1,202 @@
+#include "deribit/order_store.hpp"
+#include "deribit/instrument.hpp"
+#include <mutex>
+
+namespace deribit {
+
+namespace {
+
+bool isWorking(const Order& order) {
+    return order.getOrderState() == "open" || order.getOrderState() == "untriggered";
+}
+
+} // namespace
+
+void OrderStore::applyOrder(const Order& order) {
+    if (order.getOrderId().empty()) {
+        return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    upsert(order);
+}
+
+void OrderStore::applyTrade(const nlohmann::json& trade) {
+    if (!trade.contains("order_id") || !trade.contains("amount") || !trade.contains("price")) {
+        return;
+    }
+
+    std::string order_id = trade["order_id"].get<std::string>();
+    int64_t timestamp = trade.value("timestamp", int64_t(0));
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) {
+        return;
+    }
+
+    // Order updates carry cumulative fills; only apply trades newer than the last one
+    if (timestamp <= it->second.getLastUpdateTimestamp()) {
+        return;
+    }
+
+    Order updated = it->second;
+    updated.applyTrade(trade["amount"].get<double>(), trade["price"].get<double>(), timestamp);
+    upsert(updated);
+}
+
+void OrderStore::reconcile(
+    const std::string& currency,
+    const std::vector<Order>& open_orders,
+    int64_t requested_at) {
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    std::unordered_set<std::string> listed;
+    for (const auto& order : open_orders) {
+        listed.insert(order.getOrderId());
+        upsert(order);
+    }
+
+    // Anything we still think is working but the exchange did not list is stale
+    std::vector<std::string> stale;
+    for (const auto& instrument : open_by_instrument_) {
+        if (Instrument::settlementCurrencyOf(instrument.first) != currency) {
+            continue;
+        }
+        for (const auto& order_id : instrument.second) {
+            if (listed.count(order_id) == 0 &&
+                orders_[order_id].getLastUpdateTimestamp() < requested_at) {
+                stale.push_back(order_id);
+            }
+        }
+    }
+    for (const auto& order_id : stale) {
+        erase(order_id);
+    }
+}
+
+std::vector<Order> OrderStore::getOpenOrders(const std::string& instrument_name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<Order> orders;
+
+    auto collect = [&](const std::unordered_set<std::string>& order_ids) {
+        for (const auto& order_id : order_ids) {
+            auto it = orders_.find(order_id);
+            if (it != orders_.end()) {
+                orders.push_back(it->second);
+            }
+        }
+    };
+
+    if (instrument_name.empty()) {
+        for (const auto& instrument : open_by_instrument_) {
+            collect(instrument.second);
+        }
+    } else {
+        auto it = open_by_instrument_.find(instrument_name);
+        if (it != open_by_instrument_.end()) {
+            collect(it->second);
+        }
+    }
+
+    return orders;
+}
+
+bool OrderStore::findOrder(const std::string& order_id, Order& order) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) {
+        return false;
+    }
+    order = it->second;
+    return true;
+}
+
+bool OrderStore::findOrderByLabel(const std::string& label, Order& order) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto label_it = order_id_by_label_.find(label);
+    if (label_it == order_id_by_label_.end()) {
+        return false;
+    }
+    auto it = orders_.find(label_it->second);
+    if (it == orders_.end()) {
+        return false;
+    }
+    order = it->second;
+    return true;
+}
+
+void OrderStore::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    orders_.clear();
+    order_id_by_label_.clear();
+    open_by_instrument_.clear();
+    closed_orders_.clear();
+}
+
+void OrderStore::upsert(const Order& order) {
+    const std::string& order_id = order.getOrderId();
+
+    auto it = orders_.find(order_id);
+    if (it != orders_.end()) {
+        // Ignore updates that arrive out of order
+        if (order.getLastUpdateTimestamp() < it->second.getLastUpdateTimestamp()) {
+            return;
+        }
+        it->second = order;
+    } else {
+        it = orders_.emplace(order_id, order).first;
+    }
+
+    if (!order.getLabel().empty()) {
+        order_id_by_label_[order.getLabel()] = order_id;
+    }
+
+    if (isWorking(order)) {
+        open_by_instrument_[order.getInstrumentName()].insert(order_id);
+        return;
+    }
+
+    // Closed orders leave the open index and age out of the store
+    auto open_it = open_by_instrument_.find(order.getInstrumentName());
+    if (open_it != open_by_instrument_.end() && open_it->second.erase(order_id) > 0) {
+        if (open_it->second.empty()) {
+            open_by_instrument_.erase(open_it);
+        }
+        closed_orders_.push_back(order_id);
+    }
+
+    while (closed_orders_.size() > kMaxClosedOrders) {
+        std::string oldest = closed_orders_.front();
+        closed_orders_.pop_front();
+        auto oldest_it = orders_.find(oldest);
+        if (oldest_it != orders_.end() && !isWorking(oldest_it->second)) {
+            erase(oldest);
+        }
+    }
+}
+
+void OrderStore::erase(const std::string& order_id) {
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) {
+        return;
+    }
+
+    auto label_it = order_id_by_label_.find(it->second.getLabel());
+    if (label_it != order_id_by_label_.end() && label_it->second == order_id) {
+        order_id_by_label_.erase(label_it);
+    }
+
+    auto open_it = open_by_instrument_.find(it->second.getInstrumentName());
+    if (open_it != open_by_instrument_.end()) {
+        open_it->second.erase(order_id);
+        if (open_it->second.empty()) {
+            open_by_instrument_.erase(open_it);
+        }
+    }
+
+    orders_.erase(it);
+}
+
+} // namespace deribit
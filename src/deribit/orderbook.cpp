@@ -23,6 +23,10 @@ Orderbook::Orderbook(const nlohmann::json& json) {
         timestamp_ = json["timestamp"].get<int64_t>();
     }
     
+    if (json.contains("change_id")) {
+        change_id_ = json["change_id"].get<int64_t>();
+    }
+    
     if (json.contains("bids")) {
         const auto& bids_json = json["bids"];
         for (const auto& bid : bids_json) {
@@ -103,12 +107,24 @@ void Orderbook::update(const nlohmann::json& json) {
         timestamp_ = json["timestamp"].get<int64_t>();
     }
     
+    if (json.contains("change_id")) {
+        change_id_ = json["change_id"].get<int64_t>();
+    }
+    
     if (json.contains("bids")) {
         const auto& bids_json = json["bids"];
         for (const auto& bid : bids_json) {
             if (bid.is_array() && bid.size() >= 2) {
-                double price = bid[0].get<double>();
-                double amount = bid[1].get<double>();
+                // Accept both [price, amount] and ["new"|"change"|"delete", price, amount]
+                size_t offset = bid[0].is_string() ? 1 : 0;
+                if (bid.size() < offset + 2) {
+                    continue;
+                }
+                double price = bid[offset].get<double>();
+                double amount = bid[offset + 1].get<double>();
+                if (offset == 1 && bid[0].get<std::string>() == "delete") {
+                    amount = 0.0;
+                }
                 
                 // Find if the price level already exists
                 auto it = std::find_if(bids_.begin(), bids_.end(),
@@ -142,8 +158,16 @@ void Orderbook::update(const nlohmann::json& json) {
         const auto& asks_json = json["asks"];
         for (const auto& ask : asks_json) {
             if (ask.is_array() && ask.size() >= 2) {
-                double price = ask[0].get<double>();
-                double amount = ask[1].get<double>();
+                // Accept both [price, amount] and ["new"|"change"|"delete", price, amount]
+                size_t offset = ask[0].is_string() ? 1 : 0;
+                if (ask.size() < offset + 2) {
+                    continue;
+                }
+                double price = ask[offset].get<double>();
+                double amount = ask[offset + 1].get<double>();
+                if (offset == 1 && ask[0].get<std::string>() == "delete") {
+                    amount = 0.0;
+                }
                 
                 // Find if the price level already exists
                 auto it = std::find_if(asks_.begin(), asks_.end(),
@@ -0,0 +1,57 @@
+#include "deribit/portfolio.hpp"
+
+namespace deribit {
+
+Portfolio::Portfolio(const nlohmann::json& json) {
+    if (json.contains("currency")) {
+        currency_ = json["currency"].get<std::string>();
+    }
+
+    if (json.contains("equity")) {
+        equity_ = json["equity"].get<double>();
+    }
+
+    if (json.contains("balance")) {
+        balance_ = json["balance"].get<double>();
+    }
+
+    if (json.contains("available_funds")) {
+        available_funds_ = json["available_funds"].get<double>();
+    }
+
+    if (json.contains("margin_balance")) {
+        margin_balance_ = json["margin_balance"].get<double>();
+    }
+
+    if (json.contains("initial_margin")) {
+        initial_margin_ = json["initial_margin"].get<double>();
+    }
+
+    if (json.contains("maintenance_margin")) {
+        maintenance_margin_ = json["maintenance_margin"].get<double>();
+    }
+
+    if (json.contains("total_pl")) {
+        total_pnl_ = json["total_pl"].get<double>();
+    }
+
+    if (json.contains("delta_total")) {
+        delta_total_ = json["delta_total"].get<double>();
+    }
+}
+
+nlohmann::json Portfolio::toJson() const {
+    nlohmann::json json;
+    json["currency"] = currency_;
+    json["equity"] = equity_;
+    json["balance"] = balance_;
+    json["available_funds"] = available_funds_;
+    json["margin_balance"] = margin_balance_;
+    json["initial_margin"] = initial_margin_;
+    json["maintenance_margin"] = maintenance_margin_;
+    json["total_pl"] = total_pnl_;
+    json["delta_total"] = delta_total_;
+    return json;
+}
+
+} // namespace deribit
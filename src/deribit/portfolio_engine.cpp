@@ -0,0 +1,354 @@
+#include "deribit/portfolio_engine.hpp"
+#include <cmath>
+
+namespace deribit {
+
+PortfolioEngine::PortfolioEngine(const InstrumentStore& instruments)
+    : instruments_(instruments)
+    , position_slots_(std::make_shared<const PositionSlotMap>())
+    , totals_slots_(std::make_shared<const TotalsSlotMap>()) {
+}
+
+void PortfolioEngine::applyPosition(const Position& position) {
+    if (position.getInstrumentName().empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool opened = rows_.find(position.getInstrumentName()) == rows_.end();
+    if (position.getSize() == 0.0) {
+        if (!opened) {
+            remove(position.getInstrumentName());
+            publishSlots();
+        }
+        return;
+    }
+
+    Row& row = upsert(position);
+    publish(*row.totals);
+    if (opened) {
+        publishSlots();
+    }
+}
+
+void PortfolioEngine::syncPositions(const PositionStore::PositionMap& positions) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = rows_.begin(); it != rows_.end();) {
+        if (positions.find(it->first) == positions.end()) {
+            it = rows_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& entry : positions) {
+        upsert(*entry.second);
+    }
+    reindex();
+
+    // Re-sum from the rows so incremental rounding does not accumulate
+    for (auto& entry : totals_) {
+        PortfolioTotals& totals = entry.second.value;
+        totals.unrealized_pnl = 0.0;
+        totals.delta = 0.0;
+        totals.initial_margin = 0.0;
+        totals.maintenance_margin = 0.0;
+        totals.positions = 0;
+    }
+    for (const auto& entry : rows_) {
+        fold(entry.second.totals->value, entry.second.risk, 1.0);
+    }
+    for (auto& entry : totals_) {
+        publish(entry.second);
+    }
+
+    publishSlots();
+}
+
+bool PortfolioEngine::updateMark(
+    const std::string& instrument_name,
+    double mark_price,
+    int64_t timestamp,
+    double option_delta) {
+
+    if (mark_price <= 0.0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = rows_.find(instrument_name);
+    if (it == rows_.end()) {
+        return false;
+    }
+
+    it->second.exchange_mark = true;
+    revalue(it->second, mark_price, timestamp, option_delta);
+    return true;
+}
+
+bool PortfolioEngine::updateMid(
+    const std::string& instrument_name,
+    double mid,
+    int64_t timestamp,
+    double option_delta) {
+
+    if (mid <= 0.0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = rows_.find(instrument_name);
+    if (it == rows_.end() || it->second.exchange_mark) {
+        return false;
+    }
+
+    revalue(it->second, mid, timestamp, option_delta);
+    return true;
+}
+
+void PortfolioEngine::updateIndex(const std::string& currency, double index_price, int64_t timestamp) {
+    if (index_price <= 0.0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = totals_.find(currency);
+    if (it == totals_.end()) {
+        return;
+    }
+
+    PortfolioTotals& totals = it->second.value;
+    totals.index_price = index_price;
+    totals.timestamp = timestamp;
+    publish(it->second);
+}
+
+bool PortfolioEngine::getPositionRisk(const std::string& instrument_name, PositionRisk& risk) const {
+    auto slots = std::atomic_load(&position_slots_);
+    auto it = slots->find(instrument_name);
+    if (it == slots->end()) {
+        return false;
+    }
+    risk = it->second->load();
+    return true;
+}
+
+bool PortfolioEngine::getTotals(const std::string& currency, PortfolioTotals& totals) const {
+    auto slots = std::atomic_load(&totals_slots_);
+    auto it = slots->find(currency);
+    if (it == slots->end()) {
+        return false;
+    }
+    totals = it->second->load();
+    return true;
+}
+
+std::shared_ptr<const PortfolioSnapshot> PortfolioEngine::getSnapshot(const std::string& currency) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = totals_.find(currency);
+    if (it == totals_.end()) {
+        return nullptr;
+    }
+
+    const CurrencyTotals& totals = it->second;
+    if (!totals.snapshot) {
+        auto snapshot = std::make_shared<PortfolioSnapshot>();
+        snapshot->totals = totals.value;
+        snapshot->instruments = totals.names;
+        snapshot->positions = totals.risks;
+        totals.snapshot = std::move(snapshot);
+    }
+    return totals.snapshot;
+}
+
+PortfolioEngine::Row& PortfolioEngine::upsert(const Position& position) {
+    const std::string& name = position.getInstrumentName();
+    auto it = rows_.find(name);
+    if (it == rows_.end()) {
+        Row row;
+        std::string currency;
+        auto instrument = instruments_.find(name);
+        if (instrument) {
+            row.exposure = instrument->isOption() ? Exposure::Option
+                : instrument->isInverse() ? Exposure::Inverse : Exposure::Linear;
+            currency = instrument->getSettlementCurrency();
+        } else {
+            // Unknown instrument: linear names carry their settlement currency ("BTC_USDC-PERPETUAL")
+            size_t underscore = name.find('_');
+            bool linear = underscore != std::string::npos && underscore < name.find('-');
+            row.exposure = position.getKind() == "option" ? Exposure::Option
+                : linear ? Exposure::Linear : Exposure::Inverse;
+            currency = Instrument::settlementCurrencyOf(name);
+        }
+        row.totals = &totalsFor(currency);
+        row.index = row.totals->risks.size();
+        row.totals->risks.emplace_back();
+        auto names = std::make_shared<std::vector<std::string>>(*row.totals->names);
+        names->push_back(name);
+        row.totals->names = std::move(names);
+        row.slot = std::make_shared<PositionSlot>();
+        it = rows_.emplace(name, std::move(row)).first;
+    } else {
+        fold(it->second.totals->value, it->second.risk, -1.0);
+    }
+
+    // Margin rates and option delta are re-derived from every exchange snapshot
+    Row& row = it->second;
+    double size = position.getSize();
+    double mark_price = position.getMarkPrice() > 0.0 ? position.getMarkPrice() : row.risk.mark_price;
+    row.exchange_mark = row.exchange_mark || position.getMarkPrice() > 0.0;
+    double exposure = exposureOf(row.exposure, size, mark_price);
+    row.initial_rate = exposure > 0.0 ? position.getInitialMargin() / exposure : 0.0;
+    row.maintenance_rate = exposure > 0.0 ? position.getMaintenanceMargin() / exposure : 0.0;
+    if (row.exposure == Exposure::Option) {
+        row.unit_delta = position.getDelta() / size;
+    }
+
+    row.risk.size = size;
+    row.risk.average_price = position.getAveragePrice();
+    row.risk.mark_price = mark_price;
+    value(row);
+
+    fold(row.totals->value, row.risk, 1.0);
+    storeRow(row);
+    return row;
+}
+
+void PortfolioEngine::remove(const std::string& instrument_name) {
+    auto it = rows_.find(instrument_name);
+    CurrencyTotals& totals = *it->second.totals;
+    fold(totals.value, it->second.risk, -1.0);
+
+    // Swap-remove from the currency's columns and repoint the row that moved
+    size_t index = it->second.index;
+    auto names = std::make_shared<std::vector<std::string>>(*totals.names);
+    if (index + 1 != names->size()) {
+        (*names)[index] = std::move(names->back());
+        totals.risks[index] = totals.risks.back();
+        rows_[(*names)[index]].index = index;
+    }
+    names->pop_back();
+    totals.risks.pop_back();
+    totals.names = std::move(names);
+
+    rows_.erase(it);
+    publish(totals);
+}
+
+void PortfolioEngine::revalue(Row& row, double mark_price, int64_t timestamp, double option_delta) {
+    PortfolioTotals& totals = row.totals->value;
+    fold(totals, row.risk, -1.0);
+    row.risk.mark_price = mark_price;
+    row.risk.timestamp = timestamp;
+    if (row.exposure == Exposure::Option && !std::isnan(option_delta)) {
+        row.unit_delta = option_delta;
+    }
+    value(row);
+    fold(totals, row.risk, 1.0);
+
+    totals.timestamp = timestamp;
+    storeRow(row);
+    publish(*row.totals);
+}
+
+void PortfolioEngine::storeRow(Row& row) {
+    row.slot->store(row.risk);
+    row.totals->risks[row.index] = row.risk;
+}
+
+void PortfolioEngine::reindex() {
+    // Rows point at their currency's totals, so the new name lists are keyed the same way
+    std::unordered_map<const CurrencyTotals*, std::shared_ptr<std::vector<std::string>>> names;
+    for (auto& entry : totals_) {
+        entry.second.risks.clear();
+        names[&entry.second] = std::make_shared<std::vector<std::string>>();
+    }
+    for (auto& entry : rows_) {
+        Row& row = entry.second;
+        row.index = row.totals->risks.size();
+        row.totals->risks.push_back(row.risk);
+        names[row.totals]->push_back(entry.first);
+    }
+    for (auto& entry : totals_) {
+        entry.second.names = std::move(names[&entry.second]);
+    }
+}
+
+void PortfolioEngine::publishSlots() {
+    auto positions = std::make_shared<PositionSlotMap>();
+    positions->reserve(rows_.size());
+    for (const auto& entry : rows_) {
+        (*positions)[entry.first] = entry.second.slot;
+    }
+
+    auto totals = std::make_shared<TotalsSlotMap>();
+    for (const auto& entry : totals_) {
+        (*totals)[entry.first] = entry.second.slot;
+    }
+
+    std::atomic_store(&position_slots_, std::shared_ptr<const PositionSlotMap>(std::move(positions)));
+    std::atomic_store(&totals_slots_, std::shared_ptr<const TotalsSlotMap>(std::move(totals)));
+}
+
+void PortfolioEngine::publish(CurrencyTotals& totals) {
+    totals.value.unrealized_pnl_usd = totals.value.unrealized_pnl * totals.value.index_price;
+    totals.slot->store(totals.value);
+    totals.snapshot.reset();
+}
+
+PortfolioEngine::CurrencyTotals& PortfolioEngine::totalsFor(const std::string& currency) {
+    auto& totals = totals_[currency];
+    if (!totals.slot) {
+        totals.slot = std::make_shared<TotalsSlot>();
+        totals.names = std::make_shared<const std::vector<std::string>>();
+    }
+    return totals;
+}
+
+double PortfolioEngine::exposureOf(Exposure exposure, double size, double mark_price) {
+    switch (exposure) {
+        case Exposure::Inverse:
+            return mark_price > 0.0 ? std::fabs(size) / mark_price : 0.0;
+        case Exposure::Linear:
+            return std::fabs(size) * mark_price;
+        case Exposure::Option:
+            return std::fabs(size);
+    }
+    return 0.0;
+}
+
+void PortfolioEngine::value(Row& row) {
+    PositionRisk& risk = row.risk;
+    double size = risk.size;
+    double mark_price = risk.mark_price;
+
+    switch (row.exposure) {
+        case Exposure::Inverse:
+            risk.unrealized_pnl = mark_price > 0.0 && risk.average_price > 0.0
+                ? size * (1.0 / risk.average_price - 1.0 / mark_price) : 0.0;
+            risk.delta = mark_price > 0.0 ? size / mark_price : 0.0;
+            break;
+        case Exposure::Linear:
+            risk.unrealized_pnl = size * (mark_price - risk.average_price);
+            risk.delta = size;
+            break;
+        case Exposure::Option:
+            risk.unrealized_pnl = size * (mark_price - risk.average_price);
+            risk.delta = size * row.unit_delta;
+            break;
+    }
+
+    double exposure = exposureOf(row.exposure, size, mark_price);
+    risk.initial_margin = row.initial_rate * exposure;
+    risk.maintenance_margin = row.maintenance_rate * exposure;
+}
+
+void PortfolioEngine::fold(PortfolioTotals& totals, const PositionRisk& risk, double sign) {
+    totals.unrealized_pnl += sign * risk.unrealized_pnl;
+    totals.delta += sign * risk.delta;
+    totals.initial_margin += sign * risk.initial_margin;
+    totals.maintenance_margin += sign * risk.maintenance_margin;
+    totals.positions = static_cast<uint32_t>(static_cast<int64_t>(totals.positions) + (sign > 0.0 ? 1 : -1));
+}
+
+} // namespace deribit
@@ -7,6 +7,10 @@ Position::Position(const nlohmann::json& json) {
         instrument_name_ = json["instrument_name"].get<std::string>();
     }
     
+    if (json.contains("kind")) {
+        kind_ = json["kind"].get<std::string>();
+    }
+    
     if (json.contains("size")) {
         size_ = json["size"].get<double>();
     }
@@ -35,6 +39,10 @@ Position::Position(const nlohmann::json& json) {
         maintenance_margin_ = json["maintenance_margin"].get<double>();
     }
     
+    if (json.contains("delta")) {
+        delta_ = json["delta"].get<double>();
+    }
+    
     if (json.contains("floating_profit_loss")) {
         unrealized_pnl_ = json["floating_profit_loss"].get<double>();
     }
@@ -51,6 +59,7 @@ Position::Position(const nlohmann::json& json) {
 nlohmann::json Position::toJson() const {
     nlohmann::json json;
     json["instrument_name"] = instrument_name_;
+    json["kind"] = kind_;
     json["size"] = size_;
     json["average_price"] = average_price_;
     json["estimated_liquidation_price"] = liquidation_price_;
@@ -58,6 +67,7 @@ nlohmann::json Position::toJson() const {
     json["index_price"] = index_price_;
     json["initial_margin"] = initial_margin_;
     json["maintenance_margin"] = maintenance_margin_;
+    json["delta"] = delta_;
     json["floating_profit_loss"] = unrealized_pnl_;
     json["realized_profit_loss"] = realized_pnl_;
     json["direction"] = direction_;
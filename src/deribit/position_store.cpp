@@ -0,0 +1,117 @@
+#include "deribit/position_store.hpp"
+#include "deribit/instrument.hpp"
+#include <chrono>
+
+namespace deribit {
+
+PositionStore::PositionStore()
+    : positions_(std::make_shared<const PositionMap>())
+    , portfolios_(std::make_shared<const PortfolioMap>()) {
+}
+
+void PositionStore::applyPositions(const nlohmann::json& positions) {
+    if (!positions.is_array() || positions.empty()) {
+        return;
+    }
+
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    auto next = std::make_shared<PositionMap>(*std::atomic_load(&positions_));
+
+    for (const auto& position_json : positions) {
+        auto position = std::make_shared<const Position>(position_json);
+        const std::string& name = position->getInstrumentName();
+        if (name.empty()) {
+            continue;
+        }
+        updated_at_[name] = now;
+
+        // Flat positions are removed rather than stored with zero size
+        if (position->getSize() == 0.0) {
+            next->erase(name);
+        } else {
+            (*next)[name] = std::move(position);
+        }
+    }
+
+    std::atomic_store(&positions_, std::shared_ptr<const PositionMap>(std::move(next)));
+}
+
+void PositionStore::applyPortfolio(const Portfolio& portfolio) {
+    if (portfolio.getCurrency().empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    auto next = std::make_shared<PortfolioMap>(*std::atomic_load(&portfolios_));
+    (*next)[portfolio.getCurrency()] = std::make_shared<const Portfolio>(portfolio);
+    std::atomic_store(&portfolios_, std::shared_ptr<const PortfolioMap>(std::move(next)));
+}
+
+void PositionStore::reconcile(
+    const std::string& currency,
+    const std::vector<Position>& positions,
+    int64_t requested_at) {
+
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    auto next = std::make_shared<PositionMap>(*std::atomic_load(&positions_));
+
+    // A change streamed after the request is newer than anything in the snapshot
+    auto changed_since = [this, requested_at](const std::string& instrument_name) {
+        auto it = updated_at_.find(instrument_name);
+        return it != updated_at_.end() && it->second >= requested_at;
+    };
+
+    for (auto it = next->begin(); it != next->end();) {
+        if (Instrument::settlementCurrencyOf(it->first) == currency && !changed_since(it->first)) {
+            it = next->erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const auto& position : positions) {
+        const std::string& name = position.getInstrumentName();
+        if (!name.empty() && position.getSize() != 0.0 && !changed_since(name)) {
+            (*next)[name] = std::make_shared<const Position>(position);
+        }
+    }
+
+    std::atomic_store(&positions_, std::shared_ptr<const PositionMap>(std::move(next)));
+}
+
+PositionStore::PositionPtr PositionStore::find(const std::string& instrument_name) const {
+    auto positions = std::atomic_load(&positions_);
+    auto it = positions->find(instrument_name);
+    return it != positions->end() ? it->second : nullptr;
+}
+
+std::shared_ptr<const PositionStore::PositionMap> PositionStore::snapshot() const {
+    return std::atomic_load(&positions_);
+}
+
+std::vector<Position> PositionStore::getPositions(const std::string& currency, const std::string& kind) const {
+    auto positions = std::atomic_load(&positions_);
+
+    std::vector<Position> result;
+    for (const auto& entry : *positions) {
+        if (Instrument::settlementCurrencyOf(entry.first) != currency) {
+            continue;
+        }
+        if (!kind.empty() && entry.second->getKind() != kind) {
+            continue;
+        }
+        result.push_back(*entry.second);
+    }
+    return result;
+}
+
+PositionStore::PortfolioPtr PositionStore::getPortfolio(const std::string& currency) const {
+    auto portfolios = std::atomic_load(&portfolios_);
+    auto it = portfolios->find(currency);
+    return it != portfolios->end() ? it->second : nullptr;
+}
+
+} // namespace deribit
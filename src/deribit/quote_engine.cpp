@@ -0,0 +1,370 @@
+#include "deribit/quote_engine.hpp"
+#include "deribit/logger.hpp"
+#include "deribit/trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace deribit {
+
+namespace {
+
+// Deribit error codes meaning the order we tried to touch is gone
+constexpr int kOrderNotFound = 10004;
+constexpr int kNotOpenOrder = 11044;
+
+bool isWorking(const Order& order) {
+    return order.getOrderState() == "open" || order.getOrderState() == "untriggered";
+}
+
+} // namespace
+
+QuoteEngine::QuoteEngine(
+    const Config& config,
+    const InstrumentStore& instruments,
+    RateLimiter& rate_limiter,
+    RiskEngine& risk_engine,
+    SendFunction send)
+    : config_(config)
+    , instruments_(instruments)
+    , rate_limiter_(rate_limiter)
+    , risk_engine_(risk_engine)
+    , send_(std::move(send)) {
+}
+
+QuoteEngine::~QuoteEngine() {
+    stop();
+}
+
+void QuoteEngine::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    retry_thread_ = std::thread(&QuoteEngine::runRetries, this);
+}
+
+void QuoteEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    retry_cv_.notify_all();
+    if (retry_thread_.joinable()) {
+        retry_thread_.join();
+    }
+}
+
+void QuoteEngine::setQuote(const std::string& instrument_name, const Quote& quote) {
+    quote_updates_.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& sides = quotes_[instrument_name];
+
+    const double prices[2] = {quote.bid_price, quote.ask_price};
+    const double amounts[2] = {quote.bid_amount, quote.ask_amount};
+    for (int side = Bid; side <= Ask; ++side) {
+        QuoteSide& state = sides[side];
+        if (state.desired_price != prices[side] || state.desired_amount != amounts[side]) {
+            state.desired_price = prices[side];
+            state.desired_amount = amounts[side];
+            state.dirty = true;
+        }
+        sendSide(instrument_name, static_cast<Side>(side), state);
+    }
+}
+
+void QuoteEngine::cancelQuotes(const std::string& instrument_name) {
+    setQuote(instrument_name, Quote());
+}
+
+void QuoteEngine::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushDeferred();
+}
+
+void QuoteEngine::runRetries() {
+    DERIBIT_TRACE_THREAD_NAME("quote_engine");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        if (!deferred_) {
+            retry_cv_.wait(lock, [this]() { return !running_ || deferred_; });
+            continue;
+        }
+
+        // Sleep until the matching-engine bucket has earned back one request
+        const RateLimitSettings& limit = config_.getMatchingEngineRateLimit();
+        auto retry_after = std::chrono::microseconds(limit.refill_per_second > 0.0
+            ? static_cast<int64_t>(limit.cost_per_request / limit.refill_per_second * 1e6) : 1000);
+        retry_cv_.wait_for(lock, std::max(retry_after, std::chrono::microseconds(1000)),
+                           [this]() { return !running_; });
+        if (!running_) {
+            break;
+        }
+        deferred_ = false;
+        flushDeferred();
+    }
+}
+
+void QuoteEngine::flushDeferred() {
+    for (auto& entry : quotes_) {
+        for (int side = Bid; side <= Ask; ++side) {
+            if (entry.second[side].dirty) {
+                sendSide(entry.first, static_cast<Side>(side), entry.second[side]);
+            }
+        }
+    }
+}
+
+void QuoteEngine::onResponse(const nlohmann::json& response) {
+    if (!response.contains("id")) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto pending_it = pending_.find(response["id"].get<uint64_t>());
+    if (pending_it == pending_.end()) {
+        return;
+    }
+    PendingRequest request = std::move(pending_it->second);
+    pending_.erase(pending_it);
+
+    auto quote_it = quotes_.find(request.instrument_name);
+    if (quote_it == quotes_.end()) {
+        return;
+    }
+    QuoteSide& state = quote_it->second[request.side];
+    state.pending_id = 0;
+
+    if (response.contains("error")) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        int code = response["error"].value("code", 0);
+        DERIBIT_LOG_ERROR("Quote {} failed for {}: {}",
+            request.method, request.instrument_name, response["error"].value("message", std::string()));
+
+        // An edit or cancel of an order that no longer rests means the side is empty
+        if (!state.order_id.empty() && (code == kOrderNotFound || code == kNotOpenOrder)) {
+            clearLive(state);
+            state.dirty = true;
+        }
+    } else if (response.contains("result")) {
+        acks_.fetch_add(1, std::memory_order_relaxed);
+        const auto& result = response["result"];
+        if (request.method == "private/cancel") {
+            clearLive(state);
+        } else if (result.contains("order")) {
+            Order order(result["order"]);
+            if (isWorking(order)) {
+                setLive(request.instrument_name, request.side, state, order);
+            } else {
+                clearLive(state);
+                state.dirty = true;
+            }
+        }
+    }
+
+    // Send whatever changed while the request was in flight
+    sendSide(request.instrument_name, request.side, state);
+}
+
+void QuoteEngine::onOrderUpdate(const Order& order) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto index_it = side_by_order_id_.find(order.getOrderId());
+    if (index_it == side_by_order_id_.end()) {
+        return;
+    }
+    std::string instrument_name = index_it->second.first;
+    Side side = index_it->second.second;
+    QuoteSide& state = quotes_[instrument_name][side];
+
+    if (isWorking(order)) {
+        state.live_price = order.getPrice();
+        state.live_amount = order.getAmount();
+        return;
+    }
+
+    // Filled or cancelled elsewhere: replace it if it is still wanted
+    clearLive(state);
+    state.dirty = true;
+    sendSide(instrument_name, side, state);
+}
+
+void QuoteEngine::reset(const std::string& instrument_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (instrument_name.empty()) {
+        quotes_.clear();
+        pending_.clear();
+        side_by_order_id_.clear();
+        return;
+    }
+
+    // Acks still in flight for the instrument are dropped when they arrive
+    auto it = quotes_.find(instrument_name);
+    if (it != quotes_.end()) {
+        for (auto& state : it->second) {
+            clearLive(state);
+        }
+        quotes_.erase(it);
+    }
+}
+
+QuoteEngineStats QuoteEngine::getStats() const {
+    QuoteEngineStats stats;
+    stats.quote_updates = quote_updates_.load(std::memory_order_relaxed);
+    stats.orders_sent = orders_sent_.load(std::memory_order_relaxed);
+    stats.edits_sent = edits_sent_.load(std::memory_order_relaxed);
+    stats.cancels_sent = cancels_sent_.load(std::memory_order_relaxed);
+    stats.edits_suppressed = edits_suppressed_.load(std::memory_order_relaxed);
+    stats.throttled = throttled_.load(std::memory_order_relaxed);
+    stats.risk_rejected = risk_rejected_.load(std::memory_order_relaxed);
+    stats.acks = acks_.load(std::memory_order_relaxed);
+    stats.errors = errors_.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.in_flight = pending_.size();
+    return stats;
+}
+
+void QuoteEngine::sendSide(const std::string& instrument_name, Side side, QuoteSide& state) {
+    // One request per side in flight; the ack handler sends any newer state
+    if (state.pending_id != 0 || !state.dirty) {
+        return;
+    }
+
+    bool wanted = state.desired_amount > 0.0 && state.desired_price > 0.0;
+    if (!wanted && state.order_id.empty()) {
+        state.dirty = false;
+        return;
+    }
+
+    auto instrument = instruments_.find(instrument_name);
+    double price = state.desired_price;
+    double tick = 0.0;
+    if (instrument) {
+        // Round passively so a rounded quote is never more aggressive
+        price = side == Bid ? instrument->roundPriceDown(price) : instrument->roundPriceUp(price);
+        tick = instrument->getTickSize();
+    }
+
+    std::string method;
+    nlohmann::json params;
+    if (!wanted) {
+        method = "private/cancel";
+        params = {{"order_id", state.order_id}};
+    } else if (!state.order_id.empty()) {
+        // Moves of less than the hysteresis band are not worth an edit
+        double band = (config_.getQuoteHysteresisTicks() - 0.5) * tick;
+        if (std::abs(price - state.live_price) < band || price == state.live_price) {
+            if (state.desired_amount == state.live_amount) {
+                edits_suppressed_.fetch_add(1, std::memory_order_relaxed);
+                state.dirty = false;
+                return;
+            }
+        }
+        method = "private/edit";
+        params = {
+            {"order_id", state.order_id},
+            {"amount", state.desired_amount},
+            {"price", price},
+            {"post_only", true}
+        };
+    } else {
+        method = side == Bid ? "private/buy" : "private/sell";
+        params = {
+            {"instrument_name", instrument_name},
+            {"amount", state.desired_amount},
+            {"type", "limit"},
+            {"price", price},
+            {"post_only", true},
+            {"label", "quote"}
+        };
+    }
+
+    // Limits are checked before spending a credit; a quote risk no longer allows is pulled rather than left resting
+    bool admit = false;
+    if (wanted) {
+        RiskReason reason = risk_engine_.checkLimits(
+            instrument_name, side == Bid, state.desired_amount, price,
+            instrument.get(), state.order_id.empty() ? 0.0 : state.live_amount);
+        if (reason != RiskReason::Accepted) {
+            risk_rejected_.fetch_add(1, std::memory_order_relaxed);
+            DERIBIT_LOG_WARN("Quote rejected by risk check ({}): {}", toString(reason), instrument_name);
+            if (state.order_id.empty()) {
+                state.dirty = false;
+                return;
+            }
+            method = "private/cancel";
+            params = {{"order_id", state.order_id}};
+        } else {
+            admit = true;
+        }
+    }
+
+    // Cancels go ahead of queued orders and queries, as they would through acquire()
+    if (!rate_limiter_.tryAcquire(RequestClass::MatchingEngine, RateLimiter::prioritize(method))) {
+        throttled_.fetch_add(1, std::memory_order_relaxed);
+        defer();
+        return;
+    }
+
+    // The order-rate slot is only taken once a credit is held, so throttled quotes never spend one
+    if (admit && risk_engine_.admit() != RiskReason::Accepted) {
+        risk_rejected_.fetch_add(1, std::memory_order_relaxed);
+        DERIBIT_LOG_WARN("Quote rejected by risk check ({}): {}", toString(RiskReason::OrderRate), instrument_name);
+        defer();
+        return;
+    }
+
+    uint64_t id = next_request_id_++;
+    nlohmann::json request = {
+        {"jsonrpc", "2.0"},
+        {"id", id},
+        {"method", method},
+        {"params", params}
+    };
+
+    if (!send_(request.dump())) {
+        DERIBIT_LOG_ERROR("Failed to send quote {} for {}", method, instrument_name);
+        defer();
+        return;
+    }
+
+    pending_[id] = {instrument_name, side, method};
+    state.pending_id = id;
+    state.dirty = false;
+
+    if (method == "private/cancel") {
+        cancels_sent_.fetch_add(1, std::memory_order_relaxed);
+    } else if (method == "private/edit") {
+        edits_sent_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        orders_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void QuoteEngine::defer() {
+    if (!deferred_) {
+        deferred_ = true;
+        retry_cv_.notify_one();
+    }
+}
+
+void QuoteEngine::setLive(const std::string& instrument_name, Side side, QuoteSide& state, const Order& order) {
+    if (state.order_id != order.getOrderId()) {
+        side_by_order_id_.erase(state.order_id);
+        state.order_id = order.getOrderId();
+        side_by_order_id_[state.order_id] = {instrument_name, side};
+    }
+    state.live_price = order.getPrice();
+    state.live_amount = order.getAmount();
+}
+
+void QuoteEngine::clearLive(QuoteSide& state) {
+    side_by_order_id_.erase(state.order_id);
+    state.order_id.clear();
+    state.live_price = 0.0;
+    state.live_amount = 0.0;
+}
+
+} // namespace deribit
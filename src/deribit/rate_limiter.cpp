@@ -0,0 +1,213 @@
+#include "deribit/rate_limiter.hpp"
+#include <algorithm>
+
+namespace deribit {
+
+RateLimiter::RateLimiter(const Config& config) {
+    auto now = Clock::now();
+
+    Bucket& matching = bucket(RequestClass::MatchingEngine);
+    matching.settings = config.getMatchingEngineRateLimit();
+    matching.credits = matching.settings.max_credits;
+    matching.last_refill = now;
+    publish(matching);
+
+    Bucket& non_matching = bucket(RequestClass::NonMatching);
+    non_matching.settings = config.getNonMatchingRateLimit();
+    non_matching.credits = non_matching.settings.max_credits;
+    non_matching.last_refill = now;
+    publish(non_matching);
+}
+
+std::chrono::nanoseconds RateLimiter::acquire(RequestClass request_class, RequestPriority priority) {
+    Bucket& b = bucket(request_class);
+    const size_t lane = static_cast<size_t>(priority);
+    const double cost = b.settings.cost_per_request;
+
+    auto start = Clock::now();
+    std::unique_lock<std::mutex> lock(b.mutex);
+
+    // Fast path: nobody queued and credits available
+    refill(b, start);
+    bool queue_empty = std::all_of(b.waiting.begin(), b.waiting.end(),
+        [](uint32_t waiting) { return waiting == 0; });
+    if (queue_empty && b.credits >= cost) {
+        b.credits -= cost;
+        b.requests.fetch_add(1, std::memory_order_relaxed);
+        publish(b);
+        return std::chrono::nanoseconds(0);
+    }
+
+    const uint64_t ticket = b.next_ticket[lane]++;
+    ++b.waiting[lane];
+    publish(b);
+
+    while (true) {
+        auto now = Clock::now();
+        refill(b, now);
+
+        bool my_turn = b.now_serving[lane] == ticket && !higherPriorityWaiting(b, lane);
+        if (my_turn && b.credits >= cost) {
+            break;
+        }
+
+        if (my_turn && b.settings.refill_per_second > 0.0) {
+            // Sleep until enough credits have accrued (or we are woken by a higher lane)
+            double deficit = cost - b.credits;
+            auto delay = std::chrono::duration<double>(deficit / b.settings.refill_per_second);
+            b.cv.wait_until(lock, now + std::chrono::duration_cast<Clock::duration>(delay));
+        } else {
+            b.cv.wait(lock);
+        }
+    }
+
+    b.credits -= cost;
+    --b.waiting[lane];
+    ++b.now_serving[lane];
+    b.requests.fetch_add(1, std::memory_order_relaxed);
+    publish(b);
+    lock.unlock();
+
+    // Let the next waiter re-evaluate its turn
+    b.cv.notify_all();
+
+    auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    recordWait(b, static_cast<uint64_t>(waited.count()));
+    return waited;
+}
+
+bool RateLimiter::tryAcquire(RequestClass request_class, RequestPriority priority) {
+    Bucket& b = bucket(request_class);
+    const size_t lane = static_cast<size_t>(priority);
+    std::lock_guard<std::mutex> lock(b.mutex);
+    refill(b, Clock::now());
+
+    // Lower lanes still queued are overtaken, as acquire() would
+    if (b.waiting[lane] > 0 || higherPriorityWaiting(b, lane) || b.credits < b.settings.cost_per_request) {
+        return false;
+    }
+
+    b.credits -= b.settings.cost_per_request;
+    b.requests.fetch_add(1, std::memory_order_relaxed);
+    publish(b);
+    return true;
+}
+
+RateLimiterStats RateLimiter::getStats(RequestClass request_class) const {
+    const Bucket& b = bucket(request_class);
+    RateLimiterStats stats;
+
+    stats.max_credits = b.settings.max_credits;
+    stats.available_credits = getAvailableCredits(request_class);
+    for (size_t lane = 0; lane < kLaneCount; ++lane) {
+        stats.queue_depth[lane] = b.published_waiting[lane].load(std::memory_order_relaxed);
+    }
+
+    if (stats.max_credits > 0.0) {
+        stats.utilisation = 1.0 - stats.available_credits / stats.max_credits;
+    }
+    stats.requests = b.requests.load(std::memory_order_relaxed);
+    stats.delayed_requests = b.delayed_requests.load(std::memory_order_relaxed);
+    stats.total_wait_ns = b.total_wait_ns.load(std::memory_order_relaxed);
+    stats.max_wait_ns = b.max_wait_ns.load(std::memory_order_relaxed);
+    return stats;
+}
+
+double RateLimiter::getAvailableCredits(RequestClass request_class) const {
+    const Bucket& b = bucket(request_class);
+    double credits = b.published_credits.load(std::memory_order_relaxed);
+    auto last_refill = Clock::time_point(std::chrono::duration_cast<Clock::duration>(
+        std::chrono::nanoseconds(b.published_refill_ns.load(std::memory_order_relaxed))));
+    // The two loads may straddle an update; the clamp keeps a torn read within the bucket
+    auto elapsed = std::max(0.0, std::chrono::duration<double>(Clock::now() - last_refill).count());
+    return std::min(b.settings.max_credits, credits + elapsed * b.settings.refill_per_second);
+}
+
+uint32_t RateLimiter::getQueueDepth(RequestClass request_class, RequestPriority priority) const {
+    return bucket(request_class).published_waiting[static_cast<size_t>(priority)].load(std::memory_order_relaxed);
+}
+
+RequestClass RateLimiter::classify(const std::string& method) {
+    static const char* const kMatchingEngineMethods[] = {
+        "private/buy",
+        "private/sell",
+        "private/edit",
+        "private/edit_by_label",
+        "private/cancel",
+        "private/cancel_all",
+        "private/cancel_all_by_currency",
+        "private/cancel_all_by_instrument",
+        "private/cancel_by_label",
+        "private/close_position",
+        "private/mass_quote",
+        "private/cancel_quotes"
+    };
+
+    for (const char* matching_method : kMatchingEngineMethods) {
+        if (method == matching_method) {
+            return RequestClass::MatchingEngine;
+        }
+    }
+    return RequestClass::NonMatching;
+}
+
+RequestPriority RateLimiter::prioritize(const std::string& method, bool reduce_only) {
+    if (method.compare(0, 14, "private/cancel") == 0) {
+        return RequestPriority::Cancel;
+    }
+    if (reduce_only || method == "private/close_position") {
+        return RequestPriority::RiskReducing;
+    }
+    if (classify(method) == RequestClass::MatchingEngine) {
+        return RequestPriority::Order;
+    }
+    return RequestPriority::Query;
+}
+
+RateLimiter::Bucket& RateLimiter::bucket(RequestClass request_class) {
+    return buckets_[request_class == RequestClass::MatchingEngine ? 0 : 1];
+}
+
+const RateLimiter::Bucket& RateLimiter::bucket(RequestClass request_class) const {
+    return buckets_[request_class == RequestClass::MatchingEngine ? 0 : 1];
+}
+
+void RateLimiter::refill(Bucket& bucket, Clock::time_point now) {
+    auto elapsed = std::chrono::duration<double>(now - bucket.last_refill).count();
+    if (elapsed <= 0.0) {
+        return;
+    }
+    bucket.credits = std::min(bucket.settings.max_credits,
+        bucket.credits + elapsed * bucket.settings.refill_per_second);
+    bucket.last_refill = now;
+}
+
+bool RateLimiter::higherPriorityWaiting(const Bucket& bucket, size_t lane) {
+    for (size_t i = 0; i < lane; ++i) {
+        if (bucket.waiting[i] > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RateLimiter::recordWait(Bucket& bucket, uint64_t wait_ns) {
+    bucket.delayed_requests.fetch_add(1, std::memory_order_relaxed);
+    bucket.total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+
+    uint64_t current_max = bucket.max_wait_ns.load(std::memory_order_relaxed);
+    while (wait_ns > current_max &&
+           !bucket.max_wait_ns.compare_exchange_weak(current_max, wait_ns, std::memory_order_relaxed)) {
+    }
+}
+
+void RateLimiter::publish(Bucket& bucket) {
+    bucket.published_credits.store(bucket.credits, std::memory_order_relaxed);
+    bucket.published_refill_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        bucket.last_refill.time_since_epoch()).count(), std::memory_order_relaxed);
+    for (size_t lane = 0; lane < kLaneCount; ++lane) {
+        bucket.published_waiting[lane].store(bucket.waiting[lane], std::memory_order_relaxed);
+    }
+}
+
+} // namespace deribit
@@ -0,0 +1,130 @@
+#include "deribit/response_cache.hpp"
+
+namespace deribit {
+
+namespace {
+
+// How often storing an entry also drops every expired one
+constexpr std::chrono::seconds kSweepInterval(1);
+
+} // namespace
+
+ResponseCache::ResponseCache() {
+    using std::chrono::milliseconds;
+    using std::chrono::seconds;
+
+    // Market data changes quickly, reference data rarely
+    ttls_["public/get_order_book"] = milliseconds(100);
+    ttls_["public/ticker"] = milliseconds(100);
+    ttls_["public/get_index_price"] = milliseconds(100);
+    ttls_["public/get_book_summary_by_currency"] = seconds(1);
+    ttls_["public/get_book_summary_by_instrument"] = seconds(1);
+    ttls_["public/get_instrument"] = seconds(60);
+    ttls_["public/get_instruments"] = seconds(60);
+    ttls_["public/get_currencies"] = seconds(60);
+}
+
+void ResponseCache::setTtl(const std::string& method, std::chrono::milliseconds ttl) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ttls_[method] = ttl;
+}
+
+std::chrono::milliseconds ResponseCache::getTtl(const std::string& method) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ttls_.find(method);
+    return it != ttls_.end() ? it->second : std::chrono::milliseconds(0);
+}
+
+nlohmann::json ResponseCache::getOrLoad(
+    const std::string& method,
+    const std::string& key,
+    const Loader& loader) {
+
+    std::promise<nlohmann::json> promise;
+    std::chrono::milliseconds ttl(0);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        auto ttl_it = ttls_.find(method);
+        if (ttl_it != ttls_.end()) {
+            ttl = ttl_it->second;
+        }
+        if (ttl.count() <= 0) {
+            lock.unlock();
+            return loader();
+        }
+
+        auto entry_it = entries_.find(key);
+        if (entry_it != entries_.end()) {
+            if (Clock::now() < entry_it->second.expires_at) {
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return entry_it->second.response;
+            }
+            entries_.erase(entry_it);
+        }
+
+        // Join an identical request that is already on the wire
+        auto flight_it = in_flight_.find(key);
+        if (flight_it != in_flight_.end()) {
+            auto flight = flight_it->second;
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            lock.unlock();
+            return flight.get();
+        }
+
+        in_flight_.emplace(key, promise.get_future().share());
+        misses_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    nlohmann::json response;
+    try {
+        response = loader();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        promise.set_exception(std::current_exception());
+        in_flight_.erase(key);
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Error responses are handed to waiters but never cached
+        if (response.contains("result")) {
+            auto now = Clock::now();
+            sweep(now);
+            entries_[key] = Entry{response, now + ttl};
+        }
+        promise.set_value(response);
+        in_flight_.erase(key);
+    }
+
+    return response;
+}
+
+void ResponseCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+void ResponseCache::sweep(Clock::time_point now) {
+    if (now < next_sweep_) {
+        return;
+    }
+    next_sweep_ = now + kSweepInterval;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        it = now < it->second.expires_at ? std::next(it) : entries_.erase(it);
+    }
+}
+
+ResponseCacheStats ResponseCache::getStats() const {
+    ResponseCacheStats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.entries = entries_.size();
+    return stats;
+}
+
+} // namespace deribit
@@ -1,11 +1,14 @@
 #include "deribit/rest_client.hpp"
+#include "deribit/curl_global.hpp"
+#include "deribit/logger.hpp"
+#include "deribit/trace.hpp"
 #include <sstream>
-#include <iostream>
 #include <curl/curl.h>
 #include <openssl/hmac.h>
 #include <openssl/sha.h>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
 
 namespace deribit {
 
@@ -20,20 +23,24 @@ RestClient::RestClient(const Config& config)
 }
 
 RestClient::~RestClient() {
+    stopTokenRefresher();
+    if (refresh_curl_) {
+        curl_easy_cleanup(refresh_curl_);
+    }
     if (curl_) {
         curl_easy_cleanup(curl_);
-        curl_global_cleanup();
     }
 }
 
 bool RestClient::initialize() {
-    CURLcode res = curl_global_init(CURL_GLOBAL_ALL);
-    if (res != CURLE_OK) {
+    if (!curlGlobalInit()) {
         return false;
     }
 
     curl_ = curl_easy_init();
-    return (curl_ != nullptr);
+    // The refresher thread gets its own handle so it never races request threads
+    refresh_curl_ = curl_easy_init();
+    return (curl_ != nullptr && refresh_curl_ != nullptr);
 }
 
 nlohmann::json RestClient::authenticate() {
@@ -53,6 +60,8 @@ nlohmann::json RestClient::authenticate() {
     std::string json_data = request.dump();
     std::string response;
     
+    std::unique_lock<std::mutex> curl_lock(curl_mutex_);
+
     curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
     curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, json_data.c_str());
     curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, WriteCallback);
@@ -63,11 +72,16 @@ nlohmann::json RestClient::authenticate() {
     
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
     
-    CURLcode res = curl_easy_perform(curl_);
+    CURLcode res;
+    {
+        DERIBIT_TRACE_SCOPE("rest.get");
+        res = curl_easy_perform(curl_);
+    }
     curl_slist_free_all(headers);
+    curl_lock.unlock();
     
     if (res != CURLE_OK) {
-        std::cerr << "Authentication failed: " << curl_easy_strerror(res) << std::endl;
+        DERIBIT_LOG_ERROR("Authentication failed: {}", curl_easy_strerror(res));
         is_authenticated_ = false;
         return nlohmann::json();
     }
@@ -75,16 +89,12 @@ nlohmann::json RestClient::authenticate() {
     nlohmann::json json_response = handleResponse(response);
     
     if (json_response.contains("result")) {
-        const auto& result = json_response["result"];
-        access_token_ = result["access_token"].get<std::string>();
-        refresh_token_ = result["refresh_token"].get<std::string>();
-        expires_in_ = result["expires_in"].get<int>();
-        token_type_ = result["token_type"].get<std::string>();
+        storeTokens(json_response["result"]);
         is_authenticated_ = true;
-        updateTokenExpiry();
-        std::cout << "Authentication successful" << std::endl;
+        startTokenRefresher();
+        DERIBIT_LOG_INFO("Authentication successful");
     } else {
-        std::cerr << "Authentication failed: " << json_response.dump() << std::endl;
+        DERIBIT_LOG_ERROR("Authentication failed: {}", json_response.dump());
         is_authenticated_ = false;
     }
     
@@ -92,33 +102,39 @@ nlohmann::json RestClient::authenticate() {
 }
 
 nlohmann::json RestClient::refreshToken() {
-    if (refresh_token_.empty()) {
+    std::string refresh_token;
+    {
+        std::lock_guard<std::mutex> lock(token_mutex_);
+        refresh_token = refresh_token_;
+    }
+    if (refresh_token.empty() || !refresh_curl_) {
         return nlohmann::json();
     }
 
     // Use form-encoded data instead of JSON
-    std::string form_data = "grant_type=refresh_token&refresh_token=" + refresh_token_ + 
+    std::string form_data = "grant_type=refresh_token&refresh_token=" + refresh_token + 
                            "&client_id=" + config_.getApiKey() + 
                            "&client_secret=" + config_.getApiSecret();
     
     std::string url = buildUrl("public/auth");
     std::string response;
     
-    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, form_data.c_str());
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response);
+    std::lock_guard<std::mutex> refresh_lock(refresh_mutex_);
+    curl_easy_setopt(refresh_curl_, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(refresh_curl_, CURLOPT_POSTFIELDS, form_data.c_str());
+    curl_easy_setopt(refresh_curl_, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(refresh_curl_, CURLOPT_WRITEDATA, &response);
     
     struct curl_slist* headers = nullptr;
     headers = curl_slist_append(headers, "Content-Type: application/x-www-form-urlencoded");
     
-    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(refresh_curl_, CURLOPT_HTTPHEADER, headers);
     
-    CURLcode res = curl_easy_perform(curl_);
+    CURLcode res = curl_easy_perform(refresh_curl_);
     curl_slist_free_all(headers);
     
     if (res != CURLE_OK) {
-        std::cerr << "Token refresh failed: " << curl_easy_strerror(res) << std::endl;
+        DERIBIT_LOG_ERROR("Token refresh failed: {}", curl_easy_strerror(res));
         is_authenticated_ = false;
         return nlohmann::json();
     }
@@ -126,16 +142,12 @@ nlohmann::json RestClient::refreshToken() {
     nlohmann::json json_response = handleResponse(response);
     
     if (json_response.contains("result")) {
-        const auto& result = json_response["result"];
-        access_token_ = result["access_token"].get<std::string>();
-        refresh_token_ = result["refresh_token"].get<std::string>();
-        expires_in_ = result["expires_in"].get<int>();
-        token_type_ = result["token_type"].get<std::string>();
-        updateTokenExpiry();
-        std::cout << "Token refresh successful" << std::endl;
+        storeTokens(json_response["result"]);
+        is_authenticated_ = true;
+        DERIBIT_LOG_INFO("Token refresh successful");
         return json_response;
     } else if (json_response.contains("error")) {
-        std::cerr << "Token refresh failed: " << json_response.dump() << std::endl;
+        DERIBIT_LOG_ERROR("Token refresh failed: {}", json_response.dump());
         is_authenticated_ = false;
         return nlohmann::json();
     }
@@ -148,14 +160,38 @@ nlohmann::json RestClient::get(const std::string& endpoint, const nlohmann::json
         throw std::runtime_error("CURL not initialized");
     }
     
-    // Refresh token if needed
-    if (is_authenticated_ && needsRefresh()) {
-        auto response = refreshToken();
-        if (!response.contains("result")) {
-            throw std::runtime_error("Failed to refresh authentication token");
-        }
+    // JSON-RPC requests carry the method in the body, others in the endpoint
+    std::string method;
+    if (endpoint.empty() && params.is_object() && params.contains("method")) {
+        method = params["method"].get<std::string>();
+    } else {
+        method = endpoint.substr(0, endpoint.find('?'));
     }
     
+    // Only public data is shared between callers
+    if (method.compare(0, 7, "public/") != 0) {
+        return performGet(endpoint, params);
+    }
+    
+    std::string key = method + '|' + endpoint + '|' +
+        (params.is_object() && params.contains("params") ? params["params"].dump() : params.dump());
+    
+    return response_cache_.getOrLoad(method, key, [&]() {
+        return performGet(endpoint, params);
+    });
+}
+
+void RestClient::setCacheTtl(const std::string& method, std::chrono::milliseconds ttl) {
+    response_cache_.setTtl(method, ttl);
+}
+
+ResponseCacheStats RestClient::getCacheStats() const {
+    return response_cache_.getStats();
+}
+
+nlohmann::json RestClient::performGet(const std::string& endpoint, const nlohmann::json& params) {
+    std::lock_guard<std::mutex> lock(curl_mutex_);
+    
     std::string url = buildUrl(endpoint);
     std::string response;
     
@@ -176,8 +212,7 @@ nlohmann::json RestClient::get(const std::string& endpoint, const nlohmann::json
     }
     
     if (is_authenticated_) {
-        std::string auth_header = "Authorization: Bearer " + access_token_;
-        headers = curl_slist_append(headers, auth_header.c_str());
+        headers = curl_slist_append(headers, buildAuthHeader().c_str());
     }
     
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
@@ -193,11 +228,11 @@ nlohmann::json RestClient::get(const std::string& endpoint, const nlohmann::json
     curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &http_code);
     
     if (http_code != 200) {
-        std::cerr << "HTTP request failed with code " << http_code << std::endl;
+        DERIBIT_LOG_ERROR("HTTP request failed with code {}", http_code);
         try {
             auto error_json = nlohmann::json::parse(response);
             if (error_json.contains("error")) {
-                std::cerr << "Error message: " << error_json["error"]["message"] << std::endl;
+                DERIBIT_LOG_ERROR("Error message: {}", error_json["error"]["message"].dump());
             }
             return error_json;  // Return the error response for better error handling
         } catch (...) {
@@ -218,7 +253,7 @@ nlohmann::json RestClient::post(const std::string& endpoint, const nlohmann::jso
         return nlohmann::json();
     }
 
-    checkAndRefreshToken();
+    std::lock_guard<std::mutex> lock(curl_mutex_);
 
     std::string url = buildUrl(endpoint);
     std::string response;
@@ -270,11 +305,15 @@ nlohmann::json RestClient::post(const std::string& endpoint, const nlohmann::jso
     }
 
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
-    CURLcode res = curl_easy_perform(curl_);
+    CURLcode res;
+    {
+        DERIBIT_TRACE_SCOPE("rest.post");
+        res = curl_easy_perform(curl_);
+    }
     curl_slist_free_all(headers);
 
     if (res != CURLE_OK) {
-        std::cerr << "POST request failed: " << curl_easy_strerror(res) << std::endl;
+        DERIBIT_LOG_ERROR("POST request failed: {}", curl_easy_strerror(res));
         return nlohmann::json();
     }
 
@@ -282,11 +321,11 @@ nlohmann::json RestClient::post(const std::string& endpoint, const nlohmann::jso
     curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &http_code);
     
     if (http_code != 200) {
-        std::cerr << "HTTP request failed with code " << http_code << std::endl;
+        DERIBIT_LOG_ERROR("HTTP request failed with code {}", http_code);
         try {
             auto error_json = nlohmann::json::parse(response);
             if (error_json.contains("error")) {
-                std::cerr << "Error message: " << error_json["error"]["message"] << std::endl;
+                DERIBIT_LOG_ERROR("Error message: {}", error_json["error"]["message"].dump());
             }
             return error_json;  // Return the error response for better error handling
         } catch (...) {
@@ -306,38 +345,100 @@ std::string RestClient::buildUrl(const std::string& endpoint) const {
 }
 
 std::string RestClient::buildAuthHeader() const {
-    return "Authorization: Bearer " + access_token_;
+    return "Authorization: Bearer " + getAccessToken();
+}
+
+std::string RestClient::getAccessToken() const {
+    auto token = std::atomic_load(&access_token_);
+    return token ? *token : std::string();
 }
 
 nlohmann::json RestClient::handleResponse(const std::string& response) const {
     try {
         return nlohmann::json::parse(response);
     } catch (const nlohmann::json::exception& e) {
-        std::cerr << "JSON parsing error: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("JSON parsing error: {}", e.what());
         return nlohmann::json();
     }
 }
 
-void RestClient::updateTokenExpiry() {
-    token_expiry_ = std::chrono::system_clock::now() + std::chrono::seconds(expires_in_);
+void RestClient::storeTokens(const nlohmann::json& result) {
+    auto access_token = std::make_shared<const std::string>(
+        result["access_token"].get<std::string>());
+    {
+        std::lock_guard<std::mutex> lock(token_mutex_);
+        refresh_token_ = result["refresh_token"].get<std::string>();
+        expires_in_ = result["expires_in"].get<int>();
+        token_type_ = result["token_type"].get<std::string>();
+        token_expiry_ = std::chrono::system_clock::now() + std::chrono::seconds(expires_in_);
+    }
+    // Readers on the order path only ever load the pointer
+    std::atomic_store(&access_token_, access_token);
+    refresh_cv_.notify_all();
+}
+
+std::chrono::system_clock::time_point RestClient::nextRefreshTime() const {
+    // Refresh 5 minutes before expiry, or at half-life for short-lived tokens
+    auto lead = std::min<std::chrono::seconds>(
+        std::chrono::minutes(5), std::chrono::seconds(expires_in_ / 2));
+    return token_expiry_ - lead;
 }
 
 bool RestClient::needsRefresh() const {
+    std::lock_guard<std::mutex> lock(token_mutex_);
     if (!is_authenticated_ || refresh_token_.empty()) {
         return false;
     }
 
-    auto now = std::chrono::system_clock::now();
-    // Refresh if less than 5 minutes until expiry
-    return (token_expiry_ - now) < std::chrono::minutes(5);
+    return std::chrono::system_clock::now() >= nextRefreshTime();
+}
+
+void RestClient::startTokenRefresher() {
+    std::lock_guard<std::mutex> lock(token_mutex_);
+    if (refresher_running_) {
+        return;
+    }
+    refresher_running_ = true;
+    refresh_thread_ = std::thread(&RestClient::runTokenRefresher, this);
 }
 
-bool RestClient::checkAndRefreshToken() {
-    if (needsRefresh()) {
-        auto response = refreshToken();
-        return response.contains("result");
+void RestClient::stopTokenRefresher() {
+    {
+        std::lock_guard<std::mutex> lock(token_mutex_);
+        refresher_running_ = false;
+    }
+    refresh_cv_.notify_all();
+    if (refresh_thread_.joinable()) {
+        refresh_thread_.join();
+    }
+}
+
+void RestClient::runTokenRefresher() {
+    std::unique_lock<std::mutex> lock(token_mutex_);
+    while (refresher_running_) {
+        // Sleep until the refresh time; storeTokens() wakes us to recompute it
+        auto refresh_at = nextRefreshTime();
+        refresh_cv_.wait_until(lock, refresh_at, [this, refresh_at]() {
+            return !refresher_running_ || nextRefreshTime() != refresh_at;
+        });
+        if (!refresher_running_) {
+            break;
+        }
+        if (std::chrono::system_clock::now() < nextRefreshTime()) {
+            continue;
+        }
+
+        lock.unlock();
+        bool refreshed = refreshToken().contains("result");
+        lock.lock();
+
+        if (!refreshed) {
+            // Back off before retrying so a flaky link does not spin
+            refresh_cv_.wait_for(lock, std::chrono::seconds(5), [this]() {
+                return !refresher_running_;
+            });
+        }
     }
-    return true;
 }
 
 } // namespace deribit 
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "deribit/risk_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace deribit {
+
+const char* toString(RiskReason reason) {
+    switch (reason) {
+        case RiskReason::Accepted: return "accepted";
+        case RiskReason::Halted: return "halted";
+        case RiskReason::MaxOrderSize: return "max_order_size";
+        case RiskReason::MaxPosition: return "max_position";
+        case RiskReason::MaxNotional: return "max_notional";
+        case RiskReason::PriceBand: return "price_band";
+        case RiskReason::OrderRate: return "order_rate";
+        default: return "unknown";
+    }
+}
+
+RiskEngine::RiskEngine(const RiskLimits& limits)
+    : instruments_(std::make_shared<const InstrumentRiskMap>()) {
+    setLimits(limits);
+}
+
+RiskReason RiskEngine::check(
+    const std::string& instrument_name,
+    bool is_buy,
+    double amount,
+    double price,
+    const Instrument* reference,
+    double replaced_amount) {
+
+    RiskReason reason = checkLimits(instrument_name, is_buy, amount, price, reference, replaced_amount);
+    return reason == RiskReason::Accepted ? admit() : reason;
+}
+
+RiskReason RiskEngine::checkLimits(
+    const std::string& instrument_name,
+    bool is_buy,
+    double amount,
+    double price,
+    const Instrument* reference,
+    double replaced_amount) {
+
+    checks_.fetch_add(1, std::memory_order_relaxed);
+
+    if (halted_.load(std::memory_order_relaxed)) {
+        return reject(RiskReason::Halted);
+    }
+
+    double max_order_size = max_order_size_.load(std::memory_order_relaxed);
+    if (max_order_size > 0.0 && amount > max_order_size) {
+        return reject(RiskReason::MaxOrderSize);
+    }
+
+    auto instrument = find(instrument_name);
+    double position = instrument ? instrument->position.load(std::memory_order_relaxed) : 0.0;
+    double mid = instrument ? instrument->mid.load(std::memory_order_relaxed) : 0.0;
+    double open_amount = !instrument ? 0.0 : is_buy
+        ? instrument->open_buy.load(std::memory_order_relaxed)
+        : instrument->open_sell.load(std::memory_order_relaxed);
+
+    // Worst case is every open order on this side filling too; orders that shrink the position always pass
+    double max_position = max_position_.load(std::memory_order_relaxed);
+    double exposure = std::max(open_amount - replaced_amount, 0.0) + amount;
+    double next_position = position + (is_buy ? exposure : -exposure);
+    if (max_position > 0.0 && std::abs(next_position) > max_position &&
+        std::abs(next_position) > std::abs(position)) {
+        return reject(RiskReason::MaxPosition);
+    }
+
+    // Market orders are valued at the mid; without one only the limit price is known
+    double reference_price = price > 0.0 ? price : mid;
+    double max_notional = max_notional_.load(std::memory_order_relaxed);
+    if (max_notional > 0.0) {
+        double notional = amount * reference_price;
+        if (reference && reference->isInverse()) {
+            notional = amount;
+        } else if (reference && reference->isOption()) {
+            // Option amounts are contracts on the underlying; the premium would understate them
+            auto index = find(reference->getBaseCurrency());
+            notional = amount * (index ? index->mid.load(std::memory_order_relaxed) : 0.0);
+        }
+        if (notional > max_notional) {
+            return reject(RiskReason::MaxNotional);
+        }
+    }
+
+    double price_band = price_band_.load(std::memory_order_relaxed);
+    if (price_band > 0.0 && price > 0.0 && mid > 0.0 &&
+        std::abs(price - mid) > price_band * mid) {
+        return reject(RiskReason::PriceBand);
+    }
+
+    return RiskReason::Accepted;
+}
+
+RiskReason RiskEngine::admit() {
+    return admitOrder() ? RiskReason::Accepted : reject(RiskReason::OrderRate);
+}
+
+void RiskEngine::setLimits(const RiskLimits& limits) {
+    max_order_size_.store(limits.max_order_size, std::memory_order_relaxed);
+    max_position_.store(limits.max_position, std::memory_order_relaxed);
+    max_notional_.store(limits.max_notional, std::memory_order_relaxed);
+    price_band_.store(limits.price_band, std::memory_order_relaxed);
+    max_orders_per_second_.store(limits.max_orders_per_second, std::memory_order_relaxed);
+}
+
+void RiskEngine::updateMid(const std::string& instrument_name, double mid) {
+    findOrCreate(instrument_name)->mid.store(mid, std::memory_order_relaxed);
+}
+
+void RiskEngine::updateIndex(const std::string& currency, double index_price) {
+    // Currency codes never collide with instrument names, so indexes share the table
+    findOrCreate(currency)->mid.store(index_price, std::memory_order_relaxed);
+}
+
+void RiskEngine::updatePosition(const std::string& instrument_name, double size) {
+    findOrCreate(instrument_name)->position.store(size, std::memory_order_relaxed);
+}
+
+void RiskEngine::syncPositions(const PositionStore::PositionMap& positions) {
+    for (const auto& entry : positions) {
+        updatePosition(entry.first, entry.second->getSize());
+    }
+
+    auto instruments = std::atomic_load(&instruments_);
+    for (const auto& entry : *instruments) {
+        if (positions.count(entry.first) == 0) {
+            entry.second->position.store(0.0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void RiskEngine::updateOpenOrders(const std::string& instrument_name, double buy_amount, double sell_amount) {
+    auto instrument = findOrCreate(instrument_name);
+    instrument->open_buy.store(buy_amount, std::memory_order_relaxed);
+    instrument->open_sell.store(sell_amount, std::memory_order_relaxed);
+}
+
+void RiskEngine::syncOpenOrders(const std::vector<Order>& open_orders) {
+    std::unordered_map<std::string, std::pair<double, double>> totals;
+    for (const auto& order : open_orders) {
+        auto& total = totals[order.getInstrumentName()];
+        double remaining = order.getAmount() - order.getFilledAmount();
+        (order.getDirection() == "buy" ? total.first : total.second) += remaining;
+    }
+    for (const auto& entry : totals) {
+        updateOpenOrders(entry.first, entry.second.first, entry.second.second);
+    }
+
+    auto instruments = std::atomic_load(&instruments_);
+    for (const auto& entry : *instruments) {
+        if (totals.count(entry.first) == 0) {
+            entry.second->open_buy.store(0.0, std::memory_order_relaxed);
+            entry.second->open_sell.store(0.0, std::memory_order_relaxed);
+        }
+    }
+}
+
+RiskStats RiskEngine::getStats() const {
+    RiskStats stats;
+    stats.checks = checks_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < rejections_.size(); ++i) {
+        stats.rejections[i] = rejections_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+std::shared_ptr<RiskEngine::InstrumentRisk> RiskEngine::find(const std::string& instrument_name) const {
+    auto instruments = std::atomic_load(&instruments_);
+    auto it = instruments->find(instrument_name);
+    return it != instruments->end() ? it->second : nullptr;
+}
+
+std::shared_ptr<RiskEngine::InstrumentRisk> RiskEngine::findOrCreate(const std::string& instrument_name) {
+    if (auto instrument = find(instrument_name)) {
+        return instrument;
+    }
+
+    // First sight of an instrument publishes a new map; existing slots are shared
+    std::lock_guard<std::mutex> lock(instruments_mutex_);
+    auto current = std::atomic_load(&instruments_);
+    auto it = current->find(instrument_name);
+    if (it != current->end()) {
+        return it->second;
+    }
+
+    auto next = std::make_shared<InstrumentRiskMap>(*current);
+    auto instrument = std::make_shared<InstrumentRisk>();
+    next->emplace(instrument_name, instrument);
+    std::atomic_store(&instruments_, std::shared_ptr<const InstrumentRiskMap>(std::move(next)));
+    return instrument;
+}
+
+bool RiskEngine::admitOrder() {
+    uint32_t max_orders = max_orders_per_second_.load(std::memory_order_relaxed);
+    if (max_orders == 0) {
+        return true;
+    }
+
+    uint64_t second = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count()) & 0xffffffffULL;
+
+    uint64_t current = rate_window_.load(std::memory_order_relaxed);
+    for (;;) {
+        uint64_t count = (current >> 32) == second ? (current & 0xffffffffULL) : 0;
+        if (count >= max_orders) {
+            return false;
+        }
+        uint64_t next = (second << 32) | (count + 1);
+        if (rate_window_.compare_exchange_weak(current, next, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+RiskReason RiskEngine::reject(RiskReason reason) {
+    rejections_[static_cast<size_t>(reason)].fetch_add(1, std::memory_order_relaxed);
+    return reason;
+}
+
+} // namespace deribit
@@ -0,0 +1,110 @@
+#include "deribit/time_sync.hpp"
+#include "deribit/logger.hpp"
+#include <algorithm>
+
+namespace deribit {
+
+namespace {
+
+int64_t wallNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+TimeSync::TimeSync(SendFunction send)
+    : send_(std::move(send)) {
+}
+
+bool TimeSync::probe() {
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_id_ != 0) {
+            discarded_.fetch_add(1, std::memory_order_relaxed);
+        }
+        id = next_request_id_;
+        next_request_id_ = next_request_id_ + 1 < kLastRequestId ? next_request_id_ + 1 : kFirstRequestId;
+        pending_id_ = id;
+        pending_sent_ns_ = wallNowNs();
+    }
+
+    nlohmann::json request = {
+        {"jsonrpc", "2.0"},
+        {"id", id},
+        {"method", "public/get_time"},
+        {"params", nlohmann::json::object()}
+    };
+    probes_.fetch_add(1, std::memory_order_relaxed);
+    if (!send_(request.dump())) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_id_ == id) {
+            pending_id_ = 0;
+        }
+        DERIBIT_LOG_WARN("Failed to send time sync probe");
+        return false;
+    }
+    return true;
+}
+
+void TimeSync::onResponse(const nlohmann::json& response, int64_t received_ns) {
+    uint64_t id = response["id"].get<uint64_t>();
+    if (response.contains("error") || !response.contains("result") || !response["result"].is_number_integer()) {
+        discarded_.fetch_add(1, std::memory_order_relaxed);
+        DERIBIT_LOG_WARN("Time sync probe {} failed", id);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id != pending_id_) {
+        // Answer to a probe already given up on
+        discarded_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pending_id_ = 0;
+
+    int64_t rtt = received_ns - pending_sent_ns_;
+    if (rtt < 0 || rtt > kMaxRttNs) {
+        discarded_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // The exchange stamps whole milliseconds; take the middle of the millisecond
+    int64_t exchange_ns = response["result"].get<int64_t>() * 1000000 + 500000;
+    int64_t offset = exchange_ns - (pending_sent_ns_ + rtt / 2);
+
+    window_[window_next_] = Sample{offset, rtt};
+    window_next_ = (window_next_ + 1) % kWindow;
+    window_size_ = std::min(window_size_ + 1, kWindow);
+    samples_.fetch_add(1, std::memory_order_relaxed);
+
+    const Sample* best = &window_[0];
+    for (size_t i = 1; i < window_size_; ++i) {
+        if (window_[i].rtt_ns < best->rtt_ns) {
+            best = &window_[i];
+        }
+    }
+    offset_ns_.store(best->offset_ns, std::memory_order_relaxed);
+    rtt_ns_.store(best->rtt_ns, std::memory_order_relaxed);
+    if (!synced_.exchange(true, std::memory_order_release)) {
+        DERIBIT_LOG_INFO("Exchange clock offset {}us (round trip {}us)", best->offset_ns / 1000, best->rtt_ns / 1000);
+    }
+}
+
+int64_t TimeSync::exchangeNowMs() const {
+    return (wallNowNs() + getOffsetNs()) / 1000000;
+}
+
+TimeSyncStats TimeSync::getStats() const {
+    TimeSyncStats stats;
+    stats.probes = probes_.load(std::memory_order_relaxed);
+    stats.samples = samples_.load(std::memory_order_relaxed);
+    stats.discarded = discarded_.load(std::memory_order_relaxed);
+    stats.synced = isSynced();
+    stats.offset_ns = getOffsetNs();
+    stats.rtt_ns = rtt_ns_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace deribit
@@ -0,0 +1,31 @@
+#include "deribit/top_of_book.hpp"
+
+namespace deribit {
+
+namespace {
+
+void readDouble(const nlohmann::json& json, const char* key, double& value) {
+    auto it = json.find(key);
+    if (it != json.end() && it->is_number()) {
+        value = it->get<double>();
+    }
+}
+
+} // namespace
+
+void TopOfBook::update(const nlohmann::json& json) {
+    auto it = json.find("timestamp");
+    if (it != json.end() && it->is_number()) {
+        timestamp = it->get<int64_t>();
+    }
+
+    readDouble(json, "best_bid_price", best_bid_price);
+    readDouble(json, "best_bid_amount", best_bid_amount);
+    readDouble(json, "best_ask_price", best_ask_price);
+    readDouble(json, "best_ask_amount", best_ask_amount);
+    readDouble(json, "last_price", last_price);
+    readDouble(json, "mark_price", mark_price);
+    readDouble(json, "index_price", index_price);
+}
+
+} // namespace deribit
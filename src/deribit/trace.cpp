@@ -0,0 +1,132 @@
+#include "deribit/trace.hpp"
+#include "deribit/logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+
+namespace {
+
+// Shortest interval the tick rate is measured over at export
+constexpr std::chrono::milliseconds kMinCalibration{20};
+
+} // namespace
+
+TraceBuffer::TraceBuffer(size_t capacity, uint32_t thread_id)
+    : thread_id_(thread_id) {
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    events_ = std::make_unique<TraceEvent[]>(rounded);
+    mask_ = rounded - 1;
+}
+
+std::vector<TraceEvent> TraceBuffer::snapshot() const {
+    uint64_t capacity = mask_ + 1;
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t start = head > capacity ? head - capacity : 0;
+
+    std::vector<TraceEvent> events;
+    events.reserve(static_cast<size_t>(head - start));
+    for (uint64_t i = start; i < head; ++i) {
+        events.push_back(events_[i & mask_]);
+    }
+
+    // Drop whatever the writer lapped while we were copying, including the
+    // slot it may be writing right now
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t head_after = head_.load(std::memory_order_relaxed);
+    uint64_t valid_from = head_after >= capacity ? head_after - capacity + 1 : 0;
+    if (valid_from > start) {
+        size_t skipped = static_cast<size_t>(std::min<uint64_t>(valid_from - start, events.size()));
+        events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(skipped));
+    }
+    return events;
+}
+
+void TraceBuffer::setName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(name_mutex_);
+    name_ = name;
+}
+
+std::string TraceBuffer::getName() const {
+    std::lock_guard<std::mutex> lock(name_mutex_);
+    return name_;
+}
+
+Tracer& Tracer::instance() {
+    // Never destroyed: threads may still record during static destruction
+    static Tracer* tracer = new Tracer();
+    return *tracer;
+}
+
+Tracer::Tracer()
+    : origin_ticks_(now())
+    , origin_time_(std::chrono::steady_clock::now()) {
+}
+
+TraceBuffer* Tracer::addBuffer() {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    buffers_.push_back(std::make_unique<TraceBuffer>(kBufferCapacity, static_cast<uint32_t>(buffers_.size() + 1)));
+    return buffers_.back().get();
+}
+
+std::string Tracer::toJson() const {
+    // Measure the tick rate against the steady clock over the tracer's lifetime
+    auto elapsed = std::chrono::steady_clock::now() - origin_time_;
+    if (elapsed < kMinCalibration) {
+        std::this_thread::sleep_for(kMinCalibration - elapsed);
+    }
+    uint64_t ticks = now() - origin_ticks_;
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin_time_).count();
+    double ticks_per_us = micros > 0.0 ? static_cast<double>(ticks) / micros : 1000.0;
+
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char buffer[256];
+
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for (const auto& thread : buffers_) {
+        std::string name = thread->getName();
+        if (!name.empty()) {
+            out += first ? "" : ",";
+            first = false;
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(thread->getThreadId())
+                + ",\"args\":{\"name\":" + nlohmann::json(name).dump() + "}}";
+        }
+
+        for (const auto& event : thread->snapshot()) {
+            // Spans opened before the tracer existed start at its origin
+            double start = static_cast<double>(static_cast<int64_t>(event.start - origin_ticks_)) / ticks_per_us;
+            double duration = static_cast<double>(event.end - event.start) / ticks_per_us;
+            std::snprintf(buffer, sizeof(buffer),
+                          "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                          first ? "" : ",", event.name, thread->getThreadId(), std::max(start, 0.0), duration);
+            out += buffer;
+            first = false;
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+bool Tracer::dump(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        DERIBIT_LOG_ERROR("Failed to open trace file {}", path);
+        return false;
+    }
+    file << toJson();
+    if (!file) {
+        DERIBIT_LOG_ERROR("Failed to write trace file {}", path);
+        return false;
+    }
+    DERIBIT_LOG_INFO("Wrote trace to {}", path);
+    return true;
+}
+
+} // namespace deribit
@@ -0,0 +1,71 @@
+#include "deribit/trade_ring.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace deribit {
+
+TradeRecord TradeRecord::fromJson(const nlohmann::json& json) {
+    TradeRecord record{};
+    record.price = toFixedPoint(json.value("price", 0.0));
+    record.amount = toFixedPoint(json.value("amount", 0.0));
+    record.timestamp = json.value("timestamp", int64_t(0));
+    record.side = json.value("direction", std::string()) == "sell" ? TradeSide::Sell : TradeSide::Buy;
+
+    // Trade ids are strings such as "123456" or "ETH-123456"; keep the number
+    if (json.contains("trade_id")) {
+        const auto& trade_id = json["trade_id"];
+        if (trade_id.is_number()) {
+            record.trade_id = trade_id.get<uint64_t>();
+        } else if (trade_id.is_string()) {
+            const std::string& id = trade_id.get_ref<const std::string&>();
+            size_t digits = id.find_last_not_of("0123456789");
+            digits = digits == std::string::npos ? 0 : digits + 1;
+            record.trade_id = digits < id.size() ? std::stoull(id.substr(digits)) : 0;
+        }
+    }
+
+    return record;
+}
+
+TradeRing::TradeRing(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    records_ = std::make_unique<TradeRecord[]>(size);
+    mask_ = size - 1;
+}
+
+void TradeRing::push(const TradeRecord& record) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    records_[head & mask_] = record;
+    head_.store(head + 1, std::memory_order_release);
+}
+
+size_t TradeRing::read(uint64_t& from, TradeRecord* out, size_t max_records) const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t oldest = head > capacity() ? head - capacity() : 0;
+    uint64_t start = std::max(from, oldest);
+    uint64_t count = std::min<uint64_t>(head > start ? head - start : 0, max_records);
+
+    for (uint64_t i = 0; i < count; ++i) {
+        std::memcpy(&out[i], &records_[(start + i) & mask_], sizeof(TradeRecord));
+    }
+
+    // Drop whatever the writer lapped while we were copying, including the
+    // slot it may be writing right now
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t head_after = head_.load(std::memory_order_relaxed);
+    uint64_t valid_from = head_after >= capacity() ? head_after - capacity() + 1 : 0;
+    if (valid_from > start) {
+        uint64_t skipped = std::min(valid_from - start, count);
+        std::memmove(out, out + skipped, (count - skipped) * sizeof(TradeRecord));
+        start += skipped;
+        count -= skipped;
+    }
+
+    from = start + count;
+    return static_cast<size_t>(count);
+}
+
+} // namespace deribit
@@ -1,5 +1,6 @@
 #include "deribit/websocket_client.hpp"
-#include <iostream>
+#include "deribit/logger.hpp"
+#include "deribit/trace.hpp"
 #include <sstream>
 #include <chrono>
 #include <thread>
@@ -36,9 +37,18 @@ bool WebSocketClient::initialize() {
         client_.set_fail_handler(
             std::bind(&WebSocketClient::onFail, this, std::placeholders::_1));
 
+        if (!config_.getFrameJournalPath().empty() && !journal_) {
+            journal_ = std::make_unique<FrameJournal>(
+                config_.getFrameJournalPath(), config_.getFrameJournalFileSize());
+            if (!journal_->start()) {
+                DERIBIT_LOG_WARN("Failed to start frame journal; continuing without it");
+                journal_.reset();
+            }
+        }
+
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "Error initializing WebSocket client: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error initializing WebSocket client: {}", e.what());
         return false;
     }
 }
@@ -49,14 +59,12 @@ bool WebSocketClient::connect() {
     }
 
     try {
-        std::string uri = config_.isTestnet()
-            ? "wss://test.deribit.com/ws/api/v2"
-            : "wss://www.deribit.com/ws/api/v2";
+        std::string uri = config_.getWebSocketApiUrl();
 
         websocketpp::lib::error_code ec;
         auto conn = client_.get_connection(uri, ec);
         if (ec) {
-            std::cerr << "Could not create connection: " << ec.message() << std::endl;
+            DERIBIT_LOG_ERROR("Could not create connection: {}", ec.message());
             return false;
         }
 
@@ -76,10 +84,10 @@ bool WebSocketClient::connect() {
             std::this_thread::sleep_for(std::chrono::milliseconds(500));
         }
 
-        std::cerr << "Connection timed out" << std::endl;
+        DERIBIT_LOG_ERROR("Connection timed out");
         return false;
     } catch (const std::exception& e) {
-        std::cerr << "Error connecting to WebSocket server: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error connecting to WebSocket server: {}", e.what());
         return false;
     }
 }
@@ -94,14 +102,14 @@ void WebSocketClient::disconnect() {
         websocketpp::lib::error_code ec;
         client_.close(connection_, websocketpp::close::status::normal, "", ec);
         if (ec) {
-            std::cerr << "Error closing connection: " << ec.message() << std::endl;
+            DERIBIT_LOG_ERROR("Error closing connection: {}", ec.message());
         }
 
         if (ws_thread_.joinable()) {
             ws_thread_.join();
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error disconnecting from WebSocket server: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error disconnecting from WebSocket server: {}", e.what());
     }
 }
 
@@ -122,14 +130,14 @@ bool WebSocketClient::authenticate(const std::string& access_token) {
             }}
         };
 
-        std::cout << "Sending WebSocket authentication request..." << std::endl;
+        DERIBIT_LOG_INFO("Sending WebSocket authentication request...");
         
         websocketpp::lib::error_code ec;
         client_.send(connection_, auth_request.dump(),
             websocketpp::frame::opcode::text, ec);
         
         if (ec) {
-            std::cerr << "Error sending authentication request: " << ec.message() << std::endl;
+            DERIBIT_LOG_ERROR("Error sending authentication request: {}", ec.message());
             return false;
         }
 
@@ -141,10 +149,10 @@ bool WebSocketClient::authenticate(const std::string& access_token) {
             std::this_thread::sleep_for(std::chrono::milliseconds(500));
         }
         
-        std::cerr << "WebSocket authentication timed out" << std::endl;
+        DERIBIT_LOG_ERROR("WebSocket authentication timed out");
         return false;
     } catch (const std::exception& e) {
-        std::cerr << "Error during authentication: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error during authentication: {}", e.what());
         return false;
     }
 }
@@ -154,16 +162,17 @@ bool WebSocketClient::send(const std::string& message) {
         return false;
     }
 
+    DERIBIT_TRACE_SCOPE("ws.send");
     try {
         websocketpp::lib::error_code ec;
         client_.send(connection_, message, websocketpp::frame::opcode::text, ec);
         if (ec) {
-            std::cerr << "Error sending message: " << ec.message() << std::endl;
+            DERIBIT_LOG_ERROR("Error sending message: {}", ec.message());
             return false;
         }
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "Error sending message: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error sending message: {}", e.what());
         return false;
     }
 }
@@ -175,10 +184,12 @@ bool WebSocketClient::subscribe(const std::string& channel,
     }
 
     try {
+        // user.* channels are private and need the authenticated variant
+        bool is_private = channel.compare(0, 5, "user.") == 0;
         nlohmann::json sub_request = {
             {"jsonrpc", "2.0"},
             {"id", 9930},
-            {"method", "public/subscribe"},
+            {"method", is_private ? "private/subscribe" : "public/subscribe"},
             {"params", {
                 {"channels", {channel}}
             }}
@@ -190,7 +201,7 @@ bool WebSocketClient::subscribe(const std::string& channel,
 
         return send(sub_request.dump());
     } catch (const std::exception& e) {
-        std::cerr << "Error subscribing to channel: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error subscribing to channel: {}", e.what());
         return false;
     }
 }
@@ -201,10 +212,11 @@ bool WebSocketClient::unsubscribe(const std::string& channel) {
     }
 
     try {
+        bool is_private = channel.compare(0, 5, "user.") == 0;
         nlohmann::json unsub_request = {
             {"jsonrpc", "2.0"},
             {"id", 9931},
-            {"method", "public/unsubscribe"},
+            {"method", is_private ? "private/unsubscribe" : "public/unsubscribe"},
             {"params", {
                 {"channels", {channel}}
             }}
@@ -212,7 +224,7 @@ bool WebSocketClient::unsubscribe(const std::string& channel) {
 
         return send(unsub_request.dump());
     } catch (const std::exception& e) {
-        std::cerr << "Error unsubscribing from channel: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error unsubscribing from channel: {}", e.what());
         return false;
     }
 }
@@ -224,37 +236,61 @@ void WebSocketClient::setMessageCallback(
 
 void WebSocketClient::onOpen(ConnectionHandle hdl) {
     is_connected_ = true;
-    std::cout << "WebSocket connection established" << std::endl;
+    connects_.fetch_add(1, std::memory_order_relaxed);
+    DERIBIT_LOG_INFO("WebSocket connection established");
 }
 
 void WebSocketClient::onClose(ConnectionHandle hdl) {
     is_connected_ = false;
     is_authenticated_ = false;
-    std::cout << "WebSocket connection closed" << std::endl;
+    disconnects_.fetch_add(1, std::memory_order_relaxed);
+    DERIBIT_LOG_INFO("WebSocket connection closed");
 }
 
 void WebSocketClient::onMessage(ConnectionHandle hdl, MessagePtr msg) {
+    // One stamp for the journal and dispatch, so recorded and measured receive times agree
+    auto receive_time = std::chrono::steady_clock::now();
+    const std::string& payload = msg->get_payload();
+    // Recorded here rather than in handleFrame so replayed frames are not captured again
+    if (journal_) {
+        int64_t receive_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            receive_time.time_since_epoch()).count();
+        journal_->append(static_cast<uint32_t>(connects_.load(std::memory_order_relaxed)),
+            receive_ns, payload.data(), payload.size());
+    }
+    handleFrame(payload, receive_time);
+}
+
+void WebSocketClient::handleFrame(const std::string& payload) {
+    handleFrame(payload, std::chrono::steady_clock::now());
+}
+
+void WebSocketClient::handleFrame(const std::string& payload, std::chrono::steady_clock::time_point receive_time) {
+    receive_time_ = receive_time;
+    receive_wall_time_ = std::chrono::system_clock::now();
+    DERIBIT_TRACE_SCOPE("ws.on_message");
     try {
-        const auto& payload = msg->get_payload();
-        
-        auto json = nlohmann::json::parse(payload);
+        nlohmann::json json;
+        {
+            DERIBIT_TRACE_SCOPE("ws.parse");
+            json = nlohmann::json::parse(payload);
+        }
 
         // Check for authentication response
         if (json.contains("id") && json["id"] == 9929) {
             if (json.contains("result") && !json.contains("error")) {
                 is_authenticated_ = true;
-                std::cout << "WebSocket authentication successful" << std::endl;
+                DERIBIT_LOG_INFO("WebSocket authentication successful");
             } else if (json.contains("error")) {
-                std::cerr << "WebSocket authentication failed: " 
-                    << json["error"]["message"].get<std::string>() << std::endl;
+                DERIBIT_LOG_ERROR("WebSocket authentication failed: {}", json["error"]["message"].get<std::string>());
                 if (json["error"].contains("data")) {
-                    std::cerr << "Error data: " << json["error"]["data"].dump() << std::endl;
+                    DERIBIT_LOG_ERROR("Error data: {}", json["error"]["data"].dump());
                 }
             }
         }
         // Only print subscription confirmation
         else if (json.contains("id") && json["id"] == 9930) {
-            std::cout << "Successfully subscribed to channel" << std::endl;
+            DERIBIT_LOG_INFO("Successfully subscribed to channel");
         }
         // Don't print orderbook updates to avoid flooding the console
         else if (json.contains("method") && json["method"] == "subscription") {
@@ -263,22 +299,27 @@ void WebSocketClient::onMessage(ConnectionHandle hdl, MessagePtr msg) {
                 message_callback_(payload);
             }
         }
+        // Responses to other requests go to the callback when one is set
+        else if (json.contains("id") && message_callback_) {
+            message_callback_(payload);
+        }
         // Print other messages for debugging
         else {
-            std::cout << "Received WebSocket message: " << payload << std::endl;
+            DERIBIT_LOG_DEBUG("Received WebSocket message: {}", payload);
             if (message_callback_) {
                 message_callback_(payload);
             }
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error processing message: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error processing message: {}", e.what());
     }
 }
 
 void WebSocketClient::onFail(ConnectionHandle hdl) {
     is_connected_ = false;
     is_authenticated_ = false;
-    std::cerr << "WebSocket connection failed" << std::endl;
+    disconnects_.fetch_add(1, std::memory_order_relaxed);
+    DERIBIT_LOG_ERROR("WebSocket connection failed");
 }
 
 std::shared_ptr<WebSocketClient::Context> WebSocketClient::onTlsInit(ConnectionHandle hdl) {
@@ -290,17 +331,18 @@ std::shared_ptr<WebSocketClient::Context> WebSocketClient::onTlsInit(ConnectionH
             Context::no_sslv3 |
             Context::single_dh_use);
     } catch (const std::exception& e) {
-        std::cerr << "Error in TLS initialization: " << e.what() << std::endl;
+        DERIBIT_LOG_ERROR("Error in TLS initialization: {}", e.what());
     }
     return ctx;
 }
 
 void WebSocketClient::run() {
+    DERIBIT_TRACE_THREAD_NAME("ws_io");
     while (is_running_) {
         try {
             client_.run_one();
         } catch (const std::exception& e) {
-            std::cerr << "Error in WebSocket run loop: " << e.what() << std::endl;
+            DERIBIT_LOG_ERROR("Error in WebSocket run loop: {}", e.what());
             break;
         }
     }